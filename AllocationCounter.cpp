@@ -0,0 +1,214 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // plain counters that are constant initialized, operator new can run before any dynamic initialization
+    std::atomic<uint64_t> allocationCount {0};
+    std::atomic<uint64_t> allocatedBytes {0};
+    std::atomic<uint64_t> freeCount {0};
+    std::array<std::atomic<uint64_t>, allocation_counter::categoryCount> categoryCounts = {};
+    std::array<std::atomic<uint64_t>, allocation_counter::categoryCount> categoryBytes = {};
+    thread_local ALLOCATION_CATEGORY threadCategory = ALLOCATION_CATEGORY::OTHER;
+
+#if CURVE_ALLOCATION_COUNTING
+    void countAllocation(size_t size)
+    {
+        const auto category = static_cast<size_t>(threadCategory);
+
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        categoryCounts[category].fetch_add(1, std::memory_order_relaxed);
+        categoryBytes[category].fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void * allocate(size_t size)
+    {
+        countAllocation(size);
+
+        void * ptr = std::malloc((size == 0) ? 1 : size);
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return ptr;
+    }
+
+    void * allocateAligned(size_t size, std::align_val_t alignment)
+    {
+        countAllocation(size);
+
+        const auto align = static_cast<size_t>(alignment);
+        const size_t aligned_size = (((size == 0) ? 1 : size) + align - 1) & ~(align - 1); // aligned_alloc wants a multiple of the alignment
+
+#ifdef _WIN32
+        void * ptr = _aligned_malloc(aligned_size, align);
+#else
+        void * ptr = std::aligned_alloc(align, aligned_size);
+#endif
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return ptr;
+    }
+
+    void deallocate(void * ptr)
+    {
+        if (ptr)
+        {
+            freeCount.fetch_add(1, std::memory_order_relaxed);
+            std::free(ptr);
+        }
+    }
+
+    void deallocateAligned(void * ptr)
+    {
+        if (ptr)
+        {
+            freeCount.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+            _aligned_free(ptr);
+#else
+            std::free(ptr);
+#endif
+        }
+    }
+#endif
+}
+
+namespace allocation_counter
+{
+    AllocationStats AllocationStats::operator-(const AllocationStats & since) const
+    {
+        AllocationStats difference;
+        difference.allocations = allocations - since.allocations;
+        difference.bytes = bytes - since.bytes;
+        difference.frees = frees - since.frees;
+
+        for (size_t i=0; i<categoryCount; i++)
+        {
+            difference.categoryAllocations[i] = categoryAllocations[i] - since.categoryAllocations[i];
+            difference.categoryBytes[i] = categoryBytes[i] - since.categoryBytes[i];
+        }
+
+        return difference;
+    }
+
+    AllocationStats Snapshot()
+    {
+        AllocationStats stats;
+        stats.allocations = allocationCount.load(std::memory_order_relaxed);
+        stats.bytes = allocatedBytes.load(std::memory_order_relaxed);
+        stats.frees = freeCount.load(std::memory_order_relaxed);
+
+        for (size_t i=0; i<categoryCount; i++)
+        {
+            stats.categoryAllocations[i] = categoryCounts[i].load(std::memory_order_relaxed);
+            stats.categoryBytes[i] = categoryBytes[i].load(std::memory_order_relaxed);
+        }
+
+        return stats;
+    }
+
+    ALLOCATION_CATEGORY SetCategory(ALLOCATION_CATEGORY category)
+    {
+        const ALLOCATION_CATEGORY previous = threadCategory;
+        threadCategory = category;
+        return previous;
+    }
+
+    const char * CategoryName(ALLOCATION_CATEGORY category)
+    {
+        switch (category)
+        {
+            case ALLOCATION_CATEGORY::OTHER:
+                return "other";
+
+            case ALLOCATION_CATEGORY::CURVE_EDIT:
+                return "curve_edit";
+
+            case ALLOCATION_CATEGORY::INTERPOLATION:
+                return "interpolation";
+
+            case ALLOCATION_CATEGORY::QUERY:
+                return "query";
+
+            case ALLOCATION_CATEGORY::DRAW:
+                return "draw";
+
+            case ALLOCATION_CATEGORY::EFFECT:
+                return "effect";
+        }
+
+        return "unknown";
+    }
+}
+
+#if CURVE_ALLOCATION_COUNTING
+// the replaced global allocation functions. the array, nothrow and sized forms of the standard library forward to these
+void * operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void * operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void * ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+    deallocateAligned(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+    deallocateAligned(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocateAligned(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocateAligned(ptr);
+}
+#endif
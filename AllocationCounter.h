@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// counts the heap allocations of the program. when CURVE_ALLOCATION_COUNTING is 1 (set by the BASIC_CURVES_COUNT_ALLOCATIONS
+// cmake option) the global operator new/delete are replaced by ones that count every allocation and its size, both in
+// total and under the category of the innermost CURVE_ALLOCATION_SCOPE of the allocating thread. the FrameProfiler
+// takes the difference of two snapshots as the allocations of a frame. when it is 0 (the default) nothing is replaced,
+// the snapshots stay empty and the scopes compile to nothing
+#ifndef CURVE_ALLOCATION_COUNTING
+#define CURVE_ALLOCATION_COUNTING 0
+#endif
+
+enum class ALLOCATION_CATEGORY : uint8_t {OTHER, CURVE_EDIT, INTERPOLATION, QUERY, DRAW, EFFECT};
+
+namespace allocation_counter
+{
+    constexpr size_t categoryCount = 6;
+
+    struct AllocationStats
+    {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t frees = 0;
+        std::array<uint64_t, categoryCount> categoryAllocations = {}; // ALLOCATION_CATEGORY order
+        std::array<uint64_t, categoryCount> categoryBytes = {};
+
+        AllocationStats operator-(const AllocationStats & since) const; // allocations between two snapshots
+    };
+
+    constexpr bool IsCompiledIn() { return CURVE_ALLOCATION_COUNTING != 0; }
+
+    AllocationStats Snapshot(); // allocations of every thread since the start of the program
+    ALLOCATION_CATEGORY SetCategory(ALLOCATION_CATEGORY category); // category of the allocations of the calling thread, returns the previous one
+    const char * CategoryName(ALLOCATION_CATEGORY category);
+
+    class Scope
+    {
+        private:
+            ALLOCATION_CATEGORY previous;
+
+        public:
+            explicit Scope(ALLOCATION_CATEGORY category)
+                : previous(SetCategory(category))
+            {
+            }
+
+            ~Scope()
+            {
+                SetCategory(previous);
+            }
+
+            Scope(const Scope &) = delete;
+            Scope & operator=(const Scope &) = delete;
+    };
+}
+
+#define CURVE_ALLOCATION_CONCAT_INNER(a, b) a##b
+#define CURVE_ALLOCATION_CONCAT(a, b) CURVE_ALLOCATION_CONCAT_INNER(a, b)
+
+#if CURVE_ALLOCATION_COUNTING
+#define CURVE_ALLOCATION_SCOPE(category) allocation_counter::Scope CURVE_ALLOCATION_CONCAT(curve_allocation_scope_, __LINE__)(ALLOCATION_CATEGORY::category)
+#else
+#define CURVE_ALLOCATION_SCOPE(category)
+#endif
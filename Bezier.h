@@ -0,0 +1,464 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <limits>
+
+// Q16.16 fixed point number: 16 integer bits (curve coordinates up to +-32767) and 16 fraction bits. the arithmetic is
+// integer only, so a segment evaluated in fixed point gives the same result with every compiler, cpu and float mode.
+// values and results outside of the range saturate at its ends instead of wrapping around, so segments far from the
+// origin have to be evaluated relative to one of their points
+class FixedPoint
+{
+    private:
+        int32_t raw = 0;
+
+        static constexpr int32_t saturate(int64_t raw_value)
+        {
+            return static_cast<int32_t>(std::clamp<int64_t>(raw_value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+        }
+
+        static constexpr int32_t fromDouble(double value)
+        {
+            // rounded to the nearest step, nan is 0
+            const double raw_value = (value * one) + ((value < 0.0) ? -0.5 : 0.5);
+            return (raw_value == raw_value) ? static_cast<int32_t>(std::clamp<double>(raw_value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())) : 0;
+        }
+
+    public:
+        static constexpr int32_t fractionBits = 16;
+        static constexpr int32_t one = 1 << fractionBits;
+
+        constexpr FixedPoint() = default;
+        explicit constexpr FixedPoint(double value) : raw (fromDouble(value)) {}
+
+        static constexpr FixedPoint FromRaw(int32_t raw_value)
+        {
+            FixedPoint value;
+            value.raw = raw_value;
+            return value;
+        }
+
+        constexpr int32_t Raw() const { return raw; }
+        explicit constexpr operator float() const { return static_cast<float>(raw) / static_cast<float>(one); }
+        explicit constexpr operator double() const { return static_cast<double>(raw) / static_cast<double>(one); }
+
+        friend constexpr FixedPoint operator+(FixedPoint a, FixedPoint b) { return FromRaw(saturate(static_cast<int64_t>(a.raw) + b.raw)); }
+        friend constexpr FixedPoint operator-(FixedPoint a, FixedPoint b) { return FromRaw(saturate(static_cast<int64_t>(a.raw) - b.raw)); }
+        friend constexpr FixedPoint operator-(FixedPoint a) { return FromRaw(saturate(-static_cast<int64_t>(a.raw))); }
+
+        friend constexpr FixedPoint operator*(FixedPoint a, FixedPoint b)
+        {
+            // 64 bit product, rounded back to 16 fraction bits
+            return FromRaw(saturate(((static_cast<int64_t>(a.raw) * b.raw) + (one / 2)) >> fractionBits));
+        }
+
+        friend constexpr FixedPoint operator/(FixedPoint a, FixedPoint b)
+        {
+            return FromRaw(saturate((static_cast<int64_t>(a.raw) * one) / b.raw));
+        }
+
+        friend constexpr bool operator==(FixedPoint a, FixedPoint b) = default;
+        friend constexpr auto operator<=>(FixedPoint a, FixedPoint b) = default;
+};
+
+// what Bezier needs from its scalar type besides + - * and conversions
+template<typename Scalar>
+struct ScalarTraits
+{
+    static Scalar Lerp(Scalar a, Scalar b, Scalar t) { return std::lerp(a, b, t); }
+};
+
+template<>
+struct ScalarTraits<FixedPoint>
+{
+    static constexpr FixedPoint Lerp(FixedPoint a, FixedPoint b, FixedPoint t) { return a + ((b - a) * t); }
+};
+
+namespace bezier
+{
+    template<typename Scalar>
+    using Point = std::array<Scalar, 2>;
+
+    template<typename Scalar>
+    constexpr Point<Scalar> Lerp(const Point<Scalar> & a, const Point<Scalar> & b, Scalar t)
+    {
+        return {ScalarTraits<Scalar>::Lerp(a[0], b[0], t), ScalarTraits<Scalar>::Lerp(a[1], b[1], t)};
+    }
+
+    constexpr double Binomial(size_t n, size_t k)
+    {
+        double value = 1.0;
+        for (size_t i=1; i<=k; i++)
+        {
+            value = (value * static_cast<double>(n - k + i)) / static_cast<double>(i);
+        }
+        return value;
+    }
+
+    // one de casteljau step: the N - 1 points between neighbouring points at t, expanded at compile time
+    template<size_t N, typename Scalar>
+    constexpr std::array<Point<Scalar>, N - 1> Reduce(const std::array<Point<Scalar>, N> & points, Scalar t)
+    {
+        return [&]<size_t... I>(std::index_sequence<I...>)
+        {
+            return std::array<Point<Scalar>, N - 1>{Lerp(points[I], points[I + 1], t)...};
+        }(std::make_index_sequence<N - 1>{});
+    }
+
+    template<size_t N, typename Scalar>
+    constexpr Point<Scalar> DeCasteljau(const std::array<Point<Scalar>, N> & points, Scalar t)
+    {
+        if constexpr (N == 1)
+        {
+            return points[0];
+        }
+        else
+        {
+            return DeCasteljau<N - 1, Scalar>(Reduce<N, Scalar>(points, t), t);
+        }
+    }
+
+    // power basis polynomial (coefficients[k] is the t^k term) with horner's method
+    template<size_t N, typename Scalar>
+    constexpr Point<Scalar> Horner(const std::array<Point<Scalar>, N> & coefficients, Scalar t)
+    {
+        Point<Scalar> p = coefficients[N - 1];
+
+        for (size_t k=N-1; k>0; k--)
+        {
+            p[0] = (p[0] * t) + coefficients[k - 1][0];
+            p[1] = (p[1] * t) + coefficients[k - 1][1];
+        }
+
+        return p;
+    }
+}
+
+// bezier segment of a fixed degree. every function is expanded for its degree at compile time, so a segment of the
+// curve classes (Bezier<1>, Bezier<2> or Bezier<3> of floats) is evaluated without loops over the control points or
+// branches on the curve type. Scalar is float, double or FixedPoint
+template<size_t Degree, typename Scalar = float>
+struct Bezier
+{
+    using Point = bezier::Point<Scalar>;
+
+    static constexpr size_t degree = Degree;
+    static constexpr size_t order = Degree + 1; // number of control points
+
+    std::array<Point, order> points = {};
+
+    constexpr const Point & Start() const { return points[0]; }
+    constexpr const Point & End() const { return points[Degree]; }
+
+    // point at t with de casteljau's algorithm (repeated lerps, stable for any t)
+    constexpr Point Evaluate(Scalar t) const
+    {
+        return bezier::DeCasteljau<order, Scalar>(points, t);
+    }
+
+    // coefficients of one axis (0 is x, 1 is y) of the segment in power basis, p(t) = sum(coefficients[k] * t^k).
+    // degrees 1 to 3 use the same expressions (in the same order) as the curve kernels always have, so their samples
+    // are unchanged
+    constexpr std::array<Scalar, order> AxisPowerBasis(size_t axis) const
+    {
+        std::array<Scalar, order> coefficients = {};
+
+        const Scalar a = points[0][axis];
+        coefficients[0] = a;
+
+        if constexpr (Degree == 1)
+        {
+            coefficients[1] = points[1][axis] - a;
+        }
+        else if constexpr (Degree == 2)
+        {
+            const Scalar b = points[1][axis];
+            const Scalar c = points[2][axis];
+
+            coefficients[1] = Scalar(2.0) * (b - a);
+            coefficients[2] = a - (Scalar(2.0) * b) + c;
+        }
+        else if constexpr (Degree == 3)
+        {
+            const Scalar b = points[1][axis];
+            const Scalar c = points[2][axis];
+            const Scalar d = points[3][axis];
+
+            coefficients[1] = Scalar(3.0) * (b - a);
+            coefficients[2] = Scalar(3.0) * (a - (Scalar(2.0) * b) + c);
+            coefficients[3] = d - a + (Scalar(3.0) * (b - c));
+        }
+        else
+        {
+            // coefficients[k] = (n choose k) * sum(j <= k) (-1)^(k - j) * (k choose j) * points[j]
+            for (size_t k=1; k<=Degree; k++)
+            {
+                Scalar sum = Scalar(0.0);
+                for (size_t j=0; j<=k; j++)
+                {
+                    const Scalar term = Scalar(bezier::Binomial(k, j)) * points[j][axis];
+                    sum = (((k - j) % 2) == 0) ? (sum + term) : (sum - term);
+                }
+                coefficients[k] = Scalar(bezier::Binomial(Degree, k)) * sum;
+            }
+        }
+
+        return coefficients;
+    }
+
+    // the coefficients of both axes as points
+    constexpr std::array<Point, order> PowerBasis() const
+    {
+        const std::array<Scalar, order> x = AxisPowerBasis(0);
+        const std::array<Scalar, order> y = AxisPowerBasis(1);
+        std::array<Point, order> coefficients = {};
+
+        for (size_t k=0; k<order; k++)
+        {
+            coefficients[k] = {x[k], y[k]};
+        }
+
+        return coefficients;
+    }
+
+    // point at t with horner's method on the power basis. faster than Evaluate when PowerBasis is reused for many t,
+    // less accurate far from the control points
+    constexpr Point EvaluatePower(Scalar t) const
+    {
+        return bezier::Horner<order, Scalar>(PowerBasis(), t);
+    }
+
+    // hodograph: the derivative of the segment is a bezier of one degree lower
+    constexpr Bezier<(Degree > 0) ? (Degree - 1) : 0, Scalar> Derivative() const requires (Degree > 0)
+    {
+        Bezier<Degree - 1, Scalar> derivative;
+
+        for (size_t i=0; i<Degree; i++)
+        {
+            derivative.points[i] = {Scalar(static_cast<double>(Degree)) * (points[i + 1][0] - points[i][0]), Scalar(static_cast<double>(Degree)) * (points[i + 1][1] - points[i][1])};
+        }
+
+        return derivative;
+    }
+
+    // the same curve with one more control point (exact up to rounding)
+    constexpr Bezier<Degree + 1, Scalar> Elevate() const
+    {
+        Bezier<Degree + 1, Scalar> elevated;
+        elevated.points[0] = points[0];
+        elevated.points[Degree + 1] = points[Degree];
+
+        for (size_t i=1; i<=Degree; i++)
+        {
+            const Scalar w = Scalar(static_cast<double>(i) / static_cast<double>(Degree + 1));
+            elevated.points[i] = bezier::Lerp(points[i], points[i - 1], w);
+        }
+
+        return elevated;
+    }
+
+    // the parts of the segment before and after t
+    constexpr std::array<Bezier, 2> Split(Scalar t) const
+    {
+        std::array<Bezier, 2> parts;
+        std::array<Point, order> level = points;
+
+        for (size_t n=order; n>0; n--)
+        {
+            parts[0].points[order - n] = level[0];
+            parts[1].points[n - 1] = level[n - 1];
+
+            for (size_t i=0; (i + 1)<n; i++)
+            {
+                level[i] = bezier::Lerp(level[i], level[i + 1], t);
+            }
+        }
+
+        return parts;
+    }
+
+    template<typename To>
+    constexpr Bezier<Degree, To> Cast() const
+    {
+        Bezier<Degree, To> segment;
+
+        for (size_t i=0; i<order; i++)
+        {
+            segment.points[i] = {static_cast<To>(points[i][0]), static_cast<To>(points[i][1])};
+        }
+
+        return segment;
+    }
+};
+
+namespace bezier
+{
+    // n_steps + 1 points of segment at t = i / n_steps written to out, with horner's method on the power basis like
+    // curve_kernel::Evaluate but in any scalar type (and without simd). the last point is the end point of the segment
+    template<size_t Degree, typename Scalar>
+    constexpr void Sample(const Bezier<Degree, Scalar> & segment, uint32_t n_steps, Point<Scalar> * out)
+    {
+        const std::array<Point<Scalar>, Degree + 1> coefficients = segment.PowerBasis();
+        const Scalar step_size = Scalar(1.0) / Scalar(static_cast<double>(n_steps));
+        const Scalar t_end = Scalar(1.0);
+
+        for (uint32_t i=0; i<n_steps; i++)
+        {
+            Scalar t = Scalar(static_cast<double>(i)) * step_size;
+            t = (t < t_end) ? t : t_end;
+            out[i] = Horner<Degree + 1, Scalar>(coefficients, t);
+        }
+
+        out[n_steps] = segment.End();
+    }
+}
+
+// segments whose degree is only known at runtime (BezierCurve), points.size() - 1 up to maxDegree. the control points
+// are copied to a fixed size array on the stack and worked on there, nothing is allocated
+namespace bezier
+{
+    constexpr size_t maxDegree = 10;
+
+    template<std::floating_point Scalar>
+    using RuntimePoints = std::array<Point<Scalar>, maxDegree + 1>;
+
+    // point at t with de casteljau's algorithm
+    template<std::floating_point Scalar>
+    constexpr Point<Scalar> DeCasteljau(std::span<const Point<Scalar>> points, Scalar t)
+    {
+        RuntimePoints<Scalar> level = {};
+        std::copy(points.begin(), points.end(), level.begin());
+
+        for (size_t n=points.size(); n>1; n--)
+        {
+            for (size_t i=0; (i + 1)<n; i++)
+            {
+                level[i] = Lerp(level[i], level[i + 1], t);
+            }
+        }
+
+        return level[0];
+    }
+
+    // the parts of the segment before and after t (both with as many points as the segment)
+    template<std::floating_point Scalar>
+    constexpr void Split(std::span<const Point<Scalar>> points, Scalar t, std::span<Point<Scalar>> left, std::span<Point<Scalar>> right)
+    {
+        RuntimePoints<Scalar> level = {};
+        std::copy(points.begin(), points.end(), level.begin());
+
+        const size_t order = points.size();
+        for (size_t n=order; n>0; n--)
+        {
+            left[order - n] = level[0];
+            right[n - 1] = level[n - 1];
+
+            for (size_t i=0; (i + 1)<n; i++)
+            {
+                level[i] = Lerp(level[i], level[i + 1], t);
+            }
+        }
+    }
+
+    // the same curve with out.size() control points (at least as many as points), one degree at a time like
+    // Bezier::Elevate. exact up to rounding
+    template<std::floating_point Scalar>
+    constexpr void Elevate(std::span<const Point<Scalar>> points, std::span<Point<Scalar>> out)
+    {
+        RuntimePoints<Scalar> level = {};
+        std::copy(points.begin(), points.end(), level.begin());
+
+        for (size_t degree=points.size()-1; (degree + 1)<out.size(); degree++)
+        {
+            // from the end so level[i - 1] is still the lower degree point
+            level[degree + 1] = level[degree];
+            for (size_t i=degree; i>0; i--)
+            {
+                const Scalar w = static_cast<Scalar>(static_cast<double>(i) / static_cast<double>(degree + 1));
+                level[i] = Lerp(level[i], level[i - 1], w);
+            }
+        }
+
+        std::copy(level.begin(), level.begin() + out.size(), out.begin());
+    }
+
+    // bound on the distance between two segments with the same number of control points: their difference is the
+    // bezier of the differences of the control points, which stays within the longest of them
+    template<std::floating_point Scalar>
+    Scalar Distance(std::span<const Point<Scalar>> a, std::span<const Point<Scalar>> b)
+    {
+        Scalar distance_sqr = 0;
+        for (size_t i=0; i<a.size(); i++)
+        {
+            const Scalar dx = a[i][0] - b[i][0];
+            const Scalar dy = a[i][1] - b[i][1];
+            distance_sqr = std::max(distance_sqr, (dx * dx) + (dy * dy));
+        }
+
+        return std::sqrt(distance_sqr);
+    }
+
+    // a segment with out.size() control points (at most as many as points) close to the segment, keeping its end
+    // points. every step down inverts the elevation from the start for the first half of the control points and from
+    // the end for the second half (exact if the segment was elevated). returns the distance bound between the segment
+    // and the result raised back to its degree, so 0 (up to rounding) if no information was lost
+    template<std::floating_point Scalar>
+    Scalar Reduce(std::span<const Point<Scalar>> points, std::span<Point<Scalar>> out)
+    {
+        std::array<std::array<double, 2>, maxDegree + 1> level = {};
+        for (size_t i=0; i<points.size(); i++)
+        {
+            level[i] = {static_cast<double>(points[i][0]), static_cast<double>(points[i][1])};
+        }
+
+        for (size_t n=points.size()-1; (n + 1)>out.size(); n--)
+        {
+            // p is the segment of degree n, forward and backward are candidates of degree n - 1
+            std::array<std::array<double, 2>, maxDegree + 1> forward = {};
+            std::array<std::array<double, 2>, maxDegree + 1> backward = {};
+            const double degree = static_cast<double>(n);
+
+            forward[0] = level[0];
+            for (size_t i=1; i<n; i++)
+            {
+                for (size_t axis=0; axis<2; axis++)
+                {
+                    forward[i][axis] = ((degree * level[i][axis]) - (static_cast<double>(i) * forward[i - 1][axis])) / (degree - static_cast<double>(i));
+                }
+            }
+
+            backward[n - 1] = level[n];
+            for (size_t i=n-1; i>0; i--)
+            {
+                for (size_t axis=0; axis<2; axis++)
+                {
+                    backward[i - 1][axis] = ((degree * level[i][axis]) - ((degree - static_cast<double>(i)) * backward[i][axis])) / static_cast<double>(i);
+                }
+            }
+
+            const size_t m = n - 1;
+            for (size_t i=0; i<=m; i++)
+            {
+                const double w = ((2 * i) < m) ? 0.0 : (((2 * i) > m) ? 1.0 : 0.5);
+                level[i] = {((1.0 - w) * forward[i][0]) + (w * backward[i][0]), ((1.0 - w) * forward[i][1]) + (w * backward[i][1])};
+            }
+        }
+
+        for (size_t i=0; i<out.size(); i++)
+        {
+            out[i] = {static_cast<Scalar>(level[i][0]), static_cast<Scalar>(level[i][1])};
+        }
+
+        RuntimePoints<Scalar> elevated = {};
+        Elevate<Scalar>(std::span<const Point<Scalar>>(out.data(), out.size()), std::span(elevated.data(), points.size()));
+        return Distance<Scalar>(points, std::span<const Point<Scalar>>(elevated.data(), points.size()));
+    }
+}
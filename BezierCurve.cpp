@@ -0,0 +1,1033 @@
+#include "BezierCurve.h"
+#include "CurveKernel.h"
+#include "CurveLayout.h"
+#include "CurveSegments.h"
+#include "CurveArcLength.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include <iostream>
+
+namespace
+{
+    // control point k of a straight segment of degree from a to b (the line raised to degree)
+    std::array<float, 2> straightControl(const std::array<float, 2> & a, const std::array<float, 2> & b, size_t k, size_t degree)
+    {
+        const float w = static_cast<float>(k) / static_cast<float>(degree);
+        return {a[0] + (w * (b[0] - a[0])), a[1] + (w * (b[1] - a[1]))};
+    }
+
+    size_t clampDegree(size_t degree)
+    {
+        return std::clamp<size_t>(degree, 1, bezier::maxDegree);
+    }
+}
+
+bool BezierCurve::isAnchorPoint(int32_t index) const
+{
+    return std::binary_search(segmentStarts.begin(), segmentStarts.end(), static_cast<uint32_t>(index));
+}
+
+size_t BezierCurve::segmentOfPoint(int32_t index) const
+{
+    const size_t n_segments = segmentCount();
+    const size_t segment = static_cast<size_t>(std::upper_bound(segmentStarts.begin(), segmentStarts.end(), static_cast<uint32_t>(std::max(index, 0))) - segmentStarts.begin());
+    return std::min((segment > 0) ? (segment - 1) : 0, (n_segments > 0) ? (n_segments - 1) : 0);
+}
+
+std::span<const std::array<float, 2>> BezierCurve::segmentPoints(size_t segment, bezier::RuntimePoints<float> & out) const
+{
+    const PointList & points = curveData->pointList;
+
+    if (segment < segmentCount())
+    {
+        const size_t first = segmentStarts[segment];
+        const size_t n_points = (segmentStarts[segment + 1] - first) + 1;
+        for (size_t i=0; i<n_points; i++)
+        {
+            out[i] = points[first + i];
+        }
+
+        return std::span<const std::array<float, 2>>(out.data(), n_points);
+    }
+
+    // the closing segment is a line from the last point to the first
+    out[0] = points[points.size() - 1];
+    out[1] = points[0];
+    return std::span<const std::array<float, 2>>(out.data(), 2);
+}
+
+void BezierCurve::tessellateSegment(std::span<const std::array<float, 2>> points, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out, std::vector<float> & errors_out)
+{
+    const size_t degree = points.size() - 1;
+
+    (*tessellateKernels)[degree](points, n_steps, curveData->flatnessTolerance, out);
+    bounds_out.push_back(curve_kernel::BoundsBezier(points));
+
+    // the segment blocks work on cubics: lower degrees are raised exactly, higher degrees are reduced and the distance
+    // bound of the reduction is kept with them (the arc length is measured on the segment itself, see measureSegment)
+    SegmentControls controls;
+    if (degree <= 3)
+    {
+        bezier::Elevate<float>(points, controls);
+        errors_out.push_back(0.0f);
+    }
+    else
+    {
+        errors_out.push_back(bezier::Reduce<float>(points, controls));
+    }
+    controls_out.push_back(controls);
+}
+
+void BezierCurve::appendHandles(size_t segment, std::vector<std::array<float, 2>> & out) const
+{
+    const PointList & points = curveData->pointList;
+    const size_t first = segmentStarts[segment];
+    const size_t last = segmentStarts[segment + 1];
+
+    // lines are their own control polygon
+    if ((last - first) > 1)
+    {
+        for (size_t i=first; i<last; i++)
+        {
+            out.push_back(points[i]);
+            out.push_back(points[i + 1]);
+        }
+    }
+}
+
+size_t BezierCurve::segmentCount() const
+{
+    return segmentStarts.empty() ? 0 : (segmentStarts.size() - 1);
+}
+
+bool BezierCurve::hasClosingSegment() const
+{
+    return curveData->isCloseLoop && (segmentCount() > 0) && (curveData->pointList.size() > 2);
+}
+
+void BezierCurve::tessellatePointSegment(size_t segment, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out, std::vector<float> & errors_out)
+{
+    bezier::RuntimePoints<float> points;
+    tessellateSegment(segmentPoints(segment, points), n_steps, out, bounds_out, controls_out, errors_out);
+}
+
+void BezierCurve::retessellateSegments(size_t first_segment, size_t old_count, size_t new_count)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::retessellateSegments");
+    CURVE_ALLOCATION_SCOPE(INTERPOLATION);
+
+    // generated segments map 1:1 to the segments of the point list. anything else (curves too short for a segment,
+    // settings changed since the last interpolation) falls back to a full interpolation
+    const size_t n_segments = segmentCount();
+    const size_t n_segments_prev = segmentOffsets.empty() ? 0 : (segmentOffsets.size() - 1);
+    const uint32_t n_steps = curve_kernel::StepCount(curveData->smoothFactor);
+
+    if (!isSegmentDataValid || (n_segments == 0)
+        || ((first_segment + old_count) > n_segments_prev) || ((n_segments_prev - old_count + new_count) != n_segments)
+        || (handleOffsets.size() != (n_segments_prev + 1)) || (segmentErrors.size() < n_segments_prev)
+        || (segmentBounds.size() < n_segments_prev) || (segmentControls.size() < n_segments_prev) || (n_steps != segmentStepCount) || (curveData->tessellationMode != segmentTessellationMode))
+    {
+        InterpolatePoints();
+        return;
+    }
+
+    // the closing segment is always generated last, drop it and regenerate it after the splice since it wraps around
+    // to the first point
+    const size_t n_closing_samples_prev = curveList.size() - segmentOffsets.back();
+    const size_t closing_first_prev = segmentOffsets.back();
+    curveList.resize(segmentOffsets.back());
+    segmentBounds.resize(n_segments_prev);
+    segmentControls.resize(n_segments_prev);
+    segmentErrors.resize(n_segments_prev);
+
+    segmentScratch.clear();
+    segmentScratchOffsets.clear();
+    boundsScratch.clear();
+    controlsScratch.clear();
+    errorsScratch.clear();
+    handleScratch.clear();
+    handleScratchOffsets.clear();
+
+    for (size_t i=first_segment; i<(first_segment + new_count); i++)
+    {
+        segmentScratchOffsets.push_back(segmentScratch.size());
+        tessellatePointSegment(i, n_steps, segmentScratch, boundsScratch, controlsScratch, errorsScratch);
+
+        handleScratchOffsets.push_back(handleScratch.size());
+        if (curveData->areHandlesGenerated)
+        {
+            appendHandles(i, handleScratch);
+        }
+    }
+
+    const size_t first_sample = segmentOffsets[first_segment];
+    const size_t n_samples_prev = segmentOffsets[first_segment + old_count] - first_sample;
+    const size_t first_handle = handleOffsets[first_segment];
+    const size_t n_handles_prev = handleOffsets[first_segment + old_count] - first_handle;
+
+    curve_segments::Splice(curveList, segmentOffsets, first_segment, old_count, segmentScratch, segmentScratchOffsets);
+    curve_segments::Splice(handleList, handleOffsets, first_segment, old_count, handleScratch, handleScratchOffsets);
+    curve_segments::SpliceFixed(segmentBounds, 1, first_segment, old_count, boundsScratch);
+    curve_segments::SpliceFixed(segmentControls, 1, first_segment, old_count, controlsScratch);
+    curve_segments::SpliceFixed(segmentErrors, 1, first_segment, old_count, errorsScratch);
+
+    size_t n_generated = n_segments;
+    if (hasClosingSegment())
+    {
+        tessellatePointSegment(n_segments, n_steps, curveList, segmentBounds, segmentControls, segmentErrors);
+        n_generated++;
+    }
+
+    // the closing segment is logged as a separate edit at the end
+    const uint64_t generation = curveData->generation;
+    editLog.Record(generation, first_sample, n_samples_prev, segmentScratch.size(), false);
+    editLog.Record(generation, first_handle, n_handles_prev, handleScratch.size(), true);
+    editLog.Record(generation, segmentOffsets.back(), n_closing_samples_prev, (curveList.size() - segmentOffsets.back()), false);
+
+    // a drag keeps the number of segments, so only the nodes above the edited segments (and the closing segment,
+    // which is always regenerated) need to be refit
+    isCurveBoundsValid = false;
+    isBatchValid = false;
+    segmentTree.Refit(segmentBounds, first_segment, new_count);
+    arcLengthTable.Splice(first_segment, old_count, new_count);
+    if (hasClosingSegment())
+    {
+        segmentTree.Refit(segmentBounds, n_segments, 1);
+        arcLengthTable.Invalidate(n_segments, 1);
+    }
+
+    tessellationStats.uniformVertexCount = n_generated * (n_steps + 1);
+    tessellationStats.vertexCount = curveList.size();
+
+    // repeat the splice on the structure of arrays copies, or leave them to be converted when they are read
+    if (areStorageArraysValid && (curveData->sampleLayout == SAMPLE_LAYOUT::SOA))
+    {
+        const size_t first_moved = (old_count == new_count) ? n_segments : first_segment; // segments after the edit only move if their number changed
+
+        sampleArrays.Resize(closing_first_prev);
+        sampleArrays.Splice(first_sample, n_samples_prev, segmentScratch);
+        sampleArrays.Splice(segmentOffsets.back(), 0, std::span(curveList).subspan(segmentOffsets.back()));
+        segmentBlocks.Update(segmentControls, first_segment, new_count);
+        segmentBlocks.Update(segmentControls, first_moved, (segmentControls.size() - first_moved));
+    }
+    else
+    {
+        areStorageArraysValid = false;
+    }
+}
+
+void BezierCurve::markPointsDirty(int32_t first_point, int32_t last_point)
+{
+    // segment i is made of the points segmentStarts[i] to segmentStarts[i+1], so an anchor belongs to the segments on
+    // both sides of it
+    const size_t n_segments = segmentCount();
+    if (n_segments == 0)
+    {
+        markSegmentsDirty(0, 0, 0);
+        return;
+    }
+
+    const uint32_t first = static_cast<uint32_t>(std::max(first_point, 0));
+    const uint32_t last = static_cast<uint32_t>(std::max(last_point, 0));
+    const size_t first_segment = static_cast<size_t>(std::lower_bound(segmentStarts.begin() + 1, segmentStarts.end(), first) - (segmentStarts.begin() + 1));
+    const size_t last_segment = std::min(static_cast<size_t>(std::upper_bound(segmentStarts.begin(), segmentStarts.end() - 1, last) - segmentStarts.begin()), n_segments);
+    const size_t n_dirty = (last_segment > first_segment) ? (last_segment - first_segment) : 0;
+
+    markSegmentsDirty(std::min(first_segment, n_segments), n_dirty, n_dirty);
+}
+
+void BezierCurve::updateLayout()
+{
+    PointList & points = curveData->pointList;
+    std::vector<uint8_t> & degrees = bezierData->segmentDegrees;
+
+    segmentStarts.clear();
+
+    // a point list without degrees (e.g. filled point by point) is read as lines
+    if (degrees.empty() && (points.size() > 1))
+    {
+        degrees.assign(points.size() - 1, 1);
+    }
+
+    size_t n_points = 1;
+    isLayoutValid = true;
+    for (uint8_t degree : degrees)
+    {
+        isLayoutValid = isLayoutValid && (degree >= 1) && (degree <= bezier::maxDegree);
+        n_points += degree;
+    }
+
+    isLayoutValid = isLayoutValid && (degrees.empty() ? (points.size() <= 1) : (n_points == points.size()));
+
+    if (!isLayoutValid)
+    {
+        std::cerr << "segment degrees don't match the point list!\n";
+        return;
+    }
+
+    if (!degrees.empty())
+    {
+        uint32_t start = 0;
+        for (uint8_t degree : degrees)
+        {
+            segmentStarts.push_back(start);
+            start += degree;
+        }
+        segmentStarts.push_back(start);
+    }
+}
+
+void BezierCurve::syncLayout()
+{
+    if (isInterpolationPending || (trackedGeneration != curveData->generation))
+    {
+        updateLayout();
+    }
+}
+
+void BezierCurve::updateBatch()
+{
+    if (!isBatchValid)
+    {
+        CURVE_TRACE_SCOPE("BezierCurve::updateBatch");
+        CURVE_ALLOCATION_SCOPE(QUERY);
+
+        // every segment is raised exactly to the highest degree, so the whole curve is sampled with one kernel
+        const size_t n_segments = segmentCount();
+        const size_t n_generated = segmentControls.size();
+        size_t degree = 1;
+        for (size_t i=0; i<std::min(n_segments, n_generated); i++)
+        {
+            degree = std::max<size_t>(degree, bezierData->segmentDegrees[i]);
+        }
+
+        segmentBatch.degree = degree;
+        segmentBatch.count = n_generated;
+        segmentBatch.x.resize((degree + 1) * n_generated);
+        segmentBatch.y.resize((degree + 1) * n_generated);
+
+        for (size_t i=0; i<n_generated; i++)
+        {
+            bezier::RuntimePoints<float> points;
+            bezier::RuntimePoints<float> elevated;
+            bezier::Elevate<float>(segmentPoints(i, points), std::span(elevated.data(), degree + 1));
+
+            for (size_t k=0; k<=degree; k++)
+            {
+                segmentBatch.x[(k * n_generated) + i] = elevated[k][0];
+                segmentBatch.y[(k * n_generated) + i] = elevated[k][1];
+            }
+        }
+
+        isBatchValid = true;
+    }
+}
+
+void BezierCurve::measureSegment(size_t segment, float * lut) const
+{
+    // up to cubics segmentControls holds the same curve, measured like the segments of the other curve classes
+    bezier::RuntimePoints<float> points;
+    const std::span<const std::array<float, 2>> p = segmentPoints(segment, points);
+
+    if (p.size() <= 4)
+    {
+        curve_arc_length::Measure(segmentControls[segment], lut);
+    }
+    else
+    {
+        curve_arc_length::MeasureBezier(p, lut);
+    }
+}
+
+void BezierCurve::replacePoints(int32_t first, int32_t old_count, std::span<const std::array<float, 2>> new_points)
+{
+    const int32_t n_new = static_cast<int32_t>(new_points.size());
+    const int32_t n_overwrite = std::min(old_count, n_new);
+
+    for (int32_t i=0; i<n_overwrite; i++)
+    {
+        curveData->pointList[first + i] = new_points[i];
+    }
+    if (n_overwrite > 0)
+    {
+        curveData->pointGrid.Update(curveData->pointList, first, (first + n_overwrite - 1));
+    }
+
+    for (int32_t i=n_overwrite; i<n_new; i++)
+    {
+        InsertPoint(new_points[i], (first + i));
+    }
+
+    for (int32_t i=n_new; i<old_count; i++)
+    {
+        DeletePoint(first + n_new);
+    }
+}
+
+void BezierCurve::InterpolatePoints()
+{
+    CURVE_TRACE_SCOPE("BezierCurve::InterpolatePoints");
+    CURVE_ALLOCATION_SCOPE(INTERPOLATION);
+
+    updateLayout();
+
+    tessellationStats = {};
+    curveList.clear();
+    handleList.clear();
+    segmentOffsets.clear();
+    handleOffsets.clear();
+    segmentBounds.clear();
+    segmentControls.clear();
+    segmentErrors.clear();
+    isCurveBoundsValid = false;
+    isBatchValid = false;
+    segmentTree.Clear();
+    arcLengthTable.Clear();
+    editLog.Reset(curveData->generation);
+
+    // the tessellation mode is looked up once here, every segment then only indexes the kernels by its degree
+    tessellateKernels = &curve_layout::SelectBezierKernels(curveData->tessellationMode);
+
+    const uint32_t n_steps = curve_kernel::StepCount(curveData->smoothFactor); // the larger smoothFactor is the smoother the curve
+    const size_t n_segments = segmentCount();
+
+    if (n_segments > 0)
+    {
+        curveList.reserve((n_segments + 1) * (static_cast<size_t>(n_steps) + 1)); // + 1 for the segment closing the loop
+
+        for (size_t i=0; i<n_segments; i++)
+        {
+            tessellationStats.uniformVertexCount += (n_steps + 1);
+            segmentOffsets.push_back(curveList.size());
+            handleOffsets.push_back(handleList.size());
+
+            tessellatePointSegment(i, n_steps, curveList, segmentBounds, segmentControls, segmentErrors);
+
+            if (curveData->areHandlesGenerated)
+            {
+                appendHandles(i, handleList);
+            }
+        }
+
+        // end the open segments, the closing segment fills the rest of curveList
+        segmentOffsets.push_back(curveList.size());
+        handleOffsets.push_back(handleList.size());
+
+        if (hasClosingSegment())
+        {
+            tessellationStats.uniformVertexCount += (n_steps + 1);
+            tessellatePointSegment(n_segments, n_steps, curveList, segmentBounds, segmentControls, segmentErrors);
+        }
+    }
+    else
+    {
+        segmentOffsets.push_back(0);
+        handleOffsets.push_back(0);
+        std::cerr << "no curve data available or not enough data points!\n";
+    }
+
+    tessellationStats.vertexCount = curveList.size();
+
+    isSegmentDataValid = (n_segments > 0);
+    segmentStepCount = n_steps;
+    segmentTessellationMode = curveData->tessellationMode;
+
+    areStorageArraysValid = false;
+    if (curveData->sampleLayout == SAMPLE_LAYOUT::SOA)
+    {
+        updateStorageArrays();
+    }
+}
+
+BezierCurve::BezierCurve(BezierCurveData *curve_data)
+{
+    setCurveData(curve_data);
+    bezierData = curve_data;
+}
+
+void BezierCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURVE_CONTROL curve_control)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::UpdatePoint");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (curveData && !curveData->pointList.empty())
+    {
+        syncLayout();
+
+        PointList & points = curveData->pointList;
+        const int32_t last_point = static_cast<int32_t>(points.size()) - 1;
+        markPointsDirty((index-2), (index+2)); // the point, its anchor and the control points next to the anchor can change
+
+        // control points are the points between two anchors, an anchor takes the control points next to it along
+
+        if (isAnchorPoint(index))
+        {
+            std::array<float, 2> diff = {(position[0] - points[index][0]), (position[1] - points[index][1])};
+
+            for (int32_t neighbour : {(index-1), (index+1)})
+            {
+                if ((neighbour >= 0) && (neighbour <= last_point) && !isAnchorPoint(neighbour))
+                {
+                    points[neighbour] = {(points[neighbour][0] + diff[0]), (points[neighbour][1] + diff[1])};
+                }
+            }
+
+            points[index] = position;
+        }
+        else
+        {
+            points[index] = position;
+
+            // with CURVE_CONTROL::ALIGNMENT a control point next to an anchor mirrors the control point on the other
+            // side of the anchor (if there is one) so the curve stays smooth through the anchor
+            if (curve_control == CURVE_CONTROL::ALIGNMENT)
+            {
+                const int32_t anchor = isAnchorPoint(index-1) ? (index-1) : (isAnchorPoint(index+1) ? (index+1) : -1);
+                const int32_t opposite = (anchor >= 0) ? ((2 * anchor) - index) : -1;
+
+                if ((opposite >= 0) && (opposite <= last_point) && !isAnchorPoint(opposite))
+                {
+                    points[opposite] = {((2.0f * points[anchor][0]) - position[0]), ((2.0f * points[anchor][1]) - position[1])};
+                }
+            }
+        }
+
+        curveData->pointGrid.Update(points, (index-2), (index+2));
+    }
+    else
+    {
+        std::cerr << "no curve data available!\n";
+    }
+}
+
+void BezierCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::AddAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (!curveData)
+    {
+        std::cerr << "no curve data available!\n";
+        return;
+    }
+
+    syncLayout();
+
+    PointList & points = curveData->pointList;
+    std::vector<uint8_t> & degrees = bezierData->segmentDegrees;
+
+    if (!isLayoutValid)
+    {
+        std::cerr << "Unable to add anchor to curve. segment degrees don't match the point list!\n";
+        return;
+    }
+
+    if (points.empty())
+    {
+        markSegmentsDirty(0, 0, 0);
+        AddPoint(point);
+        updateLayout();
+        return;
+    }
+
+    // the new segment is a straight line raised to newSegmentDegree, its control points can be pulled from there
+    const size_t degree = clampDegree(bezierData->newSegmentDegree);
+
+    if (place_anchor == PLACE_ANCHOR::END) // add new points to end of the curve
+    {
+        markSegmentsDirty(segmentCount(), 0, 1); // new segment after the last one
+
+        const std::array<float, 2> last_anchor = points[points.size() - 1];
+        for (size_t k=1; k<degree; k++)
+        {
+            AddPoint(straightControl(last_anchor, point, k, degree)); // control point
+        }
+        AddPoint(point); // anchor point
+
+        degrees.push_back(static_cast<uint8_t>(degree));
+    }
+    else // add new points to beginning of the curve PLACE_ANCHOR::BEG
+    {
+        markSegmentsDirty(0, 0, 1); // new segment before the first one
+
+        const std::array<float, 2> first_anchor = points[0];
+        InsertPoint(point, 0); // anchor point
+        for (size_t k=1; k<degree; k++)
+        {
+            InsertPoint(straightControl(point, first_anchor, k, degree), static_cast<int32_t>(k)); // control point
+        }
+
+        degrees.insert(degrees.begin(), static_cast<uint8_t>(degree));
+    }
+
+    updateLayout();
+}
+
+void BezierCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::InsertAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (!curveData)
+    {
+        std::cerr << "no curve data available!\n";
+        return;
+    }
+
+    syncLayout();
+
+    // index is the insert index of NearestPointOnCurve, the point after the first anchor of the segment
+    const size_t n_segments = segmentCount();
+    if ((n_segments == 0) || (index < 1) || (static_cast<uint32_t>(index) > segmentStarts.back()))
+    {
+        std::cerr << "no intersection found! Unable to insert a new point!\n";
+        return;
+    }
+
+    const size_t segment = segmentOfPoint(index - 1);
+
+    bezier::RuntimePoints<float> segment_points;
+    const std::span<const std::array<float, 2>> p = segmentPoints(segment, segment_points);
+    const float t = curve_kernel::ClosestBezier(p, point);
+
+    if ((t <= 0.0f) || (t >= 1.0f))
+    {
+        std::cerr << "no intersection found! Unable to insert a new point!\n";
+        return;
+    }
+
+    // split the segment at the point of the curve closest to point. both halves keep the degree of the segment, so
+    // the curve doesn't change shape
+    const size_t degree = p.size() - 1;
+    bezier::RuntimePoints<float> left;
+    bezier::RuntimePoints<float> right;
+    bezier::Split<float>(p, t, std::span(left.data(), p.size()), std::span(right.data(), p.size()));
+
+    std::array<std::array<float, 2>, (2 * bezier::maxDegree) + 1> split_points;
+    std::copy(left.begin(), left.begin() + degree + 1, split_points.begin());
+    std::copy(right.begin() + 1, right.begin() + degree + 1, split_points.begin() + degree + 1);
+
+    markSegmentsDirty(segment, 1, 2); // the segment is replaced by its 2 halves
+
+    replacePoints(static_cast<int32_t>(segmentStarts[segment]), static_cast<int32_t>(degree + 1), std::span<const std::array<float, 2>>(split_points.data(), (2 * degree) + 1));
+
+    std::vector<uint8_t> & degrees = bezierData->segmentDegrees;
+    degrees.insert(degrees.begin() + segment + 1, static_cast<uint8_t>(degree));
+
+    updateLayout();
+}
+
+void BezierCurve::RemoveAnchor(int32_t index)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::RemoveAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (!curveData || curveData->pointList.empty())
+    {
+        std::cerr << "no curve data available or unable to delete because selected point is not an anchor point!\n";
+        return;
+    }
+
+    syncLayout();
+
+    std::vector<uint8_t> & degrees = bezierData->segmentDegrees;
+    const size_t n_segments = segmentCount();
+
+    if (n_segments == 0)
+    {
+        // a single anchor without segments
+        if (isLayoutValid && (index == 0))
+        {
+            markSegmentsDirty(0, 0, 0);
+            DeletePoint(index);
+            updateLayout();
+        }
+        else
+        {
+            std::cerr << "no curve data available or unable to delete because selected point is not an anchor point!\n";
+        }
+        return;
+    }
+
+    if (!isAnchorPoint(index))
+    {
+        std::cerr << "no curve data available or unable to delete because selected point is not an anchor point!\n";
+        return;
+    }
+
+    const size_t anchor = static_cast<size_t>(std::lower_bound(segmentStarts.begin(), segmentStarts.end(), static_cast<uint32_t>(index)) - segmentStarts.begin());
+
+    if (anchor == 0)
+    {
+        markSegmentsDirty(0, 1, 0); // first segment is removed
+        replacePoints(0, degrees.front(), {});
+        degrees.erase(degrees.begin());
+    }
+    else if (anchor == n_segments)
+    {
+        markSegmentsDirty((n_segments - 1), 1, 0); // last segment is removed
+        replacePoints((index - degrees.back() + 1), degrees.back(), {});
+        degrees.pop_back();
+    }
+    else
+    {
+        // the 2 segments sharing the anchor are merged into one of the higher of their degrees. both are raised to it
+        // and the merged segment keeps the first half of the control points of the first segment and the second half
+        // of the second (for 2 cubics: the outer control points)
+        const size_t first_degree = degrees[anchor - 1];
+        const size_t second_degree = degrees[anchor];
+        const size_t degree = std::max(first_degree, second_degree);
+
+        bezier::RuntimePoints<float> first_points;
+        bezier::RuntimePoints<float> second_points;
+        bezier::RuntimePoints<float> first_elevated;
+        bezier::RuntimePoints<float> second_elevated;
+        bezier::Elevate<float>(segmentPoints((anchor - 1), first_points), std::span(first_elevated.data(), degree + 1));
+        bezier::Elevate<float>(segmentPoints(anchor, second_points), std::span(second_elevated.data(), degree + 1));
+
+        bezier::RuntimePoints<float> merged;
+        for (size_t i=0; i<=degree; i++)
+        {
+            if ((2 * i) < degree)
+            {
+                merged[i] = first_elevated[i];
+            }
+            else if ((2 * i) > degree)
+            {
+                merged[i] = second_elevated[i];
+            }
+            else
+            {
+                merged[i] = {0.5f * (first_elevated[i][0] + second_elevated[i][0]), 0.5f * (first_elevated[i][1] + second_elevated[i][1])};
+            }
+        }
+
+        markSegmentsDirty((anchor - 1), 2, 1); // the 2 segments sharing the point are merged
+
+        replacePoints(static_cast<int32_t>(segmentStarts[anchor - 1]), static_cast<int32_t>(first_degree + second_degree + 1), std::span<const std::array<float, 2>>(merged.data(), degree + 1));
+
+        degrees[anchor - 1] = static_cast<uint8_t>(degree);
+        degrees.erase(degrees.begin() + anchor);
+    }
+
+    updateLayout();
+}
+
+void BezierCurve::BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::BuildFromAnchors");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (!curveData)
+    {
+        std::cerr << "no curve data available!\n";
+        return;
+    }
+
+    const size_t degree = clampDegree(bezierData->newSegmentDegree);
+    const size_t n_segments = (anchors.size() > 1) ? (anchors.size() - 1) : 0;
+
+    if (!handles.empty() && (handles.size() != (n_segments * (degree - 1))))
+    {
+        std::cerr << "handles has to hold the control points of every segment!\n";
+        return;
+    }
+
+    // build the whole point list in one pass and tessellate once instead of adding each anchor separately
+    PointList & points = curveData->pointList;
+    points.clear();
+    points.reserve((n_segments * degree) + 1);
+
+    for (size_t i=0; i<anchors.size(); i++)
+    {
+        points.push_back(anchors[i]);
+
+        if ((i + 1) < anchors.size())
+        {
+            for (size_t k=1; k<degree; k++)
+            {
+                points.push_back(handles.empty() ? straightControl(anchors[i], anchors[i + 1], k, degree) : handles[(i * (degree - 1)) + (k - 1)]);
+            }
+        }
+    }
+
+    bezierData->segmentDegrees.assign(n_segments, static_cast<uint8_t>(degree));
+    curveData->pointGrid.Clear(); // rebuilt on the next query
+    markInterpolationDirty();
+    updateLayout();
+}
+
+void BezierCurve::BuildFromSegments(std::span<const std::array<float, 2>> points, std::span<const uint8_t> degrees)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::BuildFromSegments");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (!curveData)
+    {
+        std::cerr << "no curve data available!\n";
+        return;
+    }
+
+    size_t n_points = 1;
+    for (uint8_t degree : degrees)
+    {
+        if ((degree < 1) || (degree > bezier::maxDegree))
+        {
+            std::cerr << "segment degrees have to be between 1 and " << bezier::maxDegree << "!\n";
+            return;
+        }
+        n_points += degree;
+    }
+
+    if (degrees.empty() ? (points.size() > 1) : (n_points != points.size()))
+    {
+        std::cerr << "segment degrees don't match the point list!\n";
+        return;
+    }
+
+    curveData->pointList.assign(points.begin(), points.end());
+    bezierData->segmentDegrees.assign(degrees.begin(), degrees.end());
+    curveData->pointGrid.Clear(); // rebuilt on the next query
+    markInterpolationDirty();
+    updateLayout();
+}
+
+void BezierCurve::CloseLoop(bool close_loop)
+{
+    // the closing segment is the one after the last segment of the layout, which has to match the point list first
+    if (curveData)
+    {
+        syncLayout();
+    }
+
+    SegmentedCurve::CloseLoop(close_loop);
+}
+
+CurveIntersection BezierCurve::NearestPointOnCurve(std::array<float, 2> position)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::NearestPointOnCurve");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    CurveIntersection nearest;
+
+    if (!curveData)
+    {
+        return nearest;
+    }
+
+    updateInterpolation();
+
+    if (!segmentTree.IsBuilt(segmentBounds))
+    {
+        segmentTree.Build(segmentBounds);
+    }
+
+    float nearest_distance = std::numeric_limits<float>::max();
+
+    segmentTree.Nearest(position, [&](size_t segment)
+    {
+        bezier::RuntimePoints<float> segment_points;
+        const std::span<const std::array<float, 2>> p = segmentPoints(segment, segment_points);
+        float t = curve_kernel::ClosestBezier(p, position);
+        std::array<float, 2> point_on_segment = bezier::DeCasteljau<float>(p, t);
+
+        float dx = point_on_segment[0] - position[0];
+        float dy = point_on_segment[1] - position[1];
+        float distance = (dx * dx) + (dy * dy);
+
+        if (distance < nearest_distance)
+        {
+            nearest_distance = distance;
+            nearest.found = true;
+            nearest.position = point_on_segment;
+            nearest.t = t;
+            nearest.segment = segment;
+        }
+
+        return distance;
+    });
+
+    if (nearest.found)
+    {
+        nearest.distance = std::sqrt(nearest_distance);
+
+        // anchors can't be inserted into the closing segment
+        if (nearest.segment < segmentCount())
+        {
+            nearest.insertIndex = segmentStarts[nearest.segment] + 1;
+        }
+    }
+
+    return nearest;
+}
+
+float BezierCurve::Length()
+{
+    CURVE_TRACE_SCOPE("BezierCurve::Length");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (!curveData)
+    {
+        return 0.0f;
+    }
+
+    updateInterpolation();
+    return static_cast<float>(arcLengthTable.Length(segmentControls.size(), [this](size_t segment, float * lut){ measureSegment(segment, lut); }));
+}
+
+CurveLocation BezierCurve::TAtDistance(float distance)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::TAtDistance");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    CurveLocation location;
+    if (!curveData)
+    {
+        return location;
+    }
+
+    updateInterpolation();
+    const ArcLengthTable::SegmentDistance found = arcLengthTable.Find(segmentControls.size(), [this](size_t segment, float * lut){ measureSegment(segment, lut); }, distance);
+    if (!found.lut)
+    {
+        return location;
+    }
+
+    bezier::RuntimePoints<float> points;
+    const std::span<const std::array<float, 2>> p = segmentPoints(found.segment, points);
+
+    location.found = true;
+    location.segment = found.segment;
+
+    if (p.size() <= 4)
+    {
+        const SegmentControls & controls = segmentControls[found.segment];
+        location.t = curve_arc_length::TAtLength(controls, found.lut, found.length);
+        location.position = curve_arc_length::Evaluate(controls, location.t);
+    }
+    else
+    {
+        location.t = curve_arc_length::TAtLengthBezier(p, found.lut, found.length);
+        location.position = bezier::DeCasteljau<float>(p, location.t);
+    }
+
+    return location;
+}
+
+void BezierCurve::SampleAtDistances(std::span<const float> distances, const PathSamples & out)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::SampleAtDistances");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (curveData)
+    {
+        updateInterpolation();
+        updateBatch();
+    }
+
+    const size_t n_segments = curveData ? segmentBatch.count : 0;
+    if (n_segments == 0)
+    {
+        std::fill_n(out.x, distances.size(), 0.0f);
+        std::fill_n(out.y, distances.size(), 0.0f);
+        if (out.tangentX)
+        {
+            std::fill_n(out.tangentX, distances.size(), 0.0f);
+            std::fill_n(out.tangentY, distances.size(), 0.0f);
+        }
+        return;
+    }
+
+    // like SampleAtParameters, with the parameter of every query found on the segment at its own degree (the same
+    // newton's method as TAtDistance)
+    constexpr size_t queryBlockSize = 256;
+    ArcLengthTable::SegmentDistance found[queryBlockSize];
+    uint32_t segments[queryBlockSize];
+    float t[queryBlockSize];
+
+    for (size_t first=0; first<distances.size(); first+=queryBlockSize)
+    {
+        const size_t n_queries = std::min(queryBlockSize, distances.size() - first);
+        arcLengthTable.Find(n_segments, [this](size_t segment, float * lut){ measureSegment(segment, lut); }, distances.subspan(first, n_queries), found);
+
+        for (size_t i=0; i<n_queries; i++)
+        {
+            bezier::RuntimePoints<float> points;
+            const std::span<const std::array<float, 2>> p = segmentPoints(found[i].segment, points);
+
+            segments[i] = static_cast<uint32_t>(found[i].segment);
+            t[i] = (p.size() <= 4) ? curve_arc_length::TAtLength(segmentControls[found[i].segment], found[i].lut, found[i].length) : curve_arc_length::TAtLengthBezier(p, found[i].lut, found[i].length);
+        }
+
+        curve_kernel::SampleBatch(segmentBatch, segments, t, n_queries, out, first);
+    }
+}
+
+void BezierCurve::SampleAtParameters(std::span<const float> parameters, const PathSamples & out)
+{
+    CURVE_TRACE_SCOPE("BezierCurve::SampleAtParameters");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (curveData)
+    {
+        updateInterpolation();
+        updateBatch();
+    }
+
+    const size_t n_segments = curveData ? segmentBatch.count : 0;
+    if (n_segments == 0)
+    {
+        std::fill_n(out.x, parameters.size(), 0.0f);
+        std::fill_n(out.y, parameters.size(), 0.0f);
+        if (out.tangentX)
+        {
+            std::fill_n(out.tangentX, parameters.size(), 0.0f);
+            std::fill_n(out.tangentY, parameters.size(), 0.0f);
+        }
+        return;
+    }
+
+    // the segment and parameter of every query are resolved a block at a time on the stack, then the block is sampled
+    // from the raised segments of segmentBatch
+    constexpr size_t queryBlockSize = 256;
+    uint32_t segments[queryBlockSize];
+    float t[queryBlockSize];
+
+    for (size_t first=0; first<parameters.size(); first+=queryBlockSize)
+    {
+        const size_t n_queries = std::min(queryBlockSize, parameters.size() - first);
+
+        for (size_t i=0; i<n_queries; i++)
+        {
+            const double curve_t = std::min(std::max(0.0, static_cast<double>(parameters[first + i])), 1.0) * static_cast<double>(n_segments); // nan as 0
+            const size_t segment = std::min(static_cast<size_t>(curve_t), n_segments - 1);
+
+            segments[i] = static_cast<uint32_t>(segment);
+            t[i] = static_cast<float>(curve_t - static_cast<double>(segment));
+        }
+
+        curve_kernel::SampleBatch(segmentBatch, segments, t, n_queries, out, first);
+    }
+}
+
+const std::vector<float> & BezierCurve::SegmentReductionErrors()
+{
+    updateInterpolation();
+    return segmentErrors;
+}
+
+CURVE_TYPE BezierCurve::WorkCurveType()
+{
+    return CURVE_TYPE::BEZIER;
+}
+
+std::unique_ptr<BezierCurveData> BezierCurve::NewCurveData()
+{
+    auto curve_data = std::make_unique<BezierCurveData>();
+    curve_data->smoothFactor = 50.0f;
+    return curve_data;
+}
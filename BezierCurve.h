@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Bezier.h"
+#include "SegmentedCurve.h"
+#include "CurveKernel.h"
+#include "CurveLayout.h"
+#include <vector>
+#include <array>
+#include <memory>
+
+// curve data of a BezierCurve. the point list holds the anchors with the control points of the segment between two
+// anchors in between them (a segment of degree d has d - 1 control points), so segments of different degrees follow
+// each other in one list
+struct BezierCurveData : CurveData
+{
+    std::vector<uint8_t> segmentDegrees; // degree of every open segment in order (1 to bezier::maxDegree). empty reads the point list as lines
+    uint8_t newSegmentDegree = 3; // degree of the segments AddAnchor and BuildFromAnchors create
+
+    BezierCurveData() : CurveData(CURVE_TYPE::BEZIER) {}
+};
+
+class BezierCurve final : public SegmentedCurve
+{
+    private:
+        BezierCurveData * bezierData = nullptr; // curveData as the bezier curve data holding the segment degrees
+
+        std::vector<uint32_t> segmentStarts; // first point of every open segment in the point list followed by the last anchor (built from segmentDegrees)
+        bool isLayoutValid = false; // segmentDegrees matches the number of points (segmentStarts is empty otherwise)
+        std::vector<size_t> handleOffsets; // start of the handles of every open segment in handleList followed by the end of handleList
+        std::vector<float> segmentErrors; // distance bound between every generated segment and its cubic in segmentControls (the segment blocks, the arc length measures the segments themselves)
+        std::vector<float> errorsScratch; // reused buffer the errors of edited segments are generated into before being spliced into segmentErrors
+        curve_kernel::BezierBatch segmentBatch; // every generated segment raised to the highest degree of the curve, sampled by SampleAtParameters
+        bool isBatchValid = false; // segmentBatch matches the generated segments
+        std::vector<size_t> handleScratchOffsets; // start of the handles of every segment in handleScratch
+
+        const curve_layout::BezierTessellateKernels * tessellateKernels = &curve_layout::SelectBezierKernels(TESSELLATION_MODE::UNIFORM); // tessellation of a single segment of every degree in the mode of the last interpolation
+
+        bool isAnchorPoint(int32_t index) const; // true if the point at index starts or ends a segment
+        size_t segmentOfPoint(int32_t index) const; // open segment the control point at index belongs to (the segment starting at an anchor)
+        std::span<const std::array<float, 2>> segmentPoints(size_t segment, bezier::RuntimePoints<float> & out) const; // control points of a generated segment copied to out (segmentCount() is the closing segment)
+        void tessellateSegment(std::span<const std::array<float, 2>> points, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out, std::vector<float> & errors_out); // tessellate a single segment to the end of out and add its bounds, cubic controls and their error
+        void appendHandles(size_t segment, std::vector<std::array<float, 2>> & out) const; // append the control polygon of an open segment to out
+        size_t segmentCount() const override; // number of open segments in the point list
+        bool hasClosingSegment() const; // true if a line from the last to the first point is generated
+        void tessellatePointSegment(size_t segment, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out, std::vector<float> & errors_out); // tessellateSegment for a segment of the point list (segmentCount() is the closing segment)
+        void retessellateSegments(size_t first_segment, size_t old_count, size_t new_count) override; // replace old_count generated segments with new_count segments re-tessellated from the point list
+        void markPointsDirty(int32_t first_point, int32_t last_point); // record an edit of the given range of points before it is made
+        void updateLayout(); // rebuild segmentStarts from segmentDegrees
+        void syncLayout(); // updateLayout if the curve data was changed outside of this class
+        void updateBatch(); // raise the generated segments into segmentBatch if it doesn't match them
+        void measureSegment(size_t segment, float * lut) const; // arc length lookup table of a generated segment, measured on the segment itself rather than its cubic
+        void replacePoints(int32_t first, int32_t old_count, std::span<const std::array<float, 2>> new_points); // replace old_count points starting at first with new_points
+
+    protected:
+        void InterpolatePoints() override; // generate curve from CurveData point list
+
+    public:
+        BezierCurve() = default;
+        explicit BezierCurve(BezierCurveData *curve_data);
+
+        void UpdatePoint(int32_t index, std::array<float, 2> position, CURVE_CONTROL curve_control) override; // update selected point around. If anchor is selected then its neighbouring control points are also updated
+        void AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor) override; // add a straight segment of newSegmentDegree to the new point
+        void InsertAnchor(std::array<float, 2> point, int32_t index) override; // split the segment index is in at the point of the curve closest to point (the shape doesn't change)
+        void RemoveAnchor(int32_t index) override; // remove anchor and control points from curve, the segments sharing an inner anchor are merged into one of the higher of their degrees
+        void BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles = {}) override; // replace the curve with segments of newSegmentDegree between the anchors. handles holds their control points in order, straight segments if empty
+        void BuildFromSegments(std::span<const std::array<float, 2>> points, std::span<const uint8_t> degrees); // replace the curve with segments of the given degrees (points holds sum(degrees) + 1 points)
+        void CloseLoop(bool close_loop) override; // close the curve - create a line from the last point to the first
+        CurveIntersection NearestPointOnCurve(std::array<float, 2> position) override; // exact nearest point on the curve
+        float Length() override; // arc length of the generated curve, every segment measured at its own degree
+        CurveLocation TAtDistance(float distance) override; // segment, parameter and position at distance along the generated curve, exact for every degree
+        void SampleAtDistances(std::span<const float> distances, const PathSamples & out) override; // position and unit tangent at every distance along the generated curve, exact for every degree
+        void SampleAtParameters(std::span<const float> parameters, const PathSamples & out) override; // position and unit tangent at parameters 0..1 over the generated curve (every segment covers an equal share), exact for every degree
+
+        const std::vector<float> & SegmentReductionErrors(); // distance bound between every generated segment and its cubic in SegmentControlBlocks() (0 up to cubics)
+        CURVE_TYPE WorkCurveType() override;
+
+        BezierCurve & operator= (const std::unique_ptr<BezierCurveData> & rhs)
+        {
+            this->setCurveData(rhs.get());
+            this->bezierData = rhs.get();
+            return *this;
+        }
+
+        BezierCurve & operator= (std::unique_ptr<BezierCurveData>&& rhs)
+        {
+            this->setCurveData(rhs.get());
+            this->bezierData = rhs.get();
+            return *this;
+        }
+
+        static std::unique_ptr<BezierCurveData> NewCurveData(); // create new curve object
+};
@@ -1,40 +1,16 @@
 #include "CubicCurve.h"
+#include "CurveKernel.h"
+#include "CurveLayout.h"
+#include "CurveSegments.h"
+#include "CurveArcLength.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
 
 #include <iostream>
 
-std::array<float, 2> CubicCurve::interpolate(const std::array<float, 2>  & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, const float & parametric_t)
-{
-    // lerp p0(a), p1(b) and p1(b), p2(c) which will result in q0
-    float x0 = std::lerp(a[0], b[0], parametric_t);
-    float y0 = std::lerp(a[1], b[1], parametric_t);
-
-    float x1 = std::lerp(b[0], c[0], parametric_t);
-    float y1 = std::lerp(b[1], c[1], parametric_t);
-
-    float xq0 = std::lerp(x0, x1, parametric_t);
-    float yq0 = std::lerp(y0, y1, parametric_t);
-
-    // lerp p1(b), p2(c) and p2(c), p3(d) which will result in q1
-    float x2 = std::lerp(b[0], c[0], parametric_t);
-    float y2 = std::lerp(b[1], c[1], parametric_t);
-
-    float x3 = std::lerp(c[0], d[0], parametric_t);
-    float y3 = std::lerp(c[1], d[1], parametric_t);
-
-    float xq1 = std::lerp(x2, x3, parametric_t);
-    float yq1 = std::lerp(y2, y3, parametric_t);
-
-    // lerp the results of pq0(q0) and pq1(q1) which results in pc
-    float xpc = std::lerp(xq0, xq1, parametric_t);
-    float ypc = std::lerp(yq0, yq1, parametric_t);
-
-    // point result on cubic curve
-    return {xpc, ypc};
-}
-
 int32_t CubicCurve::GetClosestAnchorPoint(const int32_t & index)
 {
     // check if selected point is an anchor point.
@@ -77,212 +53,17 @@ bool CubicCurve::IsAnchorPoint(int32_t index)
     return (sel_idx == 0);
 }
 
-void CubicCurve::interpolateWithCubicHint()
+void CubicCurve::markPointsDirty(int32_t first_point, int32_t last_point)
 {
-    constexpr size_t min_points = 4;
-    curveList.clear();
-    handleList.clear();
-
-    if (curveData && curveData->pointList.size() >= min_points)
-    {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
+    // segment i is made of the points (i*3)+1 to (i*3)+4 and its handles also use the points (i*3) and (i*3)+5
+    const int32_t n_segments = static_cast<int32_t>(segmentCount());
+    int32_t first_segment = std::min((std::max(first_point - 5, 0) + 2) / 3, n_segments);
+    int32_t last_segment = std::min(last_point / 3, n_segments - 1);
+    size_t n_dirty = (last_segment >= first_segment) ? (last_segment - first_segment + 1) : 0;
 
-        size_t n_segments = (curveData->pointList.size() / 3) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        for (size_t i=0; i<n_segments; i++)
-        {
-            uint32_t point_a = (i * 3) + 1;
-            uint32_t point_b = (i * 3) + 2;
-            uint32_t point_c = (i * 3) + 3;
-            uint32_t point_d = (i * 3) + 4;
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], curveData->pointList[point_d], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
-
-            if (curveData->areHandlesGenerated)
-            {
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_a-1]);
-
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_c]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_d+1]);
-            }
-
-        }
-
-        constexpr size_t min_points_for_closed_curve = 6;
-        if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
-        {
-            std::array<float, 2> new_point {};
-
-            if (!curveData->pointList.empty())
-            {
-                uint32_t point_a = curveData->pointList.size()-2;
-                uint32_t point_b = curveData->pointList.size()-1;
-                uint32_t point_c = 0;
-                uint32_t point_d = 1;
-
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], curveData->pointList[point_d], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
-            }
-        }
-    }
-    else if ((curveData && curveData->pointList.size() >= (min_points-1)) && curveData->areHandlesGenerated)
-    {
-        // draw handles if there are at least 3 points
-        uint32_t point_a = 1;
-        uint32_t point_b = 2;
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_a-1]);
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_b]);
-    }
-    else
-    {
-        std::cerr << "no curve data available or not enough data points!\n";
-    }
+    markSegmentsDirty(first_segment, n_dirty, n_dirty);
 }
 
-void CubicCurve::interpolateWithQuadraticHint()
-{
-    constexpr size_t min_points = 4;
-    curveList.clear();
-    handleList.clear();
-
-    if (curveData && curveData->pointList.size() >= min_points)
-    {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
-
-        size_t n_segments = (curveData->pointList.size() / 2) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        for (size_t i=0; i<n_segments; i++)
-        {
-            uint32_t point_a = (i * 2) + 0;
-            uint32_t point_b = (i * 2) + 1;
-            uint32_t point_c = point_b;
-            uint32_t point_d = (i * 2) + 2;
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], curveData->pointList[point_d], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
-
-            if (curveData->areHandlesGenerated)
-            {
-                /*
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_a-1]);
-
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_c]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_d+1]);
-                */
-
-                //handleList.emplace_back(curveData->pointList[point_a]);
-                //handleList.emplace_back(curveData->pointList[point_a-1]);
-
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-
-                handleList.emplace_back(curveData->pointList[point_b]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_c]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_d+1]);
-            }
-
-        }
-
-        constexpr size_t min_points_for_closed_curve = 4;
-        if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
-        {
-            std::array<float, 2> new_point {};
-
-            if (!curveData->pointList.empty())
-            {
-                uint32_t point_a = curveData->pointList.size()-2;
-                uint32_t point_b = curveData->pointList.size()-1;
-                uint32_t point_c = point_b;
-                uint32_t point_d = 0;
-
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], curveData->pointList[point_d], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
-            }
-        }
-    }
-    else if ((curveData && curveData->pointList.size() >= (min_points-1)) && curveData->areHandlesGenerated)
-    {
-        // draw handles if there are at least 3 points
-        uint32_t point_a = 1;
-        uint32_t point_b = 2;
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_a-1]);
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_b]);
-    }
-    else
-    {
-        std::cerr << "no curve data available or not enough data points!\n";
-    }
-}
 //NEEDS TO BE DONE
 void CubicCurve::interpolateWithLinearHint()
 {
@@ -292,17 +73,15 @@ void CubicCurve::interpolateWithLinearHint()
 
     if (curveData && curveData->pointList.size() >= min_points)
     {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
+        const uint32_t n_steps = curve_kernel::StepCount(curveData->smoothFactor); // the larger smoothFactor is the smoother the line
+        const size_t n_samples = n_steps + 1; // number of points generated per segment
 
         size_t n_segments = curveData->pointList.size()- 1;
         n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
 
+        curveList.reserve((n_segments + 1) * n_samples); // + 1 for the segment closing the loop
+        handleList.reserve(n_segments * 8);
+
         if (!curveUpscaleData)
         {
             curveUpscaleData = std::make_unique<CurveData>(CURVE_TYPE::QUADRATIC);
@@ -394,17 +173,7 @@ void CubicCurve::interpolateWithLinearHint()
 
             }
 
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], control_point_b, control_point_d, curveData->pointList[point_c], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
+            appendSegment({{curveData->pointList[point_a], control_point_b, control_point_d, curveData->pointList[point_c]}}, n_steps);
 
             if (curveData->areHandlesGenerated)
             {
@@ -476,67 +245,21 @@ void CubicCurve::interpolateWithLinearHint()
     }
 }
 
-void CubicCurve::AddPoint(std::array<float, 2> point)
-{
-    if (curveData)
-    {
-        curveData->pointList.push_back(point);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void CubicCurve::InsertPoint(std::array<float, 2> point, int32_t index)
-{
-    if (curveData)
-    {
-        curveData->pointList.insert(curveData->pointList.begin() + index, point);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void CubicCurve::DeletePoint(int32_t index)
-{
-    if (curveData)
-    {
-        curveData->pointList.erase(curveData->pointList.begin() + index);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void CubicCurve::InterpolatePoints()
-{
-    if (curveData->curveType == CURVE_TYPE::CUBIC)
-    {
-        interpolateWithCubicHint();
-    }
-    else if (curveData->curveType == CURVE_TYPE::QUADRATIC)
-    {
-        interpolateWithQuadraticHint();
-    }
-    else // CURVE_TYPE::LINEAR
-    {
-        interpolateWithLinearHint();
-    }
-}
-
 CubicCurve::CubicCurve(CurveData *curve_data)
 {
-    curveData = curve_data;
+    setCurveData(curve_data);
 }
 
 void CubicCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURVE_CONTROL curve_control)
 {
+    CURVE_TRACE_SCOPE("CubicCurve::UpdatePoint");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData && !curveData->pointList.empty())
     {
+        const int32_t closest_anchor = GetClosestAnchorPoint(index);
+        markPointsDirty((closest_anchor-1), (closest_anchor+1)); // the anchor and its control points can change
+
         // if the point selected to be updated is an anchor point then update the control points to move along
         // with the updated anchor point position
 
@@ -575,7 +298,7 @@ void CubicCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURVE
             }
         }
 
-        InterpolatePoints(); // update curve data
+        curveData->pointGrid.Update(curveData->pointList, (closest_anchor-1), (closest_anchor+1));
     }
     else
     {
@@ -585,6 +308,9 @@ void CubicCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURVE
 
 void CubicCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor)
 {
+    CURVE_TRACE_SCOPE("CubicCurve::AddAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData->pointList.empty() || (curveData->pointList.size() < 4))
     {
         if (curveData->pointList.empty())
@@ -607,11 +333,15 @@ void CubicCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor
             std::array<float, 2> new_control_point1 = {point[0] + initialControlDistance, point[1]}; // put control point to the left of the anchor point
             AddPoint(new_control_point1); // control point
         }
+
+        markInterpolationDirty();
     }
     else
     {
         if (place_anchor == PLACE_ANCHOR::END) // add new points to end of the curve
         {
+            markSegmentsDirty(segmentCount(), 0, 1); // new segment after the last one
+
             // find the differences of the last anchor points, and it's control points, so it can be added to the new created segment points
             // get last control and anchor points
             std::array<float, 2> last_anchor_point = curveData->pointList[curveData->pointList.size()-2];
@@ -636,6 +366,8 @@ void CubicCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor
         }
         else // add new points to beginning of the curve PLACE_ANCHOR::BEG
         {
+            markSegmentsDirty(0, 0, 1); // new segment before the first one
+
             // find the differences of the last anchor points, and it's control points, so it can be added to the new created segment points
             // get last control and anchor points
             const int32_t index = 0;
@@ -662,12 +394,13 @@ void CubicCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor
             InsertPoint(new_control_point_0, index); // control point
         }
     }
-
-    InterpolatePoints();
 }
 
 void CubicCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
 {
+    CURVE_TRACE_SCOPE("CubicCurve::InsertAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData && (index > 1))
     {
         // find the differences of the last anchor points, and it's control points, so it can be added to the new created segment points
@@ -682,6 +415,8 @@ void CubicCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
         std::array<float, 2> last_anchor_offset0 = {(point[0] - l_control_point[0]) / 2.0f, (point[1] - l_control_point[1]) / 2.0f};
         std::array<float, 2> last_anchor_offset1 = {(point[0] - r_control_point[0]) / 2.0f, (point[1] - r_control_point[1]) / 2.0f};
 
+        markSegmentsDirty(((index - 1) / 3), 1, 2); // the segment the anchor is inserted into is split in two
+
         // add new segment by adding 3 new points to the list
         // add new control point (right control point)
         std::array<float, 2> new_control_point_1 = {(point[0] + last_anchor_offset1[0]), (point[1] + last_anchor_offset1[1])};
@@ -693,8 +428,6 @@ void CubicCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
         // add new control point (left control point)
         std::array<float, 2> new_control_point_0 = {(point[0] + last_anchor_offset0[0]), (point[1] + last_anchor_offset0[1])};
         InsertPoint(new_control_point_0, (index+1)); // control point
-
-        InterpolatePoints();
     }
     else
     {
@@ -704,18 +437,35 @@ void CubicCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
 
 void CubicCurve::RemoveAnchor(int32_t index)
 {
+    CURVE_TRACE_SCOPE("CubicCurve::RemoveAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData && (curveData->pointList.empty() || (curveData->pointList.size() >= 3)))
     {
         index = GetClosestAnchorPoint(index);
 
+        const int32_t anchor = (index - 1) / 3;
+        const int32_t last_anchor = static_cast<int32_t>(curveData->pointList.size() / 3) - 1;
+
+        if (anchor == 0)
+        {
+            markSegmentsDirty(0, 1, 0); // first segment is removed
+        }
+        else if (anchor == last_anchor)
+        {
+            markSegmentsDirty((anchor - 1), 1, 0); // last segment is removed
+        }
+        else
+        {
+            markSegmentsDirty((anchor - 1), 2, 1); // the 2 segments sharing the anchor are merged
+        }
+
         // remove 3 points --> the 2 control points and anchor point
         int32_t remove_index = (index-1);
         for (size_t i=0; i<3; i++)
         {
             DeletePoint(remove_index);
         }
-
-        InterpolatePoints();
     }
     else
     {
@@ -723,112 +473,100 @@ void CubicCurve::RemoveAnchor(int32_t index)
     }
 }
 
-void CubicCurve::CloseLoop(bool close_loop)
-{
-    if(curveData)
-    {
-        curveData->isCloseLoop = close_loop;
-        InterpolatePoints();
-    }
-}
-
-std::pair<std::array<float, 2>, uint32_t> CubicCurve::IntersectionOnCurve(std::array<float, 2> position)
+void CubicCurve::BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles)
 {
-    std::array<float,2> position_on_curve = {std::numeric_limits<float>::min(), std::numeric_limits<float>::min()};
-    uint32_t index_insert_index = -1;
+    CURVE_TRACE_SCOPE("CubicCurve::BuildFromAnchors");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
 
-    if (curveData && (curveData->pointList.size() > 5))
+    if (curveData && (handles.empty() || (handles.size() == (anchors.size() * 2))))
     {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / (curveData->smoothFactor * 2.0f); // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
-
-        size_t n_segments = (curveData->pointList.size() / 3) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        bool found_intersection = false;
+        // build the whole point list in one pass and tessellate once instead of adding each anchor separately
+        curveData->pointList.clear();
+        curveData->pointGrid.Clear(); // rebuilt on the next query
+        curveData->pointList.reserve(anchors.size() * 3);
 
-        for (size_t i=0; i<n_segments; i++)
+        for (size_t i=0; i<anchors.size(); i++)
         {
-            uint32_t point_a = (i * 3) + 1; // anchor point
-            uint32_t point_b = (i * 3) + 2; // control point
-            uint32_t point_c = (i * 3) + 3; // control point
-            uint32_t point_d = (i * 3) + 4; // anchor point
-
-            std::array<float, 2> new_point {};
+            const std::array<float, 2> & point = anchors[i];
 
-            while (t <= (t_constrain_end + epsilon))
+            if (handles.empty())
             {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], curveData->pointList[point_d], t);
-
-                // check point
-                std::array<float, 2> check_distance = {std::abs(new_point[0] - position[0]), std::abs(new_point[1] - position[1])};
-                float dst = std::sqrt((check_distance[0]*check_distance[0]) + (check_distance[1]*check_distance[1]));
-
-                constexpr float default_radius = 10.0f;
-                if (dst <= default_radius)
-                {
-                    position_on_curve = new_point;
-                    found_intersection = true;
-                    index_insert_index = point_b;
-                    break;
-                }
-
-                t += step_size;
+                // same control points AddAnchor generates, every anchor copies the offsets of the first one
+                curveData->pointList.push_back({point[0] - initialControlDistance, point[1]}); // control point
+                curveData->pointList.push_back(point); // anchor point
+                curveData->pointList.push_back({point[0] + initialControlDistance, point[1]}); // control point
             }
-
-            if (found_intersection)
+            else
             {
-                break;
+                curveData->pointList.push_back(handles[i*2 + 0]); // control point
+                curveData->pointList.push_back(point); // anchor point
+                curveData->pointList.push_back(handles[i*2 + 1]); // control point
             }
-
-            t = t_constrain_beg;
         }
-    }
 
-    return {position_on_curve, index_insert_index};
-}
-
-std::vector<std::array<float, 2>> CubicCurve::Data()
-{
-    return curveList;
+        markInterpolationDirty();
+    }
+    else
+    {
+        std::cerr << "no curve data available or the handle count does not match the anchors (2 handles per anchor)!\n";
+    }
 }
 
-const std::vector<std::array<float, 2>> & CubicCurve::HandleData()
+CurveIntersection CubicCurve::NearestPointOnCurve(std::array<float, 2> position)
 {
-    return handleList;
-}
+    CURVE_TRACE_SCOPE("CubicCurve::NearestPointOnCurve");
+    CURVE_ALLOCATION_SCOPE(QUERY);
 
-const std::vector<std::array<float, 2>> & CubicCurve::GetPointData()
-{
-    return curveData->pointList;
-}
+    CurveIntersection nearest;
 
-void CubicCurve::ForceInterpolation()
-{
-    InterpolatePoints();
-}
+    if (!curveData)
+    {
+        return nearest;
+    }
 
-CURVE_TYPE CubicCurve::CurveType()
-{
-    CURVE_TYPE curve_type = CURVE_TYPE::UNKNOWN;
+    updateInterpolation();
 
-    if (curveData)
+    if (!segmentTree.IsBuilt(segmentBounds))
     {
-        curve_type = curveData->curveType;
+        segmentTree.Build(segmentBounds);
     }
 
-    return curve_type;
-}
+    float nearest_distance = std::numeric_limits<float>::max();
 
-CURVE_TYPE CubicCurve::WorkCurveType()
-{
-    return CURVE_TYPE::CUBIC;
+    // segmentControls holds the 4 points of every generated segment next to each other (the cubic hint copies them from
+    // the point list unchanged, the other hints generate them), which saves the gap buffer lookups of the strided point
+    // indices
+    segmentTree.Nearest(position, [&](size_t segment)
+    {
+        const SegmentControls & p = segmentControls[segment];
+        float t = curve_kernel::ClosestCubic(p[0], p[1], p[2], p[3], position);
+        std::array<float, 2> point_on_segment = curve_layout::Segment<CURVE_TYPE::CUBIC>{p}.Evaluate(t);
+
+        float dx = point_on_segment[0] - position[0];
+        float dy = point_on_segment[1] - position[1];
+        float distance = (dx * dx) + (dy * dy);
+
+        if (distance < nearest_distance)
+        {
+            nearest_distance = distance;
+            nearest.found = true;
+            nearest.position = point_on_segment;
+            nearest.t = t;
+            nearest.segment = segment;
+        }
+
+        return distance;
+    });
+
+    if (nearest.found)
+    {
+        nearest.distance = std::sqrt(nearest_distance);
+
+        // anchors can't be inserted into the closing segment
+        nearest.insertIndex = curve_layout::InsertIndex(curveData->curveType, curveData->pointList, nearest.segment);
+    }
+
+    return nearest;
 }
 
 std::unique_ptr<CurveData> CubicCurve::NewCurveData()
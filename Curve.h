@@ -1,11 +1,19 @@
 #pragma once
 
+#include "PointList.h"
+#include "PointGrid.h"
+
 #include <vector>
 #include <array>
+#include <span>
 #include <cstdint>
+#include <limits>
+#include <algorithm>
 #include <iostream>
 
-enum class CURVE_TYPE : uint16_t {UNKNOWN, LINEAR, QUADRATIC, CUBIC};
+enum class CURVE_TYPE : uint16_t {UNKNOWN, LINEAR, QUADRATIC, CUBIC, BEZIER}; // BEZIER: segments of mixed degrees (BezierCurveData)
+enum class TESSELLATION_MODE : uint16_t {UNIFORM, FORWARD_DIFFERENCE, ADAPTIVE, ARC_LENGTH};
+enum class SAMPLE_LAYOUT : uint16_t {INTERLEAVED, SOA};
 
 inline std::ostream& operator<<(std::ostream& os, const CURVE_TYPE & curve_type)
 {
@@ -26,6 +34,10 @@ inline std::ostream& operator<<(std::ostream& os, const CURVE_TYPE & curve_type)
         case CURVE_TYPE::CUBIC:
             os << "cubic";
             break;
+
+        case CURVE_TYPE::BEZIER:
+            os << "bezier";
+            break;
     }
 
     return os;
@@ -33,13 +45,18 @@ inline std::ostream& operator<<(std::ostream& os, const CURVE_TYPE & curve_type)
 
 struct CurveData
 {
-    std::vector<std::array<float, 2>>  pointList; // anchor points (mis point between 2 segments that is not a control point unless the intended curve is linear)
+    PointList pointList; // anchor points (mis point between 2 segments that is not a control point unless the intended curve is linear)
     std::vector<std::array<float, 2>*> controlPointList;
+    PointGrid pointGrid; // spatial index over pointList for picking (kept in sync by the curve classes)
 
     uint32_t id = 0;
     bool isCloseLoop = false;
     bool areHandlesGenerated = true;
     float smoothFactor = 1.0f;
+    TESSELLATION_MODE tessellationMode = TESSELLATION_MODE::UNIFORM; // how the curve classes sample each segment
+    float flatnessTolerance = 0.25f; // max distance (in pixels) between the curve and the generated lines when using TESSELLATION_MODE::ADAPTIVE
+    SAMPLE_LAYOUT sampleLayout = SAMPLE_LAYOUT::INTERLEAVED; // SOA: the curve classes also update DataArrays() and SegmentControlBlocks() on every edit instead of converting them when they are read
+    uint64_t generation = 0; // bumped by the curve classes on every change to the curve
     const CURVE_TYPE curveType = CURVE_TYPE::CUBIC;
 
     CurveData() = default;
@@ -47,6 +64,92 @@ struct CurveData
     virtual ~CurveData() = default;
 };
 
+struct TessellationStats
+{
+    size_t uniformVertexCount = 0; // vertices uniform sampling with smoothFactor would have generated
+    size_t vertexCount = 0; // vertices generated by the active tessellation mode
+
+    size_t VerticesSaved() const
+    {
+        return (uniformVertexCount > vertexCount) ? (uniformVertexCount - vertexCount) : 0;
+    }
+};
+
+struct CurveBounds
+{
+    std::array<float, 2> min = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    std::array<float, 2> max = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+
+    bool IsEmpty() const
+    {
+        return (min[0] > max[0]) || (min[1] > max[1]);
+    }
+
+    void Expand(const std::array<float, 2> & point)
+    {
+        min = {std::min(min[0], point[0]), std::min(min[1], point[1])};
+        max = {std::max(max[0], point[0]), std::max(max[1], point[1])};
+    }
+
+    void Expand(const CurveBounds & bounds)
+    {
+        min = {std::min(min[0], bounds.min[0]), std::min(min[1], bounds.min[1])};
+        max = {std::max(max[0], bounds.max[0]), std::max(max[1], bounds.max[1])};
+    }
+
+    bool Contains(const std::array<float, 2> & point, float margin = 0.0f) const
+    {
+        return (point[0] >= (min[0] - margin)) && (point[0] <= (max[0] + margin)) && (point[1] >= (min[1] - margin)) && (point[1] <= (max[1] + margin));
+    }
+
+    bool Intersects(const CurveBounds & bounds) const
+    {
+        return (min[0] <= bounds.max[0]) && (max[0] >= bounds.min[0]) && (min[1] <= bounds.max[1]) && (max[1] >= bounds.min[1]);
+    }
+};
+
+struct SampleEdit
+{
+    uint64_t generation = 0; // generation of the curve the edit was made at
+    size_t first = 0; // first sample (or handle) that was replaced
+    size_t oldCount = 0; // number of samples that were replaced
+    size_t newCount = 0; // number of samples they were replaced with
+    bool isHandleEdit = false; // the edit is to HandleData() instead of Data()
+};
+
+constexpr uint32_t noInsertIndex = std::numeric_limits<uint32_t>::max(); // insert index of a segment no anchor can be inserted into (the closing segment)
+
+struct CurveIntersection
+{
+    bool found = false; // false if the curve has no segments to project onto
+    std::array<float, 2> position = {}; // point on the curve closest to the query position
+    float t = 0.0f; // parameter of position on its segment (0 <= t <= 1)
+    float distance = std::numeric_limits<float>::max(); // distance from the query position to position
+    size_t segment = 0; // generated segment position is on (a closing segment is last)
+    uint32_t insertIndex = noInsertIndex; // index to pass to InsertAnchor to insert an anchor on this segment (noInsertIndex for a closing segment)
+};
+
+struct CurveLocation
+{
+    bool found = false; // false if the curve has no segments
+    std::array<float, 2> position = {}; // point at the distance along the curve
+    float t = 0.0f; // parameter of position on its segment (0 <= t <= 1)
+    size_t segment = 0; // generated segment position is on (a closing segment is last)
+};
+
+// caller provided structure of arrays the batch path queries write to, one entry per query in every array
+struct PathSamples
+{
+    float * x = nullptr; // position
+    float * y = nullptr;
+    float * tangentX = nullptr; // unit tangent (both nullptr to skip the tangents)
+    float * tangentY = nullptr;
+};
+
+class CurveBvh;
+class PointArrays;
+class SegmentBlocks;
+
 enum class CURVE_CONTROL : uint16_t {FREE, ALIGNMENT};
 enum class PLACE_ANCHOR : uint16_t {BEG, END};
 
@@ -65,12 +168,33 @@ class ICurve
         virtual void AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor) = 0;
         virtual void InsertAnchor(std::array<float, 2> point, int32_t index) = 0;
         virtual void RemoveAnchor(int32_t index) = 0;
-        virtual std::vector<std::array<float, 2>> Data() = 0;
+        virtual void BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles = {}) = 0;
+        virtual const std::vector<std::array<float, 2>> & Data() = 0;
+        virtual const PointArrays & DataArrays() = 0;
+        virtual const SegmentBlocks & SegmentControlBlocks() = 0;
         virtual void CloseLoop(bool close_loop) = 0;
         virtual std::pair<std::array<float, 2>, uint32_t> IntersectionOnCurve(std::array<float, 2> position) = 0;
-        virtual const std::vector<std::array<float, 2>> & GetPointData() = 0;
+        virtual CurveIntersection NearestPointOnCurve(std::array<float, 2> position) = 0;
+        virtual float Length() = 0;
+        virtual CurveLocation TAtDistance(float distance) = 0;
+        virtual void SampleAtDistances(std::span<const float> distances, const PathSamples & out) = 0;
+        virtual void SampleAtParameters(std::span<const float> parameters, const PathSamples & out) = 0;
+        virtual const PointList & GetPointData() = 0;
+        virtual void PointsInRadius(std::array<float, 2> position, float radius, std::vector<uint32_t> & out) = 0;
+        virtual int32_t NearestPoint(std::array<float, 2> position, float max_distance) = 0;
         virtual const std::vector<std::array<float, 2>> & HandleData() = 0;
+        virtual bool EditsSince(uint64_t generation, std::vector<SampleEdit> & edits) = 0;
+        virtual void CopyData(size_t first_sample, size_t n_samples, float * out, size_t stride) = 0;
+        virtual void CopyHandleData(size_t first_handle, size_t n_handles, float * out, size_t stride) = 0;
         virtual void ForceInterpolation() = 0;
+        virtual TessellationStats GetTessellationStats() = 0;
+        virtual const std::vector<CurveBounds> & SegmentBounds() = 0;
+        virtual const std::vector<size_t> & SegmentOffsets() = 0;
+        virtual const CurveBvh & SegmentTree() = 0;
+        virtual CurveBounds Bounds() = 0;
+        virtual uint64_t Generation() = 0;
+        virtual uint64_t DataEpoch() = 0;
+        virtual bool HasChangedSince(uint64_t generation) = 0;
         virtual CURVE_TYPE CurveType() = 0;
         virtual CURVE_TYPE WorkCurveType() = 0;
 };
@@ -0,0 +1,805 @@
+#include "CurveArcLength.h"
+#include "CurveKernel.h"
+#include "Bezier.h"
+
+#include <bit>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define ARC_LENGTH_X86 1
+#include <immintrin.h>
+#else
+#define ARC_LENGTH_X86 0
+#endif
+
+// the avx2 path is compiled with a target attribute like the curve kernels, the rest of the file keeps the baseline
+#if ARC_LENGTH_X86 && (defined(__GNUC__) || defined(__clang__))
+#define ARC_LENGTH_AVX2 1
+#define ARC_LENGTH_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ARC_LENGTH_AVX2 0
+#define ARC_LENGTH_TARGET(isa)
+#endif
+
+static_assert(sizeof(SegmentControls) == (8 * sizeof(float)), "the batch queries load the control points of a segment as 8 floats");
+
+namespace
+{
+    // 5 point gauss-legendre quadrature on [-1, 1]. exact for polynomials up to degree 9, the speed of a cubic is the
+    // square root of a quartic which is smooth enough over a lookup table interval to be measured to float precision
+    constexpr std::array<double, 5> gaussNodes = {0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640};
+    constexpr std::array<double, 5> gaussWeights = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891};
+
+    constexpr uint32_t newtonIterations = 3; // refinement steps of TAtLength after the lookup table guess
+
+    float speed(const SegmentControls & segment, float t)
+    {
+        std::array<float, 2> derivative = curve_arc_length::Derivative(segment, t);
+        return std::sqrt((derivative[0] * derivative[0]) + (derivative[1] * derivative[1]));
+    }
+
+    // speed of a segment of any degree: the point of its hodograph at t
+    float speedHodograph(std::span<const std::array<float, 2>> hodograph, float t)
+    {
+        const std::array<float, 2> derivative = bezier::DeCasteljau<float>(hodograph, t);
+        return std::sqrt((derivative[0] * derivative[0]) + (derivative[1] * derivative[1]));
+    }
+
+    // the derivative of the segment as a bezier of one degree lower written to out
+    std::span<const std::array<float, 2>> hodograph(std::span<const std::array<float, 2>> points, bezier::RuntimePoints<float> & out)
+    {
+        const size_t degree = points.size() - 1;
+        for (size_t i=0; i<degree; i++)
+        {
+            out[i] = {static_cast<float>(degree) * (points[i + 1][0] - points[i][0]), static_cast<float>(degree) * (points[i + 1][1] - points[i][1])};
+        }
+
+        return std::span<const std::array<float, 2>>(out.data(), std::max<size_t>(degree, 1));
+    }
+
+    // length between t0 and t1 of a segment whose speed at t is speed_at(t)
+    template<typename Speed>
+    float gaussLength(float t0, float t1, Speed && speed_at)
+    {
+        const double half = (static_cast<double>(t1) - t0) * 0.5;
+        const double mid = (static_cast<double>(t1) + t0) * 0.5;
+
+        double length = 0.0;
+        for (size_t i=0; i<gaussNodes.size(); i++)
+        {
+            length += gaussWeights[i] * speed_at(static_cast<float>(mid + (half * gaussNodes[i])));
+        }
+
+        return static_cast<float>(length * half);
+    }
+
+    template<typename Speed>
+    void measureLut(float * lut, Speed && speed_at)
+    {
+        constexpr float step = 1.0f / static_cast<float>(curve_arc_length::lutSize);
+
+        double length = 0.0;
+        for (size_t i=0; i<curve_arc_length::lutSize; i++)
+        {
+            length += gaussLength(static_cast<float>(i) * step, static_cast<float>(i + 1) * step, speed_at);
+            lut[i] = static_cast<float>(length);
+        }
+    }
+
+    template<typename Speed>
+    float tAtLength(const float * lut, float length, Speed && speed_at)
+    {
+        constexpr float step = 1.0f / static_cast<float>(curve_arc_length::lutSize);
+
+        if (length <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        if (length >= lut[curve_arc_length::lutSize - 1])
+        {
+            return 1.0f;
+        }
+
+        // interval of the lookup table length is in, then a linear guess inside it
+        const size_t interval = static_cast<size_t>(std::upper_bound(lut, lut + (curve_arc_length::lutSize - 1), length) - lut);
+        const float t0 = static_cast<float>(interval) * step;
+        const float t1 = t0 + step;
+        const float length0 = (interval > 0) ? lut[interval - 1] : 0.0f;
+        const float length1 = lut[interval];
+
+        float t = t0;
+        if (length1 > length0)
+        {
+            t += step * ((length - length0) / (length1 - length0));
+        }
+
+        // newton's method on length0 + Length(t0, t) - length, whose derivative is the speed at t
+        for (uint32_t i=0; i<newtonIterations; i++)
+        {
+            const float segment_speed = speed_at(t);
+            if (segment_speed <= 0.0f)
+            {
+                break;
+            }
+
+            const float error = (length0 + gaussLength(t0, t, speed_at)) - length;
+            t = std::clamp(t - (error / segment_speed), t0, t1);
+        }
+
+        return t;
+    }
+
+    constexpr float intervalStep = 1.0f / static_cast<float>(curve_arc_length::lutSize); // parameter range of a lookup table interval
+    constexpr float minSlopeDivisor = 1e-30f; // keeps the hermite slopes finite on zero length intervals
+    constexpr float minTangentLength = 1e-12f; // squared derivatives below this use the chord of the segment as tangent
+
+    // queries located on the calling thread, evaluated together
+    struct alignas(32) QueryBlock
+    {
+        uint32_t segment[curve_arc_length::batchWidth];
+        float t0[curve_arc_length::batchWidth]; // parameter of a parameter query, start of the lookup table interval of a distance query
+        float w[curve_arc_length::batchWidth]; // distance into the interval as a fraction of its length (distance queries)
+        float ds[curve_arc_length::batchWidth]; // length of the interval (distance queries)
+    };
+
+    // parameter at fraction w of the length of the interval starting at t0: cubic hermite interpolation of the inverse
+    // of the length, whose slopes at the ends are the interval length over the speed. slopes up to 3 keep it monotone
+    float hermiteT(const SegmentControls & segment, float t0, float w, float ds)
+    {
+        const float v0 = speed(segment, t0) * intervalStep;
+        const float v1 = speed(segment, t0 + intervalStep) * intervalStep;
+        const float m0 = ds / std::max(std::max(v0, ds * (1.0f / 3.0f)), minSlopeDivisor);
+        const float m1 = ds / std::max(std::max(v1, ds * (1.0f / 3.0f)), minSlopeDivisor);
+
+        const float w2 = w * w;
+        const float w3 = w2 * w;
+        const float h = (((3.0f * w2) - (2.0f * w3)) + (m0 * ((w3 - (2.0f * w2)) + w))) + (m1 * (w3 - w2));
+
+        return t0 + (intervalStep * h);
+    }
+
+    void writeSample(const SegmentControls & segment, float t, const PathSamples & out, size_t index)
+    {
+        const std::array<float, 2> position = curve_arc_length::Evaluate(segment, t);
+        out.x[index] = position[0];
+        out.y[index] = position[1];
+
+        if (out.tangentX)
+        {
+            std::array<float, 2> tangent = curve_arc_length::Derivative(segment, t);
+            float length_sqr = (tangent[0] * tangent[0]) + (tangent[1] * tangent[1]);
+
+            // the derivative vanishes where a handle sits on its anchor
+            if (length_sqr <= minTangentLength)
+            {
+                tangent = {segment[3][0] - segment[0][0], segment[3][1] - segment[0][1]};
+                length_sqr = (tangent[0] * tangent[0]) + (tangent[1] * tangent[1]);
+            }
+
+            const float inv_length = (length_sqr > 0.0f) ? (1.0f / std::sqrt(length_sqr)) : 0.0f;
+            out.tangentX[index] = tangent[0] * inv_length;
+            out.tangentY[index] = tangent[1] * inv_length;
+        }
+    }
+
+    template<bool IsDistance>
+    void sampleBlockScalar(const SegmentControls * segments, const QueryBlock & block, size_t n_queries, const PathSamples & out, size_t first_query)
+    {
+        for (size_t i=0; i<n_queries; i++)
+        {
+            const SegmentControls & segment = segments[block.segment[i]];
+            float t = block.t0[i];
+
+            if constexpr (IsDistance)
+            {
+                t = hermiteT(segment, block.t0[i], block.w[i], block.ds[i]);
+            }
+
+            writeSample(segment, t, out, first_query + i);
+        }
+    }
+
+#if ARC_LENGTH_AVX2
+    // control points of the segments of a block, one lane per query
+    struct SegmentLanes
+    {
+        __m256 x[4];
+        __m256 y[4];
+    };
+
+    // the same operations in the same order as curve_arc_length::Derivative
+    ARC_LENGTH_TARGET("avx2")
+    void derivativeAvx2(const SegmentLanes & lanes, __m256 t, __m256 & x, __m256 & y)
+    {
+        const __m256 u = _mm256_sub_ps(_mm256_set1_ps(1.0f), t);
+        const __m256 w0 = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), u), u);
+        const __m256 w1 = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(6.0f), u), t);
+        const __m256 w2 = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), t), t);
+
+        x = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w0, _mm256_sub_ps(lanes.x[1], lanes.x[0])), _mm256_mul_ps(w1, _mm256_sub_ps(lanes.x[2], lanes.x[1]))), _mm256_mul_ps(w2, _mm256_sub_ps(lanes.x[3], lanes.x[2])));
+        y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w0, _mm256_sub_ps(lanes.y[1], lanes.y[0])), _mm256_mul_ps(w1, _mm256_sub_ps(lanes.y[2], lanes.y[1]))), _mm256_mul_ps(w2, _mm256_sub_ps(lanes.y[3], lanes.y[2])));
+    }
+
+    ARC_LENGTH_TARGET("avx2")
+    __m256 speedAvx2(const SegmentLanes & lanes, __m256 t)
+    {
+        __m256 x;
+        __m256 y;
+        derivativeAvx2(lanes, t, x, y);
+        return _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+    }
+
+    // a full block: the 8 floats of the segment of every query are one load, transposed to a lane per query. then every
+    // step is the scalar one for 8 queries at a time
+    template<bool IsDistance>
+    ARC_LENGTH_TARGET("avx2")
+    void sampleBlockAvx2(const SegmentControls * segments, const QueryBlock & block, const PathSamples & out, size_t first_query)
+    {
+        __m256 rows[curve_arc_length::batchWidth];
+        for (size_t i=0; i<curve_arc_length::batchWidth; i++)
+        {
+            rows[i] = _mm256_loadu_ps(segments[block.segment[i]][0].data());
+        }
+
+        // 8x8 transpose: row i is [x0 y0 x1 y1 x2 y2 x3 y3] of query i
+        const __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+        const __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+        const __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+        const __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+        const __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+        const __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+        const __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+        const __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+        const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+        SegmentLanes lanes;
+        lanes.x[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        lanes.y[0] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        lanes.x[1] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        lanes.y[1] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        lanes.x[2] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        lanes.y[2] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        lanes.x[3] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        lanes.y[3] = _mm256_permute2f128_ps(s3, s7, 0x31);
+
+        __m256 t = _mm256_load_ps(block.t0);
+
+        if constexpr (IsDistance)
+        {
+            const __m256 step = _mm256_set1_ps(intervalStep);
+            const __m256 w = _mm256_load_ps(block.w);
+            const __m256 ds = _mm256_load_ps(block.ds);
+            const __m256 min_slope = _mm256_max_ps(_mm256_mul_ps(ds, _mm256_set1_ps(1.0f / 3.0f)), _mm256_set1_ps(minSlopeDivisor));
+
+            const __m256 v0 = _mm256_mul_ps(speedAvx2(lanes, t), step);
+            const __m256 v1 = _mm256_mul_ps(speedAvx2(lanes, _mm256_add_ps(t, step)), step);
+            const __m256 m0 = _mm256_div_ps(ds, _mm256_max_ps(v0, min_slope));
+            const __m256 m1 = _mm256_div_ps(ds, _mm256_max_ps(v1, min_slope));
+
+            const __m256 w2 = _mm256_mul_ps(w, w);
+            const __m256 w3 = _mm256_mul_ps(w2, w);
+            const __m256 h00 = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), w2), _mm256_mul_ps(_mm256_set1_ps(2.0f), w3));
+            const __m256 h10 = _mm256_add_ps(_mm256_sub_ps(w3, _mm256_mul_ps(_mm256_set1_ps(2.0f), w2)), w);
+            const __m256 h11 = _mm256_sub_ps(w3, w2);
+            const __m256 h = _mm256_add_ps(_mm256_add_ps(h00, _mm256_mul_ps(m0, h10)), _mm256_mul_ps(m1, h11));
+
+            t = _mm256_add_ps(t, _mm256_mul_ps(step, h));
+        }
+
+        // same order as curve_arc_length::Evaluate
+        const __m256 u = _mm256_sub_ps(_mm256_set1_ps(1.0f), t);
+        const __m256 b0 = _mm256_mul_ps(_mm256_mul_ps(u, u), u);
+        const __m256 b1 = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), u), u), t);
+        const __m256 b2 = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), u), t), t);
+        const __m256 b3 = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+
+        const __m256 x = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b0, lanes.x[0]), _mm256_mul_ps(b1, lanes.x[1])), _mm256_mul_ps(b2, lanes.x[2])), _mm256_mul_ps(b3, lanes.x[3]));
+        const __m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b0, lanes.y[0]), _mm256_mul_ps(b1, lanes.y[1])), _mm256_mul_ps(b2, lanes.y[2])), _mm256_mul_ps(b3, lanes.y[3]));
+        _mm256_storeu_ps(out.x + first_query, x);
+        _mm256_storeu_ps(out.y + first_query, y);
+
+        if (out.tangentX)
+        {
+            __m256 tangent_x;
+            __m256 tangent_y;
+            derivativeAvx2(lanes, t, tangent_x, tangent_y);
+            __m256 length_sqr = _mm256_add_ps(_mm256_mul_ps(tangent_x, tangent_x), _mm256_mul_ps(tangent_y, tangent_y));
+
+            // the chord of the segment where the derivative vanishes
+            const __m256 use_chord = _mm256_cmp_ps(length_sqr, _mm256_set1_ps(minTangentLength), _CMP_LE_OQ);
+            const __m256 chord_x = _mm256_sub_ps(lanes.x[3], lanes.x[0]);
+            const __m256 chord_y = _mm256_sub_ps(lanes.y[3], lanes.y[0]);
+            tangent_x = _mm256_blendv_ps(tangent_x, chord_x, use_chord);
+            tangent_y = _mm256_blendv_ps(tangent_y, chord_y, use_chord);
+            length_sqr = _mm256_blendv_ps(length_sqr, _mm256_add_ps(_mm256_mul_ps(chord_x, chord_x), _mm256_mul_ps(chord_y, chord_y)), use_chord);
+
+            const __m256 is_nonzero = _mm256_cmp_ps(length_sqr, _mm256_setzero_ps(), _CMP_GT_OQ);
+            const __m256 inv_length = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(length_sqr)), is_nonzero);
+            _mm256_storeu_ps(out.tangentX + first_query, _mm256_mul_ps(tangent_x, inv_length));
+            _mm256_storeu_ps(out.tangentY + first_query, _mm256_mul_ps(tangent_y, inv_length));
+        }
+    }
+#endif
+
+    // locate every query of [first_query, first_query + n_queries) with locate(query, block, lane) a block at a time
+    // and evaluate the block
+    template<bool IsDistance, typename Locate>
+    void sampleRange(const SegmentControls * segments, size_t first_query, size_t n_queries, const PathSamples & out, Locate && locate)
+    {
+#if ARC_LENGTH_AVX2
+        const bool use_avx2 = curve_kernel::ActiveIsa() >= KERNEL_ISA::AVX2;
+#endif
+
+        QueryBlock block;
+        const size_t end_query = first_query + n_queries;
+
+        for (size_t i=first_query; i<end_query; i+=curve_arc_length::batchWidth)
+        {
+            const size_t n_block = std::min(curve_arc_length::batchWidth, end_query - i);
+            for (size_t lane=0; lane<n_block; lane++)
+            {
+                locate(i + lane, block, lane);
+            }
+
+#if ARC_LENGTH_AVX2
+            if (use_avx2 && (n_block == curve_arc_length::batchWidth))
+            {
+                sampleBlockAvx2<IsDistance>(segments, block, out, i);
+                continue;
+            }
+#endif
+
+            sampleBlockScalar<IsDistance>(segments, block, n_block, out, i);
+        }
+    }
+
+    // run sample_range(first_query, n_queries) over all queries: on the calling thread, or in chunks of whole blocks
+    // on up to one thread per core when there are at least minThreadQueries per thread
+    template<typename SampleRange>
+    void runBatch(size_t n_queries, SampleRange && sample_range)
+    {
+        const size_t n_cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t n_threads = std::clamp<size_t>(n_queries / curve_arc_length::minThreadQueries, 1, n_cores);
+
+        if (n_threads == 1)
+        {
+            sample_range(0, n_queries);
+            return;
+        }
+
+        const size_t n_blocks = (n_queries + curve_arc_length::batchWidth - 1) / curve_arc_length::batchWidth;
+        const size_t chunk_size = ((n_blocks + n_threads - 1) / n_threads) * curve_arc_length::batchWidth;
+
+        std::vector<std::thread> workers;
+        workers.reserve(n_threads - 1);
+
+        for (size_t first=chunk_size; first<n_queries; first+=chunk_size)
+        {
+            workers.emplace_back([&sample_range, first, n_queries, chunk_size](){ sample_range(first, std::min(chunk_size, n_queries - first)); });
+        }
+
+        sample_range(0, std::min(chunk_size, n_queries));
+
+        for (std::thread & worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // interval of a segment lookup table length is in: the number of entries at or below it (the last entry, the
+    // length of the segment, only counts for the last interval), compared 4 at a time without branches
+    size_t lutInterval(const float * lut, float length)
+    {
+        static_assert((curve_arc_length::lutSize % 4) == 0);
+
+#if ARC_LENGTH_X86
+        const __m128 value = _mm_set1_ps(length);
+        uint32_t mask = 0;
+
+        for (size_t i=0; i<curve_arc_length::lutSize; i+=4)
+        {
+            mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(lut + i), value))) << i;
+        }
+
+        const size_t n_below = static_cast<size_t>(std::popcount(mask));
+#else
+        size_t n_below = 0;
+        for (size_t i=0; i<curve_arc_length::lutSize; i++)
+        {
+            n_below += (lut[i] <= length) ? 1 : 0;
+        }
+#endif
+
+        return std::min(n_below, curve_arc_length::lutSize - 1);
+    }
+
+    void writeZeros(const PathSamples & out, size_t n_queries)
+    {
+        std::fill_n(out.x, n_queries, 0.0f);
+        std::fill_n(out.y, n_queries, 0.0f);
+
+        if (out.tangentX)
+        {
+            std::fill_n(out.tangentX, n_queries, 0.0f);
+            std::fill_n(out.tangentY, n_queries, 0.0f);
+        }
+    }
+
+    // last segment starting at or before distance. hint is a segment at or just before it, so the search gallops
+    // forward from hint (a binary search over the segments before it if distance is before hint after all)
+    size_t findSegment(const double * segment_starts, size_t n_segments, double distance, size_t hint)
+    {
+        size_t low = 0; // the segment is in [low, high)
+        size_t high = hint;
+
+        if (distance >= segment_starts[hint])
+        {
+            low = hint;
+            high = hint + 1;
+
+            for (size_t step=1; (high < n_segments) && (segment_starts[high] <= distance); step*=2)
+            {
+                low = high;
+                high = std::min(n_segments, high + step);
+            }
+        }
+
+        return static_cast<size_t>(std::upper_bound(segment_starts + low + 1, segment_starts + high, distance) - (segment_starts + 1));
+    }
+}
+
+namespace curve_arc_length
+{
+    SegmentControls FromLinear(const std::array<float, 2> & a, const std::array<float, 2> & b)
+    {
+        // control points at a third and two thirds of the line keep the speed constant
+        return {a, {a[0] + ((b[0] - a[0]) / 3.0f), a[1] + ((b[1] - a[1]) / 3.0f)}, {b[0] + ((a[0] - b[0]) / 3.0f), b[1] + ((a[1] - b[1]) / 3.0f)}, b};
+    }
+
+    SegmentControls FromQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c)
+    {
+        // degree elevation: the inner control points are 2/3 of the way from the end points to the quadratic control point
+        return {a, {a[0] + ((2.0f / 3.0f) * (b[0] - a[0])), a[1] + ((2.0f / 3.0f) * (b[1] - a[1]))}, {c[0] + ((2.0f / 3.0f) * (b[0] - c[0])), c[1] + ((2.0f / 3.0f) * (b[1] - c[1]))}, c};
+    }
+
+    std::array<float, 2> Evaluate(const SegmentControls & segment, float t)
+    {
+        const float u = 1.0f - t;
+        const float w0 = u * u * u;
+        const float w1 = 3.0f * u * u * t;
+        const float w2 = 3.0f * u * t * t;
+        const float w3 = t * t * t;
+
+        return {(w0 * segment[0][0]) + (w1 * segment[1][0]) + (w2 * segment[2][0]) + (w3 * segment[3][0]),
+                (w0 * segment[0][1]) + (w1 * segment[1][1]) + (w2 * segment[2][1]) + (w3 * segment[3][1])};
+    }
+
+    std::array<float, 2> Derivative(const SegmentControls & segment, float t)
+    {
+        const float u = 1.0f - t;
+        const float w0 = 3.0f * u * u;
+        const float w1 = 6.0f * u * t;
+        const float w2 = 3.0f * t * t;
+
+        return {(w0 * (segment[1][0] - segment[0][0])) + (w1 * (segment[2][0] - segment[1][0])) + (w2 * (segment[3][0] - segment[2][0])),
+                (w0 * (segment[1][1] - segment[0][1])) + (w1 * (segment[2][1] - segment[1][1])) + (w2 * (segment[3][1] - segment[2][1]))};
+    }
+
+    float Length(const SegmentControls & segment, float t0, float t1)
+    {
+        return gaussLength(t0, t1, [&segment](float t){ return speed(segment, t); });
+    }
+
+    void Measure(const SegmentControls & segment, float * lut)
+    {
+        measureLut(lut, [&segment](float t){ return speed(segment, t); });
+    }
+
+    float TAtLength(const SegmentControls & segment, const float * lut, float length)
+    {
+        return tAtLength(lut, length, [&segment](float t){ return speed(segment, t); });
+    }
+
+    float LengthBezier(std::span<const std::array<float, 2>> points, float t0, float t1)
+    {
+        bezier::RuntimePoints<float> derivative = {};
+        const std::span<const std::array<float, 2>> h = hodograph(points, derivative);
+        return gaussLength(t0, t1, [h](float t){ return speedHodograph(h, t); });
+    }
+
+    void MeasureBezier(std::span<const std::array<float, 2>> points, float * lut)
+    {
+        bezier::RuntimePoints<float> derivative = {};
+        const std::span<const std::array<float, 2>> h = hodograph(points, derivative);
+        measureLut(lut, [h](float t){ return speedHodograph(h, t); });
+    }
+
+    float TAtLengthBezier(std::span<const std::array<float, 2>> points, const float * lut, float length)
+    {
+        bezier::RuntimePoints<float> derivative = {};
+        const std::span<const std::array<float, 2>> h = hodograph(points, derivative);
+        return tAtLength(lut, length, [h](float t){ return speedHodograph(h, t); });
+    }
+
+    void SampleEvenly(const SegmentControls & segment, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        std::array<float, lutSize> lut;
+        Measure(segment, lut.data());
+
+        const float step_length = lut[lutSize - 1] / static_cast<float>(n_steps);
+
+        out[0] = segment[0];
+        for (uint32_t i=1; i<n_steps; i++)
+        {
+            out[i] = Evaluate(segment, TAtLength(segment, lut.data(), static_cast<float>(i) * step_length));
+        }
+        out[n_steps] = segment[3];
+    }
+
+    void SampleAtParameters(const std::vector<SegmentControls> & segments, std::span<const float> parameters, const PathSamples & out)
+    {
+        if (segments.empty())
+        {
+            writeZeros(out, parameters.size());
+            return;
+        }
+
+        const size_t n_segments = segments.size();
+
+        runBatch(parameters.size(), [&](size_t first_query, size_t n_queries)
+        {
+            sampleRange<false>(segments.data(), first_query, n_queries, out, [&](size_t query, QueryBlock & block, size_t lane)
+            {
+                const double curve_t = std::min(std::max(0.0, static_cast<double>(parameters[query])), 1.0) * static_cast<double>(n_segments); // nan as 0
+                const size_t segment = std::min(static_cast<size_t>(curve_t), n_segments - 1);
+
+                block.segment[lane] = static_cast<uint32_t>(segment);
+                block.t0[lane] = static_cast<float>(curve_t - static_cast<double>(segment));
+            });
+        });
+    }
+}
+
+void ArcLengthTable::update(size_t n_segments, const MeasureSegment & measure)
+{
+    if ((firstChanged < n_segments) || (isMeasured.size() != n_segments))
+    {
+        isLookupValid = false;
+    }
+
+    // only the end of the curve can be added or dropped without a splice (the closing segment)
+    if (isMeasured.size() != n_segments)
+    {
+        firstChanged = std::min(firstChanged, std::min(isMeasured.size(), n_segments));
+        lengths.resize(n_segments * curve_arc_length::lutSize);
+        isMeasured.resize(n_segments, 0);
+    }
+
+    if (segmentStarts.size() != (n_segments + 1))
+    {
+        segmentStarts.resize(n_segments + 1);
+        segmentStarts[0] = 0.0;
+    }
+
+    for (size_t i=firstChanged; i<n_segments; i++)
+    {
+        float * lut = lengths.data() + (i * curve_arc_length::lutSize);
+
+        if (!isMeasured[i])
+        {
+            measure(i, lut);
+            isMeasured[i] = 1;
+        }
+
+        segmentStarts[i + 1] = segmentStarts[i] + lut[curve_arc_length::lutSize - 1];
+    }
+
+    firstChanged = n_segments;
+}
+
+void ArcLengthTable::update(const std::vector<SegmentControls> & segments)
+{
+    update(segments.size(), [&segments](size_t segment, float * lut){ curve_arc_length::Measure(segments[segment], lut); });
+}
+
+void ArcLengthTable::buildLookup()
+{
+    // one bucket per segment, so a query is usually in the segment its bucket points at or the next one
+    const size_t n_buckets = isMeasured.size();
+    const double length = segmentStarts.back();
+    lookupScale = (length > 0.0) ? (static_cast<double>(n_buckets) / length) : 0.0;
+    distanceLookup.resize(n_buckets);
+
+    size_t segment = 0;
+    for (size_t i=0; i<n_buckets; i++)
+    {
+        const double bucket_start = (lookupScale > 0.0) ? (static_cast<double>(i) / lookupScale) : 0.0;
+        while (((segment + 1) < n_buckets) && (segmentStarts[segment + 1] <= bucket_start))
+        {
+            segment++;
+        }
+
+        distanceLookup[i] = static_cast<uint32_t>(segment);
+    }
+
+    isLookupValid = true;
+}
+
+void ArcLengthTable::Clear()
+{
+    lengths.clear();
+    isMeasured.clear();
+    segmentStarts.clear();
+    firstChanged = 0;
+}
+
+void ArcLengthTable::Splice(size_t first_segment, size_t old_count, size_t new_count)
+{
+    if ((first_segment + old_count) > isMeasured.size())
+    {
+        Clear(); // the table doesn't have the segments the edit replaces (nothing was measured since they were generated)
+        return;
+    }
+
+    firstChanged = std::min(firstChanged, first_segment);
+
+    // a drag replaces segments 1:1, they only need to be measured again
+    const size_t n_common = std::min(old_count, new_count);
+    std::fill_n(isMeasured.begin() + static_cast<std::ptrdiff_t>(first_segment), n_common, 0);
+
+    const size_t first_extra = first_segment + n_common;
+    if (old_count > new_count)
+    {
+        isMeasured.erase(isMeasured.begin() + static_cast<std::ptrdiff_t>(first_extra), isMeasured.begin() + static_cast<std::ptrdiff_t>(first_segment + old_count));
+        lengths.erase(lengths.begin() + static_cast<std::ptrdiff_t>(first_extra * curve_arc_length::lutSize), lengths.begin() + static_cast<std::ptrdiff_t>((first_segment + old_count) * curve_arc_length::lutSize));
+    }
+    else if (new_count > old_count)
+    {
+        isMeasured.insert(isMeasured.begin() + static_cast<std::ptrdiff_t>(first_extra), new_count - old_count, 0);
+        lengths.insert(lengths.begin() + static_cast<std::ptrdiff_t>(first_extra * curve_arc_length::lutSize), (new_count - old_count) * curve_arc_length::lutSize, 0.0f);
+    }
+}
+
+void ArcLengthTable::Invalidate(size_t first_segment, size_t n_segments)
+{
+    if (first_segment >= isMeasured.size())
+    {
+        return; // not in the table yet, measured when it is added
+    }
+
+    firstChanged = std::min(firstChanged, first_segment);
+    std::fill_n(isMeasured.begin() + static_cast<std::ptrdiff_t>(first_segment), std::min(n_segments, isMeasured.size() - first_segment), 0);
+}
+
+double ArcLengthTable::Length(const std::vector<SegmentControls> & segments)
+{
+    update(segments);
+    return segmentStarts.back();
+}
+
+CurveLocation ArcLengthTable::Locate(const std::vector<SegmentControls> & segments, double distance)
+{
+    CurveLocation location;
+
+    const SegmentDistance found = Find(segments.size(), [&segments](size_t segment, float * lut){ curve_arc_length::Measure(segments[segment], lut); }, distance);
+    if (!found.lut)
+    {
+        return location;
+    }
+
+    const SegmentControls & controls = segments[found.segment];
+
+    location.found = true;
+    location.segment = found.segment;
+    location.t = curve_arc_length::TAtLength(controls, found.lut, found.length);
+    location.position = curve_arc_length::Evaluate(controls, location.t);
+
+    return location;
+}
+
+void ArcLengthTable::SampleAtDistances(const std::vector<SegmentControls> & segments, std::span<const float> distances, const PathSamples & out)
+{
+    update(segments);
+    if (segments.empty())
+    {
+        writeZeros(out, distances.size());
+        return;
+    }
+
+    if (!isLookupValid)
+    {
+        buildLookup();
+    }
+
+    // the table is only read from here on, the threads share it
+    const size_t n_segments = segments.size();
+    const double * segment_starts = segmentStarts.data();
+    const float * luts = lengths.data();
+
+    runBatch(distances.size(), [&](size_t first_query, size_t n_queries)
+    {
+        sampleRange<true>(segments.data(), first_query, n_queries, out, [&](size_t query, QueryBlock & block, size_t lane)
+        {
+            const double distance = std::min(std::max(0.0, static_cast<double>(distances[query])), segment_starts[n_segments]); // nan as 0
+            const size_t bucket = std::min(static_cast<size_t>(distance * lookupScale), n_segments - 1);
+            const size_t segment = findSegment(segment_starts, n_segments, distance, distanceLookup[bucket]);
+
+            const float * lut = luts + (segment * curve_arc_length::lutSize);
+            const float length = static_cast<float>(distance - segment_starts[segment]);
+            const size_t interval = lutInterval(lut, length);
+
+            const float length0 = (interval > 0) ? lut[interval - 1] : 0.0f;
+            const float ds = lut[interval] - length0;
+
+            block.segment[lane] = static_cast<uint32_t>(segment);
+            block.t0[lane] = static_cast<float>(interval) * intervalStep;
+            block.w[lane] = (ds > 0.0f) ? std::clamp((length - length0) / ds, 0.0f, 1.0f) : 0.0f;
+            block.ds[lane] = ds;
+        });
+    });
+}
+
+double ArcLengthTable::Length(size_t n_segments, const MeasureSegment & measure)
+{
+    update(n_segments, measure);
+    return segmentStarts.back();
+}
+
+ArcLengthTable::SegmentDistance ArcLengthTable::Find(size_t n_segments, const MeasureSegment & measure, double distance)
+{
+    SegmentDistance found;
+
+    update(n_segments, measure);
+    if (n_segments == 0)
+    {
+        return found;
+    }
+
+    distance = std::clamp(distance, 0.0, segmentStarts.back());
+
+    // last segment that starts at or before distance
+    const auto segment_start = std::upper_bound(segmentStarts.begin() + 1, segmentStarts.begin() + static_cast<std::ptrdiff_t>(n_segments), distance);
+
+    found.segment = static_cast<size_t>(segment_start - (segmentStarts.begin() + 1));
+    found.length = static_cast<float>(distance - segmentStarts[found.segment]);
+    found.lut = lengths.data() + (found.segment * curve_arc_length::lutSize);
+
+    return found;
+}
+
+void ArcLengthTable::Find(size_t n_segments, const MeasureSegment & measure, std::span<const float> distances, SegmentDistance * out)
+{
+    update(n_segments, measure);
+    if (n_segments == 0)
+    {
+        std::fill_n(out, distances.size(), SegmentDistance());
+        return;
+    }
+
+    if (!isLookupValid)
+    {
+        buildLookup();
+    }
+
+    for (size_t i=0; i<distances.size(); i++)
+    {
+        const double distance = std::min(std::max(0.0, static_cast<double>(distances[i])), segmentStarts[n_segments]); // nan as 0
+        const size_t bucket = std::min(static_cast<size_t>(distance * lookupScale), n_segments - 1);
+        const size_t segment = findSegment(segmentStarts.data(), n_segments, distance, distanceLookup[bucket]);
+
+        out[i].segment = segment;
+        out[i].length = static_cast<float>(distance - segmentStarts[segment]);
+        out[i].lut = lengths.data() + (segment * curve_arc_length::lutSize);
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Curve.h"
+
+#include <span>
+#include <array>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+// control points of a generated segment as a cubic bezier. linear and quadratic segments are raised to cubics exactly,
+// so the segments of every curve class are measured the same way
+using SegmentControls = std::array<std::array<float, 2>, 4>;
+
+namespace curve_arc_length
+{
+    constexpr size_t lutSize = 16; // lengths measured per segment, at t = 1/lutSize, 2/lutSize ... 1
+
+    SegmentControls FromLinear(const std::array<float, 2> & a, const std::array<float, 2> & b);
+    SegmentControls FromQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c);
+
+    std::array<float, 2> Evaluate(const SegmentControls & segment, float t);
+    std::array<float, 2> Derivative(const SegmentControls & segment, float t);
+
+    float Length(const SegmentControls & segment, float t0, float t1); // length of the segment between t0 and t1 (5 point gauss-legendre quadrature)
+    void Measure(const SegmentControls & segment, float * lut); // write the lutSize lengths from the start of the segment to lut (the last one is the length of the segment)
+    float TAtLength(const SegmentControls & segment, const float * lut, float length); // parameter at length from the start of the segment: the interval of lut it is in, refined with newton's method
+
+    // the same for a segment of any degree up to bezier::maxDegree (BezierCurve, whose segments above cubics aren't
+    // measured on their reduced cubic), with the speed from the hodograph of the segment
+    float LengthBezier(std::span<const std::array<float, 2>> points, float t0, float t1);
+    void MeasureBezier(std::span<const std::array<float, 2>> points, float * lut);
+    float TAtLengthBezier(std::span<const std::array<float, 2>> points, const float * lut, float length);
+
+    // write n_steps + 1 points of the segment to out that are equally far apart along the segment (instead of in t)
+    void SampleEvenly(const SegmentControls & segment, uint32_t n_steps, std::array<float, 2> * out);
+
+    // batch path queries: a few segment lookups per query on the calling thread, then the segments are evaluated 8
+    // queries at a time with avx2 (a transpose of their control points), large batches split across threads
+    constexpr size_t batchWidth = 8; // queries evaluated together
+    constexpr size_t minThreadQueries = 1 << 16; // queries per thread below which a batch isn't split
+
+    // position and unit tangent at parameters 0..1 over the whole curve, every segment covering an equal share.
+    // zeros if there are no segments
+    void SampleAtParameters(const std::vector<SegmentControls> & segments, std::span<const float> parameters, const PathSamples & out);
+}
+
+// arc length of the generated segments of a curve: a lookup table of lengths per segment (curve_arc_length::Measure)
+// and their prefix sum, the distance along the curve to the start of every segment. like CurveBvh the table doesn't
+// own the segments, the curve classes pass them to every query. nothing is measured until a query needs it: segments
+// spliced in or invalidated by an edit are measured again, the others keep their lookup tables and the prefix sum is
+// redone from the first changed segment. a query is a binary search over the prefix sum and then over the lookup
+// table of the segment it lands on
+class ArcLengthTable
+{
+    private:
+        std::vector<float> lengths; // lutSize lengths per segment
+        std::vector<uint8_t> isMeasured; // 1 if the lengths of the segment are up to date
+        std::vector<double> segmentStarts; // distance along the curve to the start of every segment followed by the length of the curve
+        size_t firstChanged = 0; // first segment whose entry in segmentStarts is out of date
+        std::vector<uint32_t> distanceLookup; // segment at the start of every bucket of distances (equal length buckets, one per segment)
+        double lookupScale = 0.0; // buckets per unit of distance
+        bool isLookupValid = false; // distanceLookup matches segmentStarts
+
+        void update(size_t n_segments, const std::function<void(size_t segment, float * lut)> & measure); // measure the changed segments and redo the prefix sum after them
+        void update(const std::vector<SegmentControls> & segments); // update measuring the cubic controls of the segments
+        void buildLookup(); // rebuild distanceLookup over segmentStarts
+
+    public:
+        // writes the lookup table of a segment like curve_arc_length::Measure, for curves whose segments aren't cubics
+        using MeasureSegment = std::function<void(size_t segment, float * lut)>;
+
+        // segment a distance along the curve is on
+        struct SegmentDistance
+        {
+            size_t segment = 0;
+            float length = 0.0f; // distance from the start of the segment
+            const float * lut = nullptr; // lookup table of the segment until the next update, null if there are no segments
+        };
+
+        ArcLengthTable() = default;
+
+        void Clear(); // every segment changed
+        void Splice(size_t first_segment, size_t old_count, size_t new_count); // old_count segments starting at first_segment were replaced with new_count segments
+        void Invalidate(size_t first_segment, size_t n_segments); // n_segments starting at first_segment changed in place
+
+        double Length(const std::vector<SegmentControls> & segments); // length of the whole curve
+        CurveLocation Locate(const std::vector<SegmentControls> & segments, double distance); // point at distance along the curve (clamped to its ends)
+
+        // position and unit tangent at every distance along the curve (clamped to its ends), zeros if there are no
+        // segments. instead of a binary search every query starts at the segment its bucket of distanceLookup points
+        // at and searches forward from there. the queries don't have to be sorted, sorted ones read the tables in order
+        // which is faster on curves whose tables don't fit the cache. the parameter inside the lookup table interval
+        // comes from a monotone cubic hermite fit of the inverse of the length (end slopes from the speed) instead of
+        // newton's method, so it can differ from Locate by a small fraction of the interval
+        void SampleAtDistances(const std::vector<SegmentControls> & segments, std::span<const float> distances, const PathSamples & out);
+
+        // the queries of a curve that measures and evaluates its segments itself, measure is called for every segment
+        // that changed since the last query
+        double Length(size_t n_segments, const MeasureSegment & measure); // length of the whole curve
+        SegmentDistance Find(size_t n_segments, const MeasureSegment & measure, double distance); // segment at distance along the curve (clamped to its ends)
+        void Find(size_t n_segments, const MeasureSegment & measure, std::span<const float> distances, SegmentDistance * out); // Find for every distance, starting at its bucket of distanceLookup like SampleAtDistances
+};
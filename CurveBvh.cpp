@@ -0,0 +1,74 @@
+#include "CurveBvh.h"
+
+#include <algorithm>
+
+void CurveBvh::Build(const std::vector<CurveBounds> & segment_bounds)
+{
+    leafCount = segment_bounds.size();
+    leafOffset = 1;
+    while (leafOffset < leafCount)
+    {
+        leafOffset *= 2;
+    }
+
+    // unused leaves keep empty bounds, which are never closer than any segment
+    nodes.assign(leafOffset * 2, CurveBounds{});
+    std::copy(segment_bounds.begin(), segment_bounds.end(), nodes.begin() + leafOffset);
+
+    for (size_t i=leafOffset-1; i>0; i--)
+    {
+        nodes[i] = nodes[i*2];
+        nodes[i].Expand(nodes[(i*2)+1]);
+    }
+}
+
+void CurveBvh::Refit(const std::vector<CurveBounds> & segment_bounds, size_t first_segment, size_t n_segments)
+{
+    if (nodes.empty() || (n_segments == 0))
+    {
+        return;
+    }
+
+    if (segment_bounds.size() != leafCount)
+    {
+        // segments were added or removed which changes the layout, the tree is rebuilt when it is used next
+        Clear();
+        return;
+    }
+
+    size_t first_node = leafOffset + first_segment;
+    size_t last_node = first_node + n_segments - 1;
+    std::copy(segment_bounds.begin() + first_segment, segment_bounds.begin() + first_segment + n_segments, nodes.begin() + first_node);
+
+    // walk up one level at a time, the changed nodes of every level are a single range
+    while (first_node > 1)
+    {
+        first_node /= 2;
+        last_node /= 2;
+
+        for (size_t i=first_node; i<=last_node; i++)
+        {
+            nodes[i] = nodes[i*2];
+            nodes[i].Expand(nodes[(i*2)+1]);
+        }
+    }
+}
+
+void CurveBvh::Clear()
+{
+    nodes.clear();
+    leafCount = 0;
+    leafOffset = 0;
+}
+
+float CurveBvh::DistanceSqr(const CurveBounds & bounds, const std::array<float, 2> & point)
+{
+    if (bounds.IsEmpty())
+    {
+        return std::numeric_limits<float>::max();
+    }
+
+    float dx = std::max({bounds.min[0] - point[0], 0.0f, point[0] - bounds.max[0]});
+    float dy = std::max({bounds.min[1] - point[1], 0.0f, point[1] - bounds.max[1]});
+    return (dx * dx) + (dy * dy);
+}
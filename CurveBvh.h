@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Curve.h"
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+// bounding volume hierarchy over the bounds of the generated segments of a curve. segments next to each other in the
+// curve are usually close to each other on screen, so the tree is built over the segments in curve order: an implicit
+// complete binary tree (node 1 is the root, the children of node i are 2i and 2i+1) with segment i at leaf
+// (leafOffset + i). the layout never changes while the number of segments stays the same, so an edit only refits the
+// nodes above the segments it changed
+class CurveBvh
+{
+    private:
+        std::vector<CurveBounds> nodes;
+        size_t leafCount = 0; // number of segments in the tree
+        size_t leafOffset = 0; // node index of the first leaf (a power of 2 >= leafCount)
+
+    public:
+        CurveBvh() = default;
+
+        void Build(const std::vector<CurveBounds> & segment_bounds); // rebuild the tree over segment_bounds
+        void Refit(const std::vector<CurveBounds> & segment_bounds, size_t first_segment, size_t n_segments); // update the bounds of n_segments starting at first_segment and the nodes above them. the tree is cleared if the number of segments changed
+        void Clear();
+
+        size_t LeafCount() const { return leafCount; }
+        bool IsBuilt(const std::vector<CurveBounds> & segment_bounds) const { return (leafCount == segment_bounds.size()) && !nodes.empty(); }
+
+        static float DistanceSqr(const CurveBounds & bounds, const std::array<float, 2> & point); // squared distance from point to bounds (0 if it is inside)
+
+        // visit the segments closest to point first and skip every node that is farther away than the closest
+        // segment found so far. segment_distance(segment) returns the squared distance from point to the segment
+        template<typename SegmentDistance>
+        void Nearest(const std::array<float, 2> & point, SegmentDistance && segment_distance) const
+        {
+            if (leafCount == 0)
+            {
+                return;
+            }
+
+            constexpr size_t max_stack_size = 128; // 2 entries per level of the tree
+            struct StackEntry { size_t node; float distance; };
+            StackEntry stack[max_stack_size];
+            size_t stack_size = 0;
+
+            float best_distance = std::numeric_limits<float>::max();
+            stack[stack_size++] = {1, DistanceSqr(nodes[1], point)};
+
+            while (stack_size > 0)
+            {
+                StackEntry entry = stack[--stack_size];
+                if (entry.distance >= best_distance)
+                {
+                    continue;
+                }
+
+                if (entry.node >= leafOffset)
+                {
+                    best_distance = std::min(best_distance, segment_distance(entry.node - leafOffset));
+                    continue;
+                }
+
+                // push the farther child first so the closer one is visited first
+                size_t left = entry.node * 2;
+                size_t right = left + 1;
+                float left_distance = DistanceSqr(nodes[left], point);
+                float right_distance = DistanceSqr(nodes[right], point);
+
+                if (left_distance < right_distance)
+                {
+                    std::swap(left, right);
+                    std::swap(left_distance, right_distance);
+                }
+
+                if (left_distance < best_distance)
+                {
+                    stack[stack_size++] = {left, left_distance};
+                }
+
+                if (right_distance < best_distance)
+                {
+                    stack[stack_size++] = {right, right_distance};
+                }
+            }
+        }
+
+        // visit the nodes depth first in curve order. visit(bounds, first_segment, n_segments) is called with the
+        // bounds of every node reached and the range of segments below it, and returns true to visit its children
+        // (a leaf covers a single segment and has none)
+        template<typename Visit>
+        void Traverse(Visit && visit) const
+        {
+            if (leafCount == 0)
+            {
+                return;
+            }
+
+            constexpr size_t max_stack_size = 128; // 1 entry per level of the tree (the left child is visited next)
+            struct StackEntry { size_t node; size_t first; size_t span; };
+            StackEntry stack[max_stack_size];
+            size_t stack_size = 0;
+
+            stack[stack_size++] = {1, 0, leafOffset};
+
+            while (stack_size > 0)
+            {
+                StackEntry entry = stack[--stack_size];
+                if (entry.first >= leafCount)
+                {
+                    continue; // only unused leaves below
+                }
+
+                const size_t n_segments = std::min(entry.span, (leafCount - entry.first));
+                if (!visit(nodes[entry.node], entry.first, n_segments) || (entry.node >= leafOffset))
+                {
+                    continue;
+                }
+
+                // push the right child first so the left one (earlier in the curve) is visited first
+                const size_t half_span = entry.span / 2;
+                stack[stack_size++] = {(entry.node * 2) + 1, (entry.first + half_span), half_span};
+                stack[stack_size++] = {(entry.node * 2), entry.first, half_span};
+            }
+        }
+};
@@ -3,6 +3,7 @@
 //
 
 #include "CurveEffect.h"
+#include "AllocationCounter.h"
 
 #include <cstdlib>
 #include <random>
@@ -14,10 +15,19 @@ namespace curve_effect
     std::vector<std::array<float, 2>> Noise(std::vector<std::array<float,2>> & curve_data)
     {
         std::vector<std::array<float, 2>> new_data;
+        Noise(curve_data, new_data);
+        return new_data;
+    }
+
+    void Noise(const std::vector<std::array<float,2>> & curve_data, std::vector<std::array<float, 2>> & new_data)
+    {
+        CURVE_ALLOCATION_SCOPE(EFFECT);
+
+        new_data.clear();
 
         if (!curve_data.empty())
         {
-            new_data = std::vector<std::array<float, 2>> (curve_data.size());
+            new_data.resize(curve_data.size());
 
             auto time_point = std::chrono::steady_clock::now();
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
@@ -34,7 +44,5 @@ namespace curve_effect
                 new_data[i][1] = curve_data[i][1] + static_cast<float>(static_cast<int32_t>(n_dist(rand_gen)) % 10);
             }
         }
-
-        return new_data;
     }
 }
\ No newline at end of file
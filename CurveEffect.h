@@ -6,4 +6,5 @@
 namespace curve_effect
 {
     std::vector<std::array<float, 2>> Noise(std::vector<std::array<float,2>> & curve_data);
+    void Noise(const std::vector<std::array<float,2>> & curve_data, std::vector<std::array<float, 2>> & new_data); // same noise written into new_data, which keeps its capacity between calls
 }
\ No newline at end of file
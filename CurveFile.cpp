@@ -0,0 +1,297 @@
+#include "CurveFile.h"
+
+#include <bit>
+#include <array>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// the file is the memory layout of the points, which only is little endian on a little endian machine
+static_assert(std::endian::native == std::endian::little, "CurveFile maps little endian points directly");
+static_assert(sizeof(CurveFile::Header) == 32);
+static_assert(sizeof(CurveFile::CurveEntry) == 32);
+static_assert(sizeof(PointList::value_type) == (2 * sizeof(float)));
+
+namespace
+{
+    constexpr char fileMagic[8] = {'B', 'C', 'U', 'R', 'V', 'E', 'S', '\0'};
+
+    uint64_t alignUp(uint64_t offset, uint64_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    bool setError(std::string * error, const char * message)
+    {
+        if (error)
+        {
+            *error = message;
+        }
+
+        return false;
+    }
+
+    bool isCurveType(uint8_t curve_type)
+    {
+        return (curve_type == static_cast<uint8_t>(CURVE_TYPE::LINEAR)) || (curve_type == static_cast<uint8_t>(CURVE_TYPE::QUADRATIC)) || (curve_type == static_cast<uint8_t>(CURVE_TYPE::CUBIC));
+    }
+}
+
+CurveFile::~CurveFile()
+{
+    Close();
+}
+
+bool CurveFile::Write(const std::string & path, std::span<const CurveData * const> curves, std::string * error)
+{
+    // the format has no segment degrees, so bezier curves of mixed degrees can't be stored in it
+    if (std::any_of(curves.begin(), curves.end(), [](const CurveData * curve_data){ return !isCurveType(static_cast<uint8_t>(curve_data->curveType)); }))
+    {
+        return setError(error, "the format doesn't store bezier curves");
+    }
+
+    // the curves are written to a file next to path that then replaces it. curves opened from path borrow their points
+    // from a mapping of it, truncating it in place would take those pages away (SIGBUS), while the replaced file stays
+    // alive until it is unmapped (posix only, windows refuses to replace a mapped file)
+    const std::string temp_path = path + ".tmp";
+    std::ofstream file (temp_path, std::ios::binary);
+    if (!file)
+    {
+        return setError(error, "can't create the temporary file");
+    }
+
+    // the point blocks follow the curve table in curve order
+    std::vector<CurveEntry> curve_table (curves.size());
+    uint64_t offset = alignUp(sizeof(Header) + (curves.size() * sizeof(CurveEntry)), pointAlignment);
+
+    for (size_t i=0; i<curves.size(); i++)
+    {
+        const CurveData & curve_data = *curves[i];
+        CurveEntry & entry = curve_table[i];
+
+        entry = {};
+        entry.id = curve_data.id;
+        entry.curveType = static_cast<uint8_t>(curve_data.curveType);
+        entry.flags = static_cast<uint8_t>((curve_data.isCloseLoop ? closeLoopFlag : 0) | (curve_data.areHandlesGenerated ? handlesGeneratedFlag : 0));
+        entry.tessellationMode = static_cast<uint8_t>(curve_data.tessellationMode);
+        entry.smoothFactor = curve_data.smoothFactor;
+        entry.flatnessTolerance = curve_data.flatnessTolerance;
+        entry.pointOffset = offset;
+        entry.pointCount = curve_data.pointList.size();
+
+        offset = alignUp(offset + (entry.pointCount * sizeof(PointList::value_type)), pointAlignment);
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = version;
+    header.curveCount = static_cast<uint32_t>(curves.size());
+    header.curveTableOffset = sizeof(Header);
+    header.fileSize = offset;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(curve_table.data()), static_cast<std::streamsize>(curve_table.size() * sizeof(CurveEntry)));
+
+    // the point list is a gap buffer, its points are copied out in chunks
+    constexpr size_t chunk_points = 4096;
+    std::vector<PointList::value_type> chunk (chunk_points);
+    const std::array<char, pointAlignment> padding = {};
+    uint64_t written = sizeof(Header) + (curves.size() * sizeof(CurveEntry));
+
+    for (size_t i=0; i<curves.size(); i++)
+    {
+        const PointList & points = curves[i]->pointList;
+
+        file.write(padding.data(), static_cast<std::streamsize>(curve_table[i].pointOffset - written));
+        written = curve_table[i].pointOffset;
+
+        for (size_t first=0; first<points.size(); first+=chunk_points)
+        {
+            const size_t n_points = std::min(chunk_points, points.size() - first);
+            std::copy(points.begin() + static_cast<std::ptrdiff_t>(first), points.begin() + static_cast<std::ptrdiff_t>(first + n_points), chunk.begin());
+            file.write(reinterpret_cast<const char *>(chunk.data()), static_cast<std::streamsize>(n_points * sizeof(PointList::value_type)));
+        }
+
+        written += points.size() * sizeof(PointList::value_type);
+    }
+
+    file.write(padding.data(), static_cast<std::streamsize>(header.fileSize - written));
+    file.close();
+
+    if (!file)
+    {
+        std::error_code remove_error;
+        std::filesystem::remove(temp_path, remove_error);
+        return setError(error, "can't write the temporary file");
+    }
+
+    std::error_code error_code;
+    std::filesystem::rename(temp_path, path, error_code);
+
+    if (error_code)
+    {
+        std::error_code remove_error;
+        std::filesystem::remove(temp_path, remove_error);
+        return setError(error, ("can't replace the file (is it still opened by a CurveFile?): " + error_code.message()).c_str());
+    }
+
+    return true;
+}
+
+bool CurveFile::Open(const std::string & path, std::string * error)
+{
+    Close();
+
+    // map the file copy on write: the borrowed points can be edited in place without changing the file
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return setError(error, "can't open the file");
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || (static_cast<uint64_t>(file_size.QuadPart) < sizeof(Header)))
+    {
+        CloseHandle(file);
+        return setError(error, "not a curve file");
+    }
+
+    HANDLE file_mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!file_mapping)
+    {
+        return setError(error, "can't map the file");
+    }
+
+    mapping = MapViewOfFile(file_mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(file_mapping); // the view keeps the mapping alive
+    if (!mapping)
+    {
+        return setError(error, "can't map the file");
+    }
+
+    mappingSize = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return setError(error, "can't open the file");
+    }
+
+    struct stat file_stat = {};
+    if ((fstat(file, &file_stat) != 0) || (static_cast<uint64_t>(file_stat.st_size) < sizeof(Header)))
+    {
+        ::close(file);
+        return setError(error, "not a curve file");
+    }
+
+    void * file_mapping = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    ::close(file); // the mapping keeps the file alive
+    if (file_mapping == MAP_FAILED)
+    {
+        return setError(error, "can't map the file");
+    }
+
+    mapping = file_mapping;
+    mappingSize = static_cast<size_t>(file_stat.st_size);
+#endif
+
+    // only the header and the curve table are read, the point blocks are paged in when a curve uses them
+    Header header;
+    std::memcpy(&header, mapping, sizeof(header));
+
+    const char * message = nullptr;
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0)
+    {
+        message = "not a curve file";
+    }
+    else if (header.version != version)
+    {
+        message = "unsupported curve file version";
+    }
+    else if ((header.fileSize > mappingSize) || ((header.curveTableOffset % alignof(CurveEntry)) != 0) || (header.curveTableOffset > header.fileSize)
+             || (header.curveCount > ((header.fileSize - header.curveTableOffset) / sizeof(CurveEntry))))
+    {
+        message = "truncated curve file";
+    }
+    else
+    {
+        curveTable = reinterpret_cast<const CurveEntry *>(static_cast<const char *>(mapping) + header.curveTableOffset);
+        curveCount = header.curveCount;
+
+        for (size_t i=0; (i<curveCount) && !message; i++)
+        {
+            const CurveEntry & entry = curveTable[i];
+
+            if (!isCurveType(entry.curveType) || (entry.tessellationMode > static_cast<uint8_t>(TESSELLATION_MODE::ARC_LENGTH)))
+            {
+                message = "unknown curve type";
+            }
+            else if (((entry.pointOffset % pointAlignment) != 0) || (entry.pointOffset > header.fileSize)
+                     || (entry.pointCount > ((header.fileSize - entry.pointOffset) / sizeof(PointList::value_type))))
+            {
+                message = "point block outside of the file";
+            }
+        }
+    }
+
+    if (message)
+    {
+        Close();
+        return setError(error, message);
+    }
+
+    return true;
+}
+
+void CurveFile::Close()
+{
+    if (mapping)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, mappingSize);
+#endif
+    }
+
+    mapping = nullptr;
+    mappingSize = 0;
+    curveTable = nullptr;
+    curveCount = 0;
+}
+
+std::unique_ptr<CurveData> CurveFile::Curve(size_t index) const
+{
+    const CurveEntry & entry = curveTable[index];
+
+    auto curve_data = std::make_unique<CurveData>(static_cast<CURVE_TYPE>(entry.curveType));
+    curve_data->id = entry.id;
+    curve_data->isCloseLoop = (entry.flags & closeLoopFlag) != 0;
+    curve_data->areHandlesGenerated = (entry.flags & handlesGeneratedFlag) != 0;
+    curve_data->tessellationMode = static_cast<TESSELLATION_MODE>(entry.tessellationMode);
+    curve_data->smoothFactor = entry.smoothFactor;
+    curve_data->flatnessTolerance = entry.flatnessTolerance;
+    curve_data->pointList.Borrow(reinterpret_cast<PointList::value_type *>(static_cast<char *>(mapping) + entry.pointOffset), static_cast<size_t>(entry.pointCount));
+
+    return curve_data;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Curve.h"
+
+#include <span>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// binary curve file, every value little endian:
+//   header       magic "BCURVES\0", version, curve count, offset of the curve table, size of the file
+//   curve table  one entry per curve: id, curve type, flags (close loop, generated handles), tessellation settings,
+//                smooth factor and where the points of the curve are
+//   point blocks the point list of every curve as float pairs, each block starting at a multiple of pointAlignment
+// the point blocks have the layout of the points in memory, so CurveFile maps the file and the curves it opens borrow
+// their points from the mapping instead of reading them. opening a file only reads the header and the curve table
+class CurveFile
+{
+    public:
+        static constexpr uint32_t version = 1;
+        static constexpr size_t pointAlignment = 64;
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t curveCount;
+            uint64_t curveTableOffset;
+            uint64_t fileSize;
+        };
+
+        struct CurveEntry
+        {
+            uint32_t id;
+            uint8_t curveType; // CURVE_TYPE
+            uint8_t flags; // closeLoopFlag | handlesGeneratedFlag
+            uint8_t tessellationMode; // TESSELLATION_MODE
+            uint8_t reserved;
+            float smoothFactor;
+            float flatnessTolerance;
+            uint64_t pointOffset; // offset of the point block in the file
+            uint64_t pointCount;
+        };
+
+        static constexpr uint8_t closeLoopFlag = 1;
+        static constexpr uint8_t handlesGeneratedFlag = 2;
+
+    private:
+        void * mapping = nullptr; // the whole file, mapped copy on write
+        size_t mappingSize = 0;
+        const CurveEntry * curveTable = nullptr;
+        size_t curveCount = 0;
+
+    public:
+        CurveFile() = default;
+        ~CurveFile();
+
+        CurveFile(const CurveFile &) = delete;
+        CurveFile & operator=(const CurveFile &) = delete;
+
+        // false (and the reason in error) if the file can't be written or a curve has a type the format doesn't store
+        // (CURVE_TYPE::BEZIER). the file is replaced, not overwritten: on posix the curves opened from it stay valid.
+        // windows can't replace a file that is still mapped, Close the CurveFile of path first (MakeOwned the point
+        // lists borrowed from it before)
+        static bool Write(const std::string & path, std::span<const CurveData * const> curves, std::string * error = nullptr);
+
+        bool Open(const std::string & path, std::string * error = nullptr); // map a file written by Write, false (and the reason in error) if it isn't one
+        void Close();
+        bool IsOpen() const { return mapping != nullptr; }
+
+        size_t CurveCount() const { return curveCount; }
+        const CurveEntry & Entry(size_t index) const { return curveTable[index]; }
+
+        // new curve data of a curve in the file. its point list borrows the mapped points: edits write to private copies of
+        // the touched pages and never reach the file. the curve data must not be used after Close unless
+        // pointList.MakeOwned was called
+        std::unique_ptr<CurveData> Curve(size_t index) const;
+};
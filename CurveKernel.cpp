@@ -0,0 +1,1179 @@
+#include "CurveKernel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define CURVE_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define CURVE_KERNEL_X86 0
+#endif
+
+// the avx paths are compiled with per-function target attributes so the rest of the binary keeps the sse2 baseline
+#if CURVE_KERNEL_X86 && (defined(__GNUC__) || defined(__clang__))
+#define CURVE_KERNEL_AVX 1
+#define CURVE_KERNEL_TARGET(isa) __attribute__((target(isa)))
+#define CURVE_KERNEL_INLINE __attribute__((always_inline)) inline // generic loops inlined into each target so they are vectorized for it
+#else
+#define CURVE_KERNEL_AVX 0
+#define CURVE_KERNEL_TARGET(isa)
+#define CURVE_KERNEL_INLINE inline
+#endif
+
+static_assert(sizeof(std::array<float, 2>) == (sizeof(float) * 2), "kernels write x/y pairs as packed floats");
+
+namespace
+{
+    constexpr float t_constrain_end = 1.0f;
+    constexpr float epsilon = 0.0001f; // smooth factors within epsilon of a whole number are not rounded up
+
+    // coefficients of the segment in power basis: p(t) = x[0] + x[1]*t + x[2]*t^2 + ... (up to maxHornerDegree)
+    struct PowerBasis
+    {
+        float x[curve_kernel::maxHornerDegree + 1] = {};
+        float y[curve_kernel::maxHornerDegree + 1] = {};
+    };
+
+    // where the evaluate paths write their samples: x/y pairs or separate x and y arrays
+    struct InterleavedOut
+    {
+        std::array<float, 2> * points = nullptr;
+
+        void Store(size_t i, float x, float y) const { points[i] = {x, y}; }
+    };
+
+    struct SplitOut
+    {
+        float * x = nullptr;
+        float * y = nullptr;
+
+        void Store(size_t i, float x_value, float y_value) const { x[i] = x_value; y[i] = y_value; }
+    };
+
+    // scalar fallback. the simd paths below perform the exact same operations in the same order, so every
+    // instruction set produces bit identical results
+    template<int Degree, typename Out>
+    void evaluateScalar(const PowerBasis & basis, float step_size, size_t begin, size_t n_samples, Out out)
+    {
+        for (size_t i=begin; i<n_samples; i++)
+        {
+            float t = std::min(static_cast<float>(i) * step_size, t_constrain_end);
+
+            float x = basis.x[Degree];
+            float y = basis.y[Degree];
+
+            for (int k=Degree-1; k>=0; k--)
+            {
+                x = (x * t) + basis.x[k];
+                y = (y * t) + basis.y[k];
+            }
+
+            out.Store(i, x, y);
+        }
+    }
+
+#if CURVE_KERNEL_X86
+    void store4(const InterleavedOut & out, size_t i, __m128 x, __m128 y)
+    {
+        // interleave back into x/y pairs
+        auto * dst = reinterpret_cast<float*>(out.points + i);
+        _mm_storeu_ps(dst + 0, _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(dst + 4, _mm_unpackhi_ps(x, y));
+    }
+
+    void store4(const SplitOut & out, size_t i, __m128 x, __m128 y)
+    {
+        _mm_storeu_ps(out.x + i, x);
+        _mm_storeu_ps(out.y + i, y);
+    }
+
+    template<int Degree, typename Out>
+    void evaluateSse2(const PowerBasis & basis, float step_size, size_t n_samples, Out out)
+    {
+        const __m128 step = _mm_set1_ps(step_size);
+        const __m128 t_end = _mm_set1_ps(t_constrain_end);
+        const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+
+        size_t i = 0;
+        for (; (i + 4) <= n_samples; i+=4)
+        {
+            __m128 t = _mm_min_ps(_mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane), step), t_end);
+
+            __m128 x = _mm_set1_ps(basis.x[Degree]);
+            __m128 y = _mm_set1_ps(basis.y[Degree]);
+
+            for (int k=Degree-1; k>=0; k--)
+            {
+                x = _mm_add_ps(_mm_mul_ps(x, t), _mm_set1_ps(basis.x[k]));
+                y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(basis.y[k]));
+            }
+
+            store4(out, i, x, y);
+        }
+
+        evaluateScalar<Degree, Out>(basis, step_size, i, n_samples, out);
+    }
+#endif
+
+#if CURVE_KERNEL_AVX
+    CURVE_KERNEL_TARGET("avx2")
+    void store8(const InterleavedOut & out, size_t i, __m256 x, __m256 y)
+    {
+        // unpack works per 128-bit lane: lo = [p0 p1 | p4 p5], hi = [p2 p3 | p6 p7]
+        __m256 lo = _mm256_unpacklo_ps(x, y);
+        __m256 hi = _mm256_unpackhi_ps(x, y);
+
+        auto * dst = reinterpret_cast<float*>(out.points + i);
+        _mm256_storeu_ps(dst + 0, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+
+    CURVE_KERNEL_TARGET("avx2")
+    void store8(const SplitOut & out, size_t i, __m256 x, __m256 y)
+    {
+        _mm256_storeu_ps(out.x + i, x);
+        _mm256_storeu_ps(out.y + i, y);
+    }
+
+    template<int Degree, typename Out>
+    CURVE_KERNEL_TARGET("avx2")
+    void evaluateAvx2(const PowerBasis & basis, float step_size, size_t n_samples, Out out)
+    {
+        const __m256 step = _mm256_set1_ps(step_size);
+        const __m256 t_end = _mm256_set1_ps(t_constrain_end);
+        const __m256 lane = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+
+        size_t i = 0;
+        for (; (i + 8) <= n_samples; i+=8)
+        {
+            __m256 t = _mm256_min_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane), step), t_end);
+
+            __m256 x = _mm256_set1_ps(basis.x[Degree]);
+            __m256 y = _mm256_set1_ps(basis.y[Degree]);
+
+            for (int k=Degree-1; k>=0; k--)
+            {
+                x = _mm256_add_ps(_mm256_mul_ps(x, t), _mm256_set1_ps(basis.x[k]));
+                y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(basis.y[k]));
+            }
+
+            store8(out, i, x, y);
+        }
+
+        evaluateScalar<Degree, Out>(basis, step_size, i, n_samples, out);
+    }
+
+    CURVE_KERNEL_TARGET("avx512f")
+    void store16(const InterleavedOut & out, size_t i, __m512 x, __m512 y)
+    {
+        // unpack works per 128-bit lane: lo = [p0 p1 | p4 p5 | p8 p9 | p12 p13], hi = [p2 p3 | p6 p7 | ...]
+        __m512 lo = _mm512_unpacklo_ps(x, y);
+        __m512 hi = _mm512_unpackhi_ps(x, y);
+
+        __m512 first = _mm512_shuffle_f32x4(lo, hi, _MM_SHUFFLE(1, 0, 1, 0)); // [lo0 lo1 hi0 hi1]
+        __m512 second = _mm512_shuffle_f32x4(lo, hi, _MM_SHUFFLE(3, 2, 3, 2)); // [lo2 lo3 hi2 hi3]
+
+        auto * dst = reinterpret_cast<float*>(out.points + i);
+        _mm512_storeu_ps(dst + 0, _mm512_shuffle_f32x4(first, first, _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm512_storeu_ps(dst + 16, _mm512_shuffle_f32x4(second, second, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    CURVE_KERNEL_TARGET("avx512f")
+    void store16(const SplitOut & out, size_t i, __m512 x, __m512 y)
+    {
+        _mm512_storeu_ps(out.x + i, x);
+        _mm512_storeu_ps(out.y + i, y);
+    }
+
+    template<int Degree, typename Out>
+    CURVE_KERNEL_TARGET("avx512f")
+    void evaluateAvx512(const PowerBasis & basis, float step_size, size_t n_samples, Out out)
+    {
+        const __m512 step = _mm512_set1_ps(step_size);
+        const __m512 t_end = _mm512_set1_ps(t_constrain_end);
+        const __m512 lane = _mm512_set_ps(15.0f, 14.0f, 13.0f, 12.0f, 11.0f, 10.0f, 9.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+
+        size_t i = 0;
+        for (; (i + 16) <= n_samples; i+=16)
+        {
+            __m512 t = _mm512_min_ps(_mm512_mul_ps(_mm512_add_ps(_mm512_set1_ps(static_cast<float>(i)), lane), step), t_end);
+
+            __m512 x = _mm512_set1_ps(basis.x[Degree]);
+            __m512 y = _mm512_set1_ps(basis.y[Degree]);
+
+            for (int k=Degree-1; k>=0; k--)
+            {
+                x = _mm512_add_ps(_mm512_mul_ps(x, t), _mm512_set1_ps(basis.x[k]));
+                y = _mm512_add_ps(_mm512_mul_ps(y, t), _mm512_set1_ps(basis.y[k]));
+            }
+
+            store16(out, i, x, y);
+        }
+
+        evaluateScalar<Degree, Out>(basis, step_size, i, n_samples, out);
+    }
+#endif
+
+    KERNEL_ISA detectIsa()
+    {
+        KERNEL_ISA isa = KERNEL_ISA::SCALAR;
+
+#if CURVE_KERNEL_X86
+        isa = KERNEL_ISA::SSE2;
+#endif
+
+#if CURVE_KERNEL_AVX
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2"))
+        {
+            isa = KERNEL_ISA::AVX2;
+        }
+
+        if (__builtin_cpu_supports("avx512f"))
+        {
+            isa = KERNEL_ISA::AVX512;
+        }
+#endif
+
+        return isa;
+    }
+
+    const KERNEL_ISA supportedIsa = detectIsa();
+    std::atomic<KERNEL_ISA> activeIsa = supportedIsa;
+
+    // the power basis of the bezier core in the layout the simd paths broadcast from
+    template<size_t Degree>
+    PowerBasis powerBasis(const Bezier<Degree, float> & segment)
+    {
+        const std::array<float, Degree + 1> x = segment.AxisPowerBasis(0);
+        const std::array<float, Degree + 1> y = segment.AxisPowerBasis(1);
+        PowerBasis basis;
+
+        std::copy(x.begin(), x.end(), basis.x);
+        std::copy(y.begin(), y.end(), basis.y);
+
+        return basis;
+    }
+
+    template<int Degree, typename Out>
+    void evaluate(const PowerBasis & basis, const std::array<float, 2> & end_point, uint32_t n_steps, Out out)
+    {
+        const float step_size = 1.0f / static_cast<float>(n_steps);
+        const size_t n_samples = static_cast<size_t>(n_steps) + 1;
+
+        switch (activeIsa.load(std::memory_order_relaxed))
+        {
+#if CURVE_KERNEL_AVX
+            case KERNEL_ISA::AVX512:
+                evaluateAvx512<Degree, Out>(basis, step_size, n_samples, out);
+                break;
+
+            case KERNEL_ISA::AVX2:
+                evaluateAvx2<Degree, Out>(basis, step_size, n_samples, out);
+                break;
+#endif
+
+#if CURVE_KERNEL_X86
+            case KERNEL_ISA::SSE2:
+                evaluateSse2<Degree, Out>(basis, step_size, n_samples, out);
+                break;
+#endif
+
+            default:
+                evaluateScalar<Degree, Out>(basis, step_size, 0, n_samples, out);
+                break;
+        }
+
+        // i * step_size at i = n_steps or the power basis sum at t = 1 can be off by a rounding error, pin the last
+        // sample so segments join exactly
+        out.Store(n_steps, end_point[0], end_point[1]);
+    }
+
+    // forward differencing: after seeding the position and its differences every point only costs Degree adds per
+    // axis. the accumulated float error grows with each step, so the differences are re-seeded from the exact
+    // polynomial (in double precision) every forwardDifferenceReseed samples
+    template<int Degree>
+    void forwardDifference(const PowerBasis & basis, const std::array<float, 2> & end_point, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        const double h = 1.0 / static_cast<double>(n_steps);
+        const size_t n_samples = static_cast<size_t>(n_steps) + 1;
+
+        for (size_t i=0; i<n_samples; i+=curve_kernel::forwardDifferenceReseed)
+        {
+            const double t = static_cast<double>(i) * h;
+
+            float p[2] = {};
+            float d1[2] = {};
+            float d2[2] = {};
+            float d3[2] = {};
+
+            for (size_t k=0; k<2; k++)
+            {
+                const float * c = (k == 0) ? basis.x : basis.y;
+                const double c0 = c[0];
+                const double c1 = c[1];
+                const double c2 = c[2];
+                const double c3 = c[3];
+
+                p[k] = static_cast<float>(c0 + (t * (c1 + (t * (c2 + (t * c3))))));
+                d1[k] = static_cast<float>((c1 * h) + (c2 * ((2.0 * t * h) + (h * h))) + (c3 * ((3.0 * t * t * h) + (3.0 * t * h * h) + (h * h * h))));
+                d2[k] = static_cast<float>((2.0 * c2 * h * h) + (c3 * ((6.0 * t * h * h) + (6.0 * h * h * h))));
+                d3[k] = static_cast<float>(6.0 * c3 * h * h * h);
+            }
+
+            const size_t end = std::min(i + curve_kernel::forwardDifferenceReseed, n_samples);
+
+            for (size_t j=i; j<end; j++)
+            {
+                out[j] = {p[0], p[1]};
+
+                p[0] += d1[0];
+                p[1] += d1[1];
+                d1[0] += d2[0];
+                d1[1] += d2[1];
+
+                if constexpr (Degree == 3)
+                {
+                    d2[0] += d3[0];
+                    d2[1] += d3[1];
+                }
+            }
+        }
+
+        out[n_steps] = end_point;
+    }
+
+    constexpr float min_flatness_tolerance = 0.01f; // keeps a zero/negative tolerance from always splitting to max depth
+
+    std::array<float, 2> midPoint(const std::array<float, 2> & a, const std::array<float, 2> & b)
+    {
+        return {(a[0] + b[0]) * 0.5f, (a[1] + b[1]) * 0.5f};
+    }
+
+    void flattenQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, float tolerance_sqr, int32_t depth, std::vector<std::array<float, 2>> & out)
+    {
+        // the furthest the curve gets from its chord is |a - 2b + c| / 4 (at t = 0.5)
+        float dx = a[0] - (2.0f * b[0]) + c[0];
+        float dy = a[1] - (2.0f * b[1]) + c[1];
+
+        if ((depth >= curve_kernel::flattenMaxDepth) || (((dx * dx) + (dy * dy)) <= (16.0f * tolerance_sqr)))
+        {
+            out.push_back(c);
+            return;
+        }
+
+        // de casteljau split at t = 0.5
+        std::array<float, 2> ab = midPoint(a, b);
+        std::array<float, 2> bc = midPoint(b, c);
+        std::array<float, 2> abc = midPoint(ab, bc);
+
+        flattenQuadratic(a, ab, abc, tolerance_sqr, depth + 1, out);
+        flattenQuadratic(abc, bc, c, tolerance_sqr, depth + 1, out);
+    }
+
+    void flattenCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, float tolerance_sqr, int32_t depth, std::vector<std::array<float, 2>> & out)
+    {
+        // bound on the distance between the curve and its chord taken from the control polygon:
+        // max(ux^2, vx^2) + max(uy^2, vy^2) <= 16 * tolerance^2 with u = 3b - 2a - d, v = 3c - a - 2d
+        float ux = (3.0f * b[0]) - (2.0f * a[0]) - d[0];
+        float uy = (3.0f * b[1]) - (2.0f * a[1]) - d[1];
+        float vx = (3.0f * c[0]) - a[0] - (2.0f * d[0]);
+        float vy = (3.0f * c[1]) - a[1] - (2.0f * d[1]);
+
+        float flatness = std::max(ux * ux, vx * vx) + std::max(uy * uy, vy * vy);
+
+        if ((depth >= curve_kernel::flattenMaxDepth) || (flatness <= (16.0f * tolerance_sqr)))
+        {
+            out.push_back(d);
+            return;
+        }
+
+        // de casteljau split at t = 0.5
+        std::array<float, 2> ab = midPoint(a, b);
+        std::array<float, 2> bc = midPoint(b, c);
+        std::array<float, 2> cd = midPoint(c, d);
+        std::array<float, 2> abc = midPoint(ab, bc);
+        std::array<float, 2> bcd = midPoint(bc, cd);
+        std::array<float, 2> abcd = midPoint(abc, bcd);
+
+        flattenCubic(a, ab, abc, abcd, tolerance_sqr, depth + 1, out);
+        flattenCubic(abcd, bcd, cd, d, tolerance_sqr, depth + 1, out);
+    }
+
+    // parameter values in (0, 1) where the derivative a*t^2 + b*t + c of one axis is 0
+    size_t derivativeRoots(double a, double b, double c, double (&roots)[2])
+    {
+        size_t n_roots = 0;
+        auto add_root = [&](double t)
+        {
+            if ((t > 0.0) && (t < 1.0))
+            {
+                roots[n_roots++] = t;
+            }
+        };
+
+        constexpr double epsilon = 1e-9;
+        if (std::abs(a) <= (epsilon * (std::abs(b) + std::abs(c))))
+        {
+            // derivative is (close to) linear
+            if (b != 0.0)
+            {
+                add_root(-c / b);
+            }
+        }
+        else
+        {
+            double discriminant = (b * b) - (4.0 * a * c);
+            if (discriminant >= 0.0)
+            {
+                double discriminant_sqrt = std::sqrt(discriminant);
+                add_root((-b + discriminant_sqrt) / (2.0 * a));
+                add_root((-b - discriminant_sqrt) / (2.0 * a));
+            }
+        }
+
+        return n_roots;
+    }
+
+    // closest point solve. the squared distance from point to the segment is stationary where
+    // f(t) = (p(t) - point) . p'(t) is 0, a polynomial of degree 2 * degree - 1. its roots are isolated in bernstein form
+    // (the number of sign changes of the coefficients bounds the number of roots in the interval, so intervals with none
+    // are dropped and intervals with one are polished) and the closest of the roots and the end points is returned
+    constexpr size_t maxDistanceDegree = (2 * bezier::maxDegree) - 1; // degree of f for a segment of the highest degree
+    constexpr int32_t closestMaxDepth = 24; // max number of times an interval is split while isolating roots
+
+    struct DistancePolynomial
+    {
+        double power[maxDistanceDegree + 1] = {}; // f in power basis
+        double bernstein[maxDistanceDegree + 1] = {}; // f in bernstein basis on [0, 1]
+        size_t degree = 0;
+
+        double Evaluate(double t) const
+        {
+            double value = 0.0;
+            for (size_t i=degree+1; i>0; i--)
+            {
+                value = (value * t) + power[i-1];
+            }
+            return value;
+        }
+
+        double Derivative(double t) const
+        {
+            double value = 0.0;
+            for (size_t i=degree; i>0; i--)
+            {
+                value = (value * t) + (static_cast<double>(i) * power[i]);
+            }
+            return value;
+        }
+    };
+
+    // power to bernstein basis: b_k = sum(i <= k) (k choose i) / (n choose i) * a_i
+    void toBernstein(DistancePolynomial & f)
+    {
+        auto choose = [](size_t n, size_t k)
+        {
+            double value = 1.0;
+            for (size_t i=1; i<=k; i++)
+            {
+                value = (value * static_cast<double>(n - k + i)) / static_cast<double>(i);
+            }
+            return value;
+        };
+
+        for (size_t k=0; k<=f.degree; k++)
+        {
+            for (size_t i=0; i<=k; i++)
+            {
+                f.bernstein[k] += (choose(k, i) / choose(f.degree, i)) * f.power[i];
+            }
+        }
+    }
+
+    // coefficients holds p(t) - point in power basis (coefficients[i] is the t^i term)
+    DistancePolynomial distancePolynomial(const std::array<double, 2> * coefficients, size_t degree)
+    {
+        DistancePolynomial f;
+        f.degree = (2 * degree) - 1;
+
+        for (size_t i=0; i<=degree; i++)
+        {
+            for (size_t j=1; j<=degree; j++)
+            {
+                double dot = (coefficients[i][0] * coefficients[j][0]) + (coefficients[i][1] * coefficients[j][1]);
+                f.power[i + j - 1] += static_cast<double>(j) * dot;
+            }
+        }
+
+        toBernstein(f);
+        return f;
+    }
+
+    // newton's method kept inside [lo, hi], falls back to bisection when a step leaves the bracket
+    double polishRoot(const DistancePolynomial & f, double lo, double hi)
+    {
+        double f_lo = f.Evaluate(lo);
+        double t = 0.5 * (lo + hi);
+
+        for (int32_t i=0; i<64; i++)
+        {
+            double value = f.Evaluate(t);
+            if (value == 0.0)
+            {
+                break;
+            }
+
+            // shrink the bracket to the half that still has the sign change
+            if ((value < 0.0) == (f_lo < 0.0))
+            {
+                lo = t;
+                f_lo = value;
+            }
+            else
+            {
+                hi = t;
+            }
+
+            double derivative = f.Derivative(t);
+            double next_t = (derivative != 0.0) ? (t - (value / derivative)) : lo;
+            if ((next_t <= lo) || (next_t >= hi))
+            {
+                next_t = 0.5 * (lo + hi);
+            }
+
+            if (std::abs(next_t - t) <= 1e-12)
+            {
+                t = next_t;
+                break;
+            }
+
+            t = next_t;
+        }
+
+        return t;
+    }
+
+    // call on_root for every root of f in [lo, hi]. bernstein holds f on [lo, hi]
+    template<typename OnRoot>
+    void isolateRoots(const DistancePolynomial & f, const double * bernstein, double lo, double hi, int32_t depth, OnRoot && on_root)
+    {
+        size_t n_sign_changes = 0;
+        for (size_t i=1; i<=f.degree; i++)
+        {
+            if ((bernstein[i-1] < 0.0) != (bernstein[i] < 0.0))
+            {
+                n_sign_changes++;
+            }
+        }
+
+        if (n_sign_changes == 0)
+        {
+            return;
+        }
+
+        if ((n_sign_changes == 1) && ((bernstein[0] < 0.0) != (bernstein[f.degree] < 0.0)))
+        {
+            on_root(polishRoot(f, lo, hi));
+            return;
+        }
+
+        if (depth >= closestMaxDepth)
+        {
+            // a cluster of roots (or a double root) this close together is a single candidate
+            on_root(0.5 * (lo + hi));
+            return;
+        }
+
+        // split at the middle with de casteljau
+        double left[maxDistanceDegree + 1];
+        double right[maxDistanceDegree + 1];
+        double work[maxDistanceDegree + 1];
+        std::copy(bernstein, bernstein + f.degree + 1, work);
+
+        for (size_t i=0; i<=f.degree; i++)
+        {
+            left[i] = work[0];
+            right[f.degree - i] = work[f.degree - i];
+
+            for (size_t j=0; j<(f.degree - i); j++)
+            {
+                work[j] = 0.5 * (work[j] + work[j+1]);
+            }
+        }
+
+        double mid = 0.5 * (lo + hi);
+        isolateRoots(f, left, lo, mid, depth + 1, on_root);
+        isolateRoots(f, right, mid, hi, depth + 1, on_root);
+    }
+
+    float closestParameter(const std::array<double, 2> * coefficients, size_t degree)
+    {
+        auto distance_sqr = [&](double t)
+        {
+            std::array<double, 2> p = coefficients[degree];
+            for (size_t i=degree; i>0; i--)
+            {
+                p[0] = (p[0] * t) + coefficients[i-1][0];
+                p[1] = (p[1] * t) + coefficients[i-1][1];
+            }
+            return (p[0] * p[0]) + (p[1] * p[1]);
+        };
+
+        double best_t = 0.0;
+        double best_distance = distance_sqr(0.0);
+
+        auto check = [&](double t)
+        {
+            t = std::clamp(t, 0.0, 1.0);
+            double distance = distance_sqr(t);
+            if (distance < best_distance)
+            {
+                best_t = t;
+                best_distance = distance;
+            }
+        };
+
+        check(1.0);
+
+        DistancePolynomial f = distancePolynomial(coefficients, degree);
+        isolateRoots(f, f.bernstein, 0.0, 1.0, 0, check);
+
+        return static_cast<float>(best_t);
+    }
+
+    // power basis of one axis of a segment of any degree in double precision, minus offset (coefficients[k] is the
+    // t^k term)
+    void powerBasisAxis(std::span<const std::array<float, 2>> points, size_t axis, double offset, double * coefficients)
+    {
+        const size_t degree = points.size() - 1;
+
+        for (size_t k=0; k<=degree; k++)
+        {
+            double sum = 0.0;
+            for (size_t j=0; j<=k; j++)
+            {
+                const double term = bezier::Binomial(k, j) * static_cast<double>(points[j][axis]);
+                sum = (((k - j) % 2) == 0) ? (sum + term) : (sum - term);
+            }
+            coefficients[k] = bezier::Binomial(degree, k) * sum;
+        }
+
+        coefficients[0] -= offset;
+    }
+
+    // de casteljau on curve_kernel::bezierBlockSize values of t at once, lane by lane, so the compiler vectorizes the lanes for the
+    // target it is inlined into. the last sample is pinned by the caller
+    CURVE_KERNEL_INLINE void evaluateBezierBlocks(std::span<const std::array<float, 2>> points, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        const float step_size = 1.0f / static_cast<float>(n_steps);
+        const size_t n_samples = static_cast<size_t>(n_steps) + 1;
+
+        for (size_t first=0; first<n_samples; first+=curve_kernel::bezierBlockSize)
+        {
+            float t[curve_kernel::bezierBlockSize];
+            float x[bezier::maxDegree + 1][curve_kernel::bezierBlockSize];
+            float y[bezier::maxDegree + 1][curve_kernel::bezierBlockSize];
+
+            for (size_t lane=0; lane<curve_kernel::bezierBlockSize; lane++)
+            {
+                t[lane] = std::min(static_cast<float>(first + lane) * step_size, t_constrain_end);
+            }
+
+            for (size_t k=0; k<points.size(); k++)
+            {
+                std::fill_n(x[k], curve_kernel::bezierBlockSize, points[k][0]);
+                std::fill_n(y[k], curve_kernel::bezierBlockSize, points[k][1]);
+            }
+
+            for (size_t n=points.size(); n>1; n--)
+            {
+                for (size_t i=0; (i + 1)<n; i++)
+                {
+                    for (size_t lane=0; lane<curve_kernel::bezierBlockSize; lane++)
+                    {
+                        x[i][lane] = x[i][lane] + (t[lane] * (x[i + 1][lane] - x[i][lane]));
+                        y[i][lane] = y[i][lane] + (t[lane] * (y[i + 1][lane] - y[i][lane]));
+                    }
+                }
+            }
+
+            const size_t n_block = std::min(curve_kernel::bezierBlockSize, n_samples - first);
+            for (size_t lane=0; lane<n_block; lane++)
+            {
+                out[first + lane] = {x[0][lane], y[0][lane]};
+            }
+        }
+    }
+
+#if CURVE_KERNEL_AVX
+    CURVE_KERNEL_TARGET("avx2")
+    void evaluateBezierAvx2(std::span<const std::array<float, 2>> points, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        evaluateBezierBlocks(points, n_steps, out);
+    }
+#endif
+
+    void flattenBezier(std::span<const std::array<float, 2>> points, float tolerance_sqr, int32_t depth, std::vector<std::array<float, 2>> & out)
+    {
+        // the segment stays inside its control polygon, so it is within tolerance of its chord if every control point is
+        const std::array<float, 2> & a = points.front();
+        const std::array<float, 2> & b = points.back();
+        const float chord_x = b[0] - a[0];
+        const float chord_y = b[1] - a[1];
+        const float chord_sqr = (chord_x * chord_x) + (chord_y * chord_y);
+
+        float flatness = 0.0f;
+        for (size_t i=1; (i + 1)<points.size(); i++)
+        {
+            const float px = points[i][0] - a[0];
+            const float py = points[i][1] - a[1];
+            const float t = (chord_sqr > 0.0f) ? std::clamp(((px * chord_x) + (py * chord_y)) / chord_sqr, 0.0f, 1.0f) : 0.0f;
+            const float dx = px - (t * chord_x);
+            const float dy = py - (t * chord_y);
+            flatness = std::max(flatness, (dx * dx) + (dy * dy));
+        }
+
+        if ((depth >= curve_kernel::flattenMaxDepth) || (flatness <= tolerance_sqr))
+        {
+            out.push_back(b);
+            return;
+        }
+
+        bezier::RuntimePoints<float> left;
+        bezier::RuntimePoints<float> right;
+        bezier::Split<float>(points, 0.5f, std::span(left.data(), points.size()), std::span(right.data(), points.size()));
+
+        flattenBezier(std::span<const std::array<float, 2>>(left.data(), points.size()), tolerance_sqr, depth + 1, out);
+        flattenBezier(std::span<const std::array<float, 2>>(right.data(), points.size()), tolerance_sqr, depth + 1, out);
+    }
+
+    constexpr float minTangentLength = 1e-12f; // squared derivatives below this use the chord of the segment as tangent
+
+    // de casteljau down to the last 2 points of every lane, then the position between them and the tangent along them.
+    // the avx2 path below does the same operations in the same order
+    void sampleBatchScalar(const curve_kernel::BezierBatch & batch, const uint32_t * segments, const float * t, size_t n_queries, const PathSamples & out, size_t first_query)
+    {
+        const size_t degree = batch.degree;
+
+        for (size_t q=0; q<n_queries; q++)
+        {
+            float x[bezier::maxDegree + 1];
+            float y[bezier::maxDegree + 1];
+            for (size_t k=0; k<=degree; k++)
+            {
+                x[k] = batch.x[(k * batch.count) + segments[q]];
+                y[k] = batch.y[(k * batch.count) + segments[q]];
+            }
+
+            const float chord_x = x[degree] - x[0];
+            const float chord_y = y[degree] - y[0];
+            const float tq = t[q];
+
+            for (size_t n=degree; n>1; n--)
+            {
+                for (size_t i=0; i<n; i++)
+                {
+                    x[i] = x[i] + (tq * (x[i + 1] - x[i]));
+                    y[i] = y[i] + (tq * (y[i + 1] - y[i]));
+                }
+            }
+
+            const float dx = x[1] - x[0];
+            const float dy = y[1] - y[0];
+            const size_t index = first_query + q;
+            out.x[index] = x[0] + (tq * dx);
+            out.y[index] = y[0] + (tq * dy);
+
+            if (out.tangentX)
+            {
+                float tangent_x = static_cast<float>(degree) * dx;
+                float tangent_y = static_cast<float>(degree) * dy;
+                float length_sqr = (tangent_x * tangent_x) + (tangent_y * tangent_y);
+
+                if (length_sqr <= minTangentLength)
+                {
+                    tangent_x = chord_x;
+                    tangent_y = chord_y;
+                    length_sqr = (chord_x * chord_x) + (chord_y * chord_y);
+                }
+
+                const float inv_length = (length_sqr > 0.0f) ? (1.0f / std::sqrt(length_sqr)) : 0.0f;
+                out.tangentX[index] = tangent_x * inv_length;
+                out.tangentY[index] = tangent_y * inv_length;
+            }
+        }
+    }
+
+#if CURVE_KERNEL_AVX
+    CURVE_KERNEL_TARGET("avx2")
+    void sampleBatchAvx2(const curve_kernel::BezierBatch & batch, const uint32_t * segments, const float * t, const PathSamples & out, size_t first_query)
+    {
+        const size_t degree = batch.degree;
+        const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments));
+
+        __m256 x[bezier::maxDegree + 1];
+        __m256 y[bezier::maxDegree + 1];
+        for (size_t k=0; k<=degree; k++)
+        {
+            x[k] = _mm256_i32gather_ps(batch.x.data() + (k * batch.count), index, 4);
+            y[k] = _mm256_i32gather_ps(batch.y.data() + (k * batch.count), index, 4);
+        }
+
+        const __m256 chord_x = _mm256_sub_ps(x[degree], x[0]);
+        const __m256 chord_y = _mm256_sub_ps(y[degree], y[0]);
+        const __m256 tq = _mm256_loadu_ps(t);
+
+        for (size_t n=degree; n>1; n--)
+        {
+            for (size_t i=0; i<n; i++)
+            {
+                x[i] = _mm256_add_ps(x[i], _mm256_mul_ps(tq, _mm256_sub_ps(x[i + 1], x[i])));
+                y[i] = _mm256_add_ps(y[i], _mm256_mul_ps(tq, _mm256_sub_ps(y[i + 1], y[i])));
+            }
+        }
+
+        const __m256 dx = _mm256_sub_ps(x[1], x[0]);
+        const __m256 dy = _mm256_sub_ps(y[1], y[0]);
+        _mm256_storeu_ps(out.x + first_query, _mm256_add_ps(x[0], _mm256_mul_ps(tq, dx)));
+        _mm256_storeu_ps(out.y + first_query, _mm256_add_ps(y[0], _mm256_mul_ps(tq, dy)));
+
+        if (out.tangentX)
+        {
+            const __m256 scale = _mm256_set1_ps(static_cast<float>(degree));
+            __m256 tangent_x = _mm256_mul_ps(scale, dx);
+            __m256 tangent_y = _mm256_mul_ps(scale, dy);
+            __m256 length_sqr = _mm256_add_ps(_mm256_mul_ps(tangent_x, tangent_x), _mm256_mul_ps(tangent_y, tangent_y));
+
+            const __m256 use_chord = _mm256_cmp_ps(length_sqr, _mm256_set1_ps(minTangentLength), _CMP_LE_OQ);
+            tangent_x = _mm256_blendv_ps(tangent_x, chord_x, use_chord);
+            tangent_y = _mm256_blendv_ps(tangent_y, chord_y, use_chord);
+            length_sqr = _mm256_blendv_ps(length_sqr, _mm256_add_ps(_mm256_mul_ps(chord_x, chord_x), _mm256_mul_ps(chord_y, chord_y)), use_chord);
+
+            const __m256 is_nonzero = _mm256_cmp_ps(length_sqr, _mm256_setzero_ps(), _CMP_GT_OQ);
+            const __m256 inv_length = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(length_sqr)), is_nonzero);
+            _mm256_storeu_ps(out.tangentX + first_query, _mm256_mul_ps(tangent_x, inv_length));
+            _mm256_storeu_ps(out.tangentY + first_query, _mm256_mul_ps(tangent_y, inv_length));
+        }
+    }
+#endif
+}
+
+namespace curve_kernel
+{
+    uint32_t StepCount(float smooth_factor)
+    {
+        uint32_t n_steps = 1;
+
+        if (smooth_factor > 1.0f) // also false for nan
+        {
+            n_steps = static_cast<uint32_t>(std::ceil(std::min(smooth_factor, static_cast<float>(maxStepCount)) - epsilon));
+        }
+
+        return std::max(n_steps, uint32_t(1));
+    }
+
+    template<size_t Degree>
+    void Evaluate(const Bezier<Degree, float> & segment, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        evaluate<Degree>(powerBasis<Degree>(segment), segment.End(), n_steps, InterleavedOut{out});
+    }
+
+    template void Evaluate<1>(const Bezier<1, float> & segment, uint32_t n_steps, std::array<float, 2> * out);
+    template void Evaluate<2>(const Bezier<2, float> & segment, uint32_t n_steps, std::array<float, 2> * out);
+    template void Evaluate<3>(const Bezier<3, float> & segment, uint32_t n_steps, std::array<float, 2> * out);
+    template void Evaluate<4>(const Bezier<4, float> & segment, uint32_t n_steps, std::array<float, 2> * out);
+    template void Evaluate<5>(const Bezier<5, float> & segment, uint32_t n_steps, std::array<float, 2> * out);
+
+    void EvaluateBezier(std::span<const std::array<float, 2>> points, uint32_t n_steps, std::array<float, 2> * out)
+    {
+#if CURVE_KERNEL_AVX
+        if (ActiveIsa() >= KERNEL_ISA::AVX2)
+        {
+            evaluateBezierAvx2(points, n_steps, out);
+        }
+        else
+#endif
+        {
+            evaluateBezierBlocks(points, n_steps, out);
+        }
+
+        // pinned like the other kernels so segments join exactly
+        out[n_steps] = points.back();
+    }
+
+    void EvaluateLinear(const std::array<float, 2> & a, const std::array<float, 2> & b, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        Evaluate<1>({{a, b}}, n_steps, out);
+    }
+
+    void EvaluateQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        Evaluate<2>({{a, b, c}}, n_steps, out);
+    }
+
+    void EvaluateCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        Evaluate<3>({{a, b, c, d}}, n_steps, out);
+    }
+
+    void EvaluateLinearSoa(const std::array<float, 2> & a, const std::array<float, 2> & b, uint32_t n_steps, float * out_x, float * out_y)
+    {
+        evaluate<1>(powerBasis<1>({{a, b}}), b, n_steps, SplitOut{out_x, out_y});
+    }
+
+    void EvaluateQuadraticSoa(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, uint32_t n_steps, float * out_x, float * out_y)
+    {
+        evaluate<2>(powerBasis<2>({{a, b, c}}), c, n_steps, SplitOut{out_x, out_y});
+    }
+
+    void EvaluateCubicSoa(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, uint32_t n_steps, float * out_x, float * out_y)
+    {
+        evaluate<3>(powerBasis<3>({{a, b, c, d}}), d, n_steps, SplitOut{out_x, out_y});
+    }
+
+    void ForwardDifferenceQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        forwardDifference<2>(powerBasis<2>({{a, b, c}}), c, n_steps, out);
+    }
+
+    void ForwardDifferenceCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, uint32_t n_steps, std::array<float, 2> * out)
+    {
+        forwardDifference<3>(powerBasis<3>({{a, b, c, d}}), d, n_steps, out);
+    }
+
+    void FlattenQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, float tolerance, std::vector<std::array<float, 2>> & out)
+    {
+        tolerance = std::max(tolerance, min_flatness_tolerance);
+
+        out.push_back(a);
+        flattenQuadratic(a, b, c, tolerance * tolerance, 0, out);
+    }
+
+    void FlattenCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, float tolerance, std::vector<std::array<float, 2>> & out)
+    {
+        tolerance = std::max(tolerance, min_flatness_tolerance);
+
+        out.push_back(a);
+        flattenCubic(a, b, c, d, tolerance * tolerance, 0, out);
+    }
+
+    void FlattenBezier(std::span<const std::array<float, 2>> points, float tolerance, std::vector<std::array<float, 2>> & out)
+    {
+        tolerance = std::max(tolerance, min_flatness_tolerance);
+
+        out.push_back(points.front());
+        flattenBezier(points, tolerance * tolerance, 0, out);
+    }
+
+    CurveBounds BoundsLinear(const std::array<float, 2> & a, const std::array<float, 2> & b)
+    {
+        CurveBounds bounds;
+        bounds.Expand(a);
+        bounds.Expand(b);
+        return bounds;
+    }
+
+    CurveBounds BoundsQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c)
+    {
+        CurveBounds bounds = BoundsLinear(a, c);
+
+        for (size_t axis=0; axis<2; axis++)
+        {
+            double p0 = a[axis], p1 = b[axis], p2 = c[axis];
+            double denominator = p0 - (2.0 * p1) + p2;
+
+            if (denominator != 0.0)
+            {
+                double t = (p0 - p1) / denominator;
+                if ((t > 0.0) && (t < 1.0))
+                {
+                    double mt = 1.0 - t;
+                    float value = static_cast<float>((mt * mt * p0) + (2.0 * mt * t * p1) + (t * t * p2));
+                    bounds.min[axis] = std::min(bounds.min[axis], value);
+                    bounds.max[axis] = std::max(bounds.max[axis], value);
+                }
+            }
+        }
+
+        return bounds;
+    }
+
+    CurveBounds BoundsCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d)
+    {
+        CurveBounds bounds = BoundsLinear(a, d);
+
+        for (size_t axis=0; axis<2; axis++)
+        {
+            double p0 = a[axis], p1 = b[axis], p2 = c[axis], p3 = d[axis];
+
+            // derivative / 3 in power basis
+            double roots[2];
+            size_t n_roots = derivativeRoots((-p0 + (3.0 * p1) - (3.0 * p2) + p3), (2.0 * (p0 - (2.0 * p1) + p2)), (p1 - p0), roots);
+
+            for (size_t i=0; i<n_roots; i++)
+            {
+                double t = roots[i];
+                double mt = 1.0 - t;
+                float value = static_cast<float>((mt * mt * mt * p0) + (3.0 * mt * mt * t * p1) + (3.0 * mt * t * t * p2) + (t * t * t * p3));
+                bounds.min[axis] = std::min(bounds.min[axis], value);
+                bounds.max[axis] = std::max(bounds.max[axis], value);
+            }
+        }
+
+        return bounds;
+    }
+
+    float ClosestLinear(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & point)
+    {
+        double dx = static_cast<double>(b[0]) - a[0];
+        double dy = static_cast<double>(b[1]) - a[1];
+        double length_sqr = (dx * dx) + (dy * dy);
+
+        if (length_sqr <= 0.0)
+        {
+            return 0.0f;
+        }
+
+        double t = (((static_cast<double>(point[0]) - a[0]) * dx) + ((static_cast<double>(point[1]) - a[1]) * dy)) / length_sqr;
+        return static_cast<float>(std::clamp(t, 0.0, 1.0));
+    }
+
+    float ClosestQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & point)
+    {
+        std::array<double, 2> coefficients[3];
+        for (size_t axis=0; axis<2; axis++)
+        {
+            double p0 = a[axis], p1 = b[axis], p2 = c[axis];
+            coefficients[0][axis] = p0 - point[axis];
+            coefficients[1][axis] = 2.0 * (p1 - p0);
+            coefficients[2][axis] = p0 - (2.0 * p1) + p2;
+        }
+
+        return closestParameter(coefficients, 2);
+    }
+
+    float ClosestCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, const std::array<float, 2> & point)
+    {
+        std::array<double, 2> coefficients[4];
+        for (size_t axis=0; axis<2; axis++)
+        {
+            double p0 = a[axis], p1 = b[axis], p2 = c[axis], p3 = d[axis];
+            coefficients[0][axis] = p0 - point[axis];
+            coefficients[1][axis] = 3.0 * (p1 - p0);
+            coefficients[2][axis] = 3.0 * (p0 - (2.0 * p1) + p2);
+            coefficients[3][axis] = -p0 + (3.0 * p1) - (3.0 * p2) + p3;
+        }
+
+        return closestParameter(coefficients, 3);
+    }
+
+    CurveBounds BoundsBezier(std::span<const std::array<float, 2>> points)
+    {
+        switch (points.size())
+        {
+            case 2:
+                return BoundsLinear(points[0], points[1]);
+
+            case 3:
+                return BoundsQuadratic(points[0], points[1], points[2]);
+
+            case 4:
+                return BoundsCubic(points[0], points[1], points[2], points[3]);
+
+            default:
+                break;
+        }
+
+        CurveBounds bounds = BoundsLinear(points.front(), points.back());
+        const size_t degree = points.size() - 1;
+
+        for (size_t axis=0; axis<2; axis++)
+        {
+            // the segment stays inside its control points, if none of them is beyond the end points on this axis
+            // the end points bound it
+            const auto [lo, hi] = std::minmax(points.front()[axis], points.back()[axis]);
+            if (std::all_of(points.begin() + 1, points.end() - 1, [&](const std::array<float, 2> & p){ return (p[axis] >= lo) && (p[axis] <= hi); }))
+            {
+                continue;
+            }
+
+            double coefficients[bezier::maxDegree + 1];
+            powerBasisAxis(points, axis, 0.0, coefficients);
+
+            // the extremes of the axis are where its derivative is 0
+            DistancePolynomial derivative;
+            derivative.degree = degree - 1;
+            for (size_t k=0; k<degree; k++)
+            {
+                derivative.power[k] = static_cast<double>(k + 1) * coefficients[k + 1];
+            }
+            toBernstein(derivative);
+
+            isolateRoots(derivative, derivative.bernstein, 0.0, 1.0, 0, [&](double t)
+            {
+                double value = 0.0;
+                for (size_t k=degree+1; k>0; k--)
+                {
+                    value = (value * t) + coefficients[k - 1];
+                }
+
+                bounds.min[axis] = std::min(bounds.min[axis], static_cast<float>(value));
+                bounds.max[axis] = std::max(bounds.max[axis], static_cast<float>(value));
+            });
+        }
+
+        return bounds;
+    }
+
+    float ClosestBezier(std::span<const std::array<float, 2>> points, const std::array<float, 2> & point)
+    {
+        if (points.size() == 2)
+        {
+            return ClosestLinear(points[0], points[1], point);
+        }
+
+        const size_t degree = points.size() - 1;
+        double axis_coefficients[2][bezier::maxDegree + 1];
+        powerBasisAxis(points, 0, point[0], axis_coefficients[0]);
+        powerBasisAxis(points, 1, point[1], axis_coefficients[1]);
+
+        std::array<double, 2> coefficients[bezier::maxDegree + 1];
+        for (size_t k=0; k<=degree; k++)
+        {
+            coefficients[k] = {axis_coefficients[0][k], axis_coefficients[1][k]};
+        }
+
+        return closestParameter(coefficients, degree);
+    }
+
+    void SampleBatch(const BezierBatch & batch, const uint32_t * segments, const float * t, size_t n_queries, const PathSamples & out, size_t first_query)
+    {
+        size_t i = 0;
+
+#if CURVE_KERNEL_AVX
+        if (ActiveIsa() >= KERNEL_ISA::AVX2)
+        {
+            for (; (i + 8)<=n_queries; i+=8)
+            {
+                sampleBatchAvx2(batch, segments + i, t + i, out, first_query + i);
+            }
+        }
+#endif
+
+        sampleBatchScalar(batch, segments + i, t + i, n_queries - i, out, first_query + i);
+    }
+
+    KERNEL_ISA ActiveIsa()
+    {
+        return activeIsa.load(std::memory_order_relaxed);
+    }
+
+    void ForceIsa(KERNEL_ISA isa)
+    {
+        activeIsa.store(std::min(isa, supportedIsa), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Curve.h"
+#include "Bezier.h"
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+enum class KERNEL_ISA : uint16_t {SCALAR, SSE2, AVX2, AVX512};
+
+namespace curve_kernel
+{
+    constexpr uint32_t maxStepCount = 1 << 16; // upper limit of steps a single segment is divided into
+    uint32_t StepCount(float smooth_factor); // number of uniform steps a segment is divided into for a given smooth factor (at least 1)
+
+    // evaluate n_steps + 1 points of a single segment at t = i / n_steps and write them to out.
+    // the segment is converted to power basis and evaluated with horner's method, several parameter values at a time
+    void EvaluateLinear(const std::array<float, 2> & a, const std::array<float, 2> & b, uint32_t n_steps, std::array<float, 2> * out);
+    void EvaluateQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, uint32_t n_steps, std::array<float, 2> * out);
+    void EvaluateCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, uint32_t n_steps, std::array<float, 2> * out);
+
+    // the same for a segment of the bezier core (Degree 1 to maxHornerDegree, instantiated in CurveKernel.cpp). the
+    // power basis of higher degrees loses too much precision in float, those use EvaluateBezier
+    constexpr size_t maxHornerDegree = 5;
+    template<size_t Degree>
+    void Evaluate(const Bezier<Degree, float> & segment, uint32_t n_steps, std::array<float, 2> * out);
+
+    // the same samples for a segment whose degree is only known at runtime (points.size() - 1, up to
+    // bezier::maxDegree). de casteljau on bezierBlockSize parameter values at a time, every control point of the block
+    // is a short array the compiler vectorizes the lerps over
+    constexpr size_t bezierBlockSize = 16;
+    void EvaluateBezier(std::span<const std::array<float, 2>> points, uint32_t n_steps, std::array<float, 2> * out);
+
+    // same samples written to separate x and y arrays (n_steps + 1 entries each), which saves interleaving the results
+    // of the simd paths. bit identical to the functions above
+    void EvaluateLinearSoa(const std::array<float, 2> & a, const std::array<float, 2> & b, uint32_t n_steps, float * out_x, float * out_y);
+    void EvaluateQuadraticSoa(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, uint32_t n_steps, float * out_x, float * out_y);
+    void EvaluateCubicSoa(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, uint32_t n_steps, float * out_x, float * out_y);
+
+    // same sampling as above using forward differencing (adds only between re-seeds)
+    constexpr size_t forwardDifferenceReseed = 32; // number of samples generated before the differences are re-seeded to bound float drift
+    void ForwardDifferenceQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, uint32_t n_steps, std::array<float, 2> * out);
+    void ForwardDifferenceCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, uint32_t n_steps, std::array<float, 2> * out);
+
+    // adaptive flattening: split the segment in half until its control polygon is within tolerance (in curve units,
+    // which are pixels on screen) of the chord. appends the start point and the end point of every flat piece to out
+    constexpr int32_t flattenMaxDepth = 16; // max number of times a segment is split
+    void FlattenQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, float tolerance, std::vector<std::array<float, 2>> & out);
+    void FlattenCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, float tolerance, std::vector<std::array<float, 2>> & out);
+    void FlattenBezier(std::span<const std::array<float, 2>> points, float tolerance, std::vector<std::array<float, 2>> & out); // any degree up to bezier::maxDegree
+
+    // tight axis aligned bounds of a single segment from its end points and the points where the derivative of x or y
+    // is 0, instead of the bounds of the control points
+    CurveBounds BoundsLinear(const std::array<float, 2> & a, const std::array<float, 2> & b);
+    CurveBounds BoundsQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c);
+    CurveBounds BoundsCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d);
+    CurveBounds BoundsBezier(std::span<const std::array<float, 2>> points); // any degree up to bezier::maxDegree
+
+    // parameter t of the point on a single segment closest to point. the roots of the derivative of the squared
+    // distance are isolated and polished with newton's method, so this is exact rather than the closest sample
+    float ClosestLinear(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & point);
+    float ClosestQuadratic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & point);
+    float ClosestCubic(const std::array<float, 2> & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const std::array<float, 2> & d, const std::array<float, 2> & point);
+    float ClosestBezier(std::span<const std::array<float, 2>> points, const std::array<float, 2> & point); // any degree up to bezier::maxDegree
+
+    // segments of mixed degrees raised to one degree (bezier::Elevate, exact), so a batch of queries on different
+    // segments runs the same de casteljau steps in every simd lane. control point k of segment i is at
+    // x[(k * count) + i] and y[(k * count) + i]
+    struct BezierBatch
+    {
+        size_t degree = 0;
+        size_t count = 0; // segments
+        std::vector<float> x;
+        std::vector<float> y;
+    };
+
+    // position and unit tangent of n_queries queries, query i at parameter t[i] of segment segments[i] of batch,
+    // written to out at first_query + i. 8 queries at a time with avx2 (a gather of every control point), bit
+    // identical to the scalar path
+    void SampleBatch(const BezierBatch & batch, const uint32_t * segments, const float * t, size_t n_queries, const PathSamples & out, size_t first_query);
+
+    KERNEL_ISA ActiveIsa(); // instruction set used by the evaluate functions (detected at runtime)
+    void ForceIsa(KERNEL_ISA isa); // override the detected instruction set. clamped to what the cpu supports
+}
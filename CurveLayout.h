@@ -0,0 +1,356 @@
+#pragma once
+
+#include "Curve.h"
+#include "Bezier.h"
+#include "CurveKernel.h"
+#include "CurveArcLength.h"
+
+#include <span>
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+// the segment kernels of the curve classes, resolved at compile time. a curve class of one work type reads point lists
+// of every data type: hintLayouts describes for each (work type, data type) pair which points of the point list make up
+// a generated segment and its handles, and Interpolate generates the segments of a pair as Bezier<degree of the work
+// type> without looking at the types again. how a segment is tessellated is picked once per interpolation from
+// tessellateKernels instead of per segment
+namespace curve_layout
+{
+    constexpr size_t Degree(CURVE_TYPE curve_type)
+    {
+        return (curve_type == CURVE_TYPE::CUBIC) ? 3 : ((curve_type == CURVE_TYPE::QUADRATIC) ? 2 : 1);
+    }
+
+    template<CURVE_TYPE WorkType>
+    using Segment = Bezier<Degree(WorkType), float>;
+
+    constexpr size_t maxHandles = 8; // handle points a segment generates at most
+
+    // how the generated segments of a work type are taken from a point list of a data type. a data segment is the
+    // stride + 1 points of the point list starting at first + (segment * stride), the closing segment wraps around
+    // from the end of the point list to its start (negative entries of closing count from the end)
+    struct HintLayout
+    {
+        bool isGenerated = false; // the control points aren't in the point list (linear data read as a curve), the curve class generates them itself
+        uint32_t stride = 1; // points between the starts of two data segments (the degree of the data type)
+        uint32_t first = 0; // point the first data segment starts at
+        uint32_t insert = 0; // point of a data segment passed to InsertAnchor to insert an anchor into it, relative to its start
+        uint32_t minPoints = 0; // points needed to generate any segment
+        uint32_t minClosedPoints = 0; // the loop is only closed with more points than this
+        std::array<int32_t, 4> closing = {}; // data segment closing the loop
+        std::array<uint32_t, 4> controls = {}; // control points of a generated segment, indices into its data segment
+        uint32_t nHandles = 0;
+        std::array<int32_t, maxHandles> handles = {}; // handle points generated per segment, relative to the start of its data segment
+        uint32_t minShortPoints = 0; // a point list below minPoints but with at least this many points draws shortHandles instead
+        uint32_t nShortHandles = 0;
+        std::array<uint32_t, 4> shortHandles = {};
+    };
+
+    // indexed by [work type][data type]. UNKNOWN data is read as linear
+    inline constexpr std::array<std::array<HintLayout, 4>, 4> hintLayouts = []()
+    {
+        constexpr auto linear_data = [](HintLayout layout)
+        {
+            layout.stride = 1;
+            layout.first = 0;
+            layout.insert = 1;
+            layout.closing = {-1, 0};
+            return layout;
+        };
+        constexpr auto quadratic_data = [](HintLayout layout)
+        {
+            layout.stride = 2;
+            layout.first = 0;
+            layout.insert = 2;
+            layout.closing = {-2, -1, 0};
+            return layout;
+        };
+        constexpr auto cubic_data = [](HintLayout layout)
+        {
+            // the point list starts with the left handle of the first anchor
+            layout.stride = 3;
+            layout.first = 1;
+            layout.insert = 1;
+            layout.closing = {-2, -1, 0, 1};
+            return layout;
+        };
+
+        std::array<std::array<HintLayout, 4>, 4> layouts = {};
+
+        constexpr size_t linear = static_cast<size_t>(CURVE_TYPE::LINEAR);
+        constexpr size_t quadratic = static_cast<size_t>(CURVE_TYPE::QUADRATIC);
+        constexpr size_t cubic = static_cast<size_t>(CURVE_TYPE::CUBIC);
+
+        // cubic curve: the anchors and handles as they are, quadratic controls doubled up. from linear data the
+        // handles are generated
+        layouts[cubic][linear] = {.isGenerated = true};
+        layouts[cubic][quadratic] = quadratic_data({.minPoints = 4, .minClosedPoints = 4, .controls = {0, 1, 1, 2}, .nHandles = 8, .handles = {0, 1, 1, 1, 2, 1, 2, 3},
+                                                    .minShortPoints = 3, .nShortHandles = 4, .shortHandles = {1, 0, 1, 2}});
+        layouts[cubic][cubic] = cubic_data({.minPoints = 4, .minClosedPoints = 6, .controls = {0, 1, 2, 3}, .nHandles = 8, .handles = {0, -1, 0, 1, 3, 2, 3, 4},
+                                            .minShortPoints = 3, .nShortHandles = 4, .shortHandles = {1, 0, 1, 2}});
+
+        // quadratic curve: the handles of cubic data meet at the left handle
+        layouts[quadratic][linear] = {.isGenerated = true};
+        layouts[quadratic][quadratic] = quadratic_data({.minPoints = 4, .minClosedPoints = 4, .controls = {0, 1, 2}, .nHandles = 4, .handles = {0, 1, 2, 3},
+                                                        .minShortPoints = 2, .nShortHandles = 2, .shortHandles = {0, 1}});
+        layouts[quadratic][cubic] = cubic_data({.minPoints = 4, .minClosedPoints = 5, .controls = {0, 1, 3}, .nHandles = 4, .handles = {0, 1, 3, 4},
+                                                .minShortPoints = 3, .nShortHandles = 2, .shortHandles = {1, 2}});
+
+        // linear curve: the chords between the anchors, no handles
+        layouts[linear][linear] = linear_data({.minPoints = 2, .minClosedPoints = 2, .controls = {0, 1}, .minShortPoints = 1});
+        layouts[linear][quadratic] = quadratic_data({.minPoints = 4, .minClosedPoints = 4, .controls = {0, 2}});
+        layouts[linear][cubic] = cubic_data({.minPoints = 4, .minClosedPoints = 6, .controls = {0, 3}});
+
+        for (size_t work=0; work<4; work++)
+        {
+            layouts[work][static_cast<size_t>(CURVE_TYPE::UNKNOWN)] = layouts[work][linear];
+        }
+        layouts[static_cast<size_t>(CURVE_TYPE::UNKNOWN)] = layouts[linear];
+
+        return layouts;
+    }();
+
+    template<CURVE_TYPE WorkType, CURVE_TYPE DataType>
+    constexpr const HintLayout & layoutOf = hintLayouts[static_cast<size_t>(WorkType)][static_cast<size_t>(DataType)];
+
+    // number of open segments of a point list
+    template<CURVE_TYPE WorkType, CURVE_TYPE DataType>
+    size_t SegmentCount(const PointList & points)
+    {
+        constexpr const HintLayout & layout = layoutOf<WorkType, DataType>;
+        return (points.size() >= layout.minPoints) ? ((points.size() / layout.stride) - 1) : 0;
+    }
+
+    // true if a segment from the end of the point list to its start is generated
+    template<CURVE_TYPE WorkType, CURVE_TYPE DataType>
+    bool HasClosingSegment(const CurveData & curve_data)
+    {
+        constexpr const HintLayout & layout = layoutOf<WorkType, DataType>;
+        return curve_data.isCloseLoop && (curve_data.pointList.size() >= layout.minPoints) && (curve_data.pointList.size() > layout.minClosedPoints);
+    }
+
+    // index to pass to InsertAnchor to insert an anchor into a generated segment of a point list of data_type
+    // (noInsertIndex for the closing segment). every hint generates the segments in the order of the data segments, so
+    // this is the same for every work type. data types past the table are read like the curve classes read them (as the
+    // last one)
+    inline uint32_t InsertIndex(CURVE_TYPE data_type, const PointList & points, size_t segment)
+    {
+        const size_t data = std::min(static_cast<size_t>(data_type), hintLayouts.size() - 1);
+        const HintLayout & layout = hintLayouts[data][data];
+        const size_t n_segments = (points.size() >= layout.minPoints) ? ((points.size() / layout.stride) - 1) : 0;
+
+        return (segment < n_segments) ? static_cast<uint32_t>(layout.first + (segment * layout.stride) + layout.insert) : noInsertIndex;
+    }
+
+    // index of the point control of segment is (SegmentCount is the closing segment)
+    template<CURVE_TYPE WorkType, CURVE_TYPE DataType>
+    size_t SegmentPoint(const PointList & points, size_t segment, size_t control)
+    {
+        constexpr const HintLayout & layout = layoutOf<WorkType, DataType>;
+        const uint32_t offset = layout.controls[control];
+
+        if (segment < SegmentCount<WorkType, DataType>(points))
+        {
+            return layout.first + (segment * layout.stride) + offset;
+        }
+
+        const int32_t closing = layout.closing[offset];
+        return (closing < 0) ? (points.size() + closing) : static_cast<size_t>(closing);
+    }
+
+    template<CURVE_TYPE WorkType, CURVE_TYPE DataType>
+    Segment<WorkType> SegmentAt(const PointList & points, size_t segment)
+    {
+        return [&]<size_t... I>(std::index_sequence<I...>)
+        {
+            return Segment<WorkType>{{points[SegmentPoint<WorkType, DataType>(points, segment, I)]...}};
+        }(std::make_index_sequence<Degree(WorkType) + 1>{});
+    }
+
+    // append the handle points of an open segment to out
+    template<CURVE_TYPE WorkType, CURVE_TYPE DataType>
+    void AppendHandles(const PointList & points, size_t segment, std::vector<std::array<float, 2>> & out)
+    {
+        constexpr const HintLayout & layout = layoutOf<WorkType, DataType>;
+        const size_t start = layout.first + (segment * layout.stride);
+
+        for (size_t i=0; i<layout.nHandles; i++)
+        {
+            out.push_back(points[static_cast<size_t>(static_cast<int64_t>(start) + layout.handles[i])]);
+        }
+    }
+
+    // generate every segment of the point list: append_segment is called with each segment (the closing segment last)
+    // and the handles are appended to handles_out. a point list too short for a segment only draws the handles of its
+    // first anchor
+    template<CURVE_TYPE WorkType, CURVE_TYPE DataType, typename AppendSegment>
+    void Interpolate(const CurveData & curve_data, uint32_t n_steps, std::vector<std::array<float, 2>> & curve_out, std::vector<std::array<float, 2>> & handles_out, AppendSegment && append_segment)
+    {
+        constexpr const HintLayout & layout = layoutOf<WorkType, DataType>;
+        static_assert(!layout.isGenerated, "the control points of this pair are generated by the curve class");
+
+        const PointList & points = curve_data.pointList;
+
+        if (points.size() >= layout.minPoints)
+        {
+            const size_t n_segments = SegmentCount<WorkType, DataType>(points);
+
+            curve_out.reserve((n_segments + 1) * (static_cast<size_t>(n_steps) + 1)); // + 1 for the segment closing the loop
+            handles_out.reserve(n_segments * maxHandles);
+
+            for (size_t i=0; i<n_segments; i++)
+            {
+                append_segment(SegmentAt<WorkType, DataType>(points, i));
+
+                if (curve_data.areHandlesGenerated)
+                {
+                    AppendHandles<WorkType, DataType>(points, i, handles_out);
+                }
+            }
+
+            if (HasClosingSegment<WorkType, DataType>(curve_data))
+            {
+                append_segment(SegmentAt<WorkType, DataType>(points, n_segments));
+            }
+        }
+        else if ((points.size() >= layout.minShortPoints) && curve_data.areHandlesGenerated)
+        {
+            for (size_t i=0; i<layout.nShortHandles; i++)
+            {
+                handles_out.push_back(points[layout.shortHandles[i]]);
+            }
+        }
+        else
+        {
+            std::cerr << "no curve data available or not enough data points!\n";
+        }
+    }
+
+    // tessellate a segment to the end of out
+    template<size_t Degree>
+    using TessellateKernel = void (*)(const Bezier<Degree, float> & segment, uint32_t n_steps, float flatness_tolerance, std::vector<std::array<float, 2>> & out);
+
+    template<size_t Degree, TESSELLATION_MODE Mode>
+    void Tessellate(const Bezier<Degree, float> & segment, uint32_t n_steps, float flatness_tolerance, std::vector<std::array<float, 2>> & out)
+    {
+        const std::array<std::array<float, 2>, Degree + 1> & p = segment.points;
+
+        if constexpr ((Mode == TESSELLATION_MODE::ADAPTIVE) && (Degree == 1))
+        {
+            // a line is always flat, only the end points are needed
+            out.push_back(p[0]);
+            out.push_back(p[1]);
+        }
+        else if constexpr ((Mode == TESSELLATION_MODE::ADAPTIVE) && (Degree == 2))
+        {
+            curve_kernel::FlattenQuadratic(p[0], p[1], p[2], flatness_tolerance, out);
+        }
+        else if constexpr (Mode == TESSELLATION_MODE::ADAPTIVE)
+        {
+            curve_kernel::FlattenCubic(p[0], p[1], p[2], p[3], flatness_tolerance, out);
+        }
+        else
+        {
+            size_t curve_offset = out.size();
+            out.resize(curve_offset + n_steps + 1);
+
+            if constexpr ((Mode == TESSELLATION_MODE::FORWARD_DIFFERENCE) && (Degree == 2))
+            {
+                curve_kernel::ForwardDifferenceQuadratic(p[0], p[1], p[2], n_steps, out.data() + curve_offset);
+            }
+            else if constexpr ((Mode == TESSELLATION_MODE::FORWARD_DIFFERENCE) && (Degree == 3))
+            {
+                curve_kernel::ForwardDifferenceCubic(p[0], p[1], p[2], p[3], n_steps, out.data() + curve_offset);
+            }
+            else if constexpr ((Mode == TESSELLATION_MODE::ARC_LENGTH) && (Degree == 2))
+            {
+                curve_arc_length::SampleEvenly(curve_arc_length::FromQuadratic(p[0], p[1], p[2]), n_steps, out.data() + curve_offset);
+            }
+            else if constexpr ((Mode == TESSELLATION_MODE::ARC_LENGTH) && (Degree == 3))
+            {
+                curve_arc_length::SampleEvenly({p[0], p[1], p[2], p[3]}, n_steps, out.data() + curve_offset);
+            }
+            else
+            {
+                // TESSELLATION_MODE::UNIFORM, and lines in every mode (uniform steps along a line are equally far apart)
+                curve_kernel::Evaluate<Degree>(segment, n_steps, out.data() + curve_offset);
+            }
+        }
+    }
+
+    // indexed by TESSELLATION_MODE
+    template<size_t Degree>
+    constexpr std::array<TessellateKernel<Degree>, 4> tessellateKernels = {&Tessellate<Degree, TESSELLATION_MODE::UNIFORM>, &Tessellate<Degree, TESSELLATION_MODE::FORWARD_DIFFERENCE>,
+                                                                           &Tessellate<Degree, TESSELLATION_MODE::ADAPTIVE>, &Tessellate<Degree, TESSELLATION_MODE::ARC_LENGTH>};
+
+    template<size_t Degree>
+    TessellateKernel<Degree> SelectTessellateKernel(TESSELLATION_MODE mode)
+    {
+        const size_t index = static_cast<size_t>(mode);
+        return tessellateKernels<Degree>[(index < tessellateKernels<Degree>.size()) ? index : 0];
+    }
+
+    // tessellate a segment of any degree (its control points) to the end of out. segments up to cubic go through
+    // Tessellate, quartics and quintics through the compile-time Evaluate and higher degrees through the blocked runtime
+    // de casteljau of EvaluateBezier. above cubic there is no forward difference or arc length kernel, those modes sample
+    // in uniform steps
+    using BezierTessellateKernel = void (*)(std::span<const std::array<float, 2>> points, uint32_t n_steps, float flatness_tolerance, std::vector<std::array<float, 2>> & out);
+
+    template<size_t Degree, TESSELLATION_MODE Mode>
+    void TessellateBezier(std::span<const std::array<float, 2>> points, uint32_t n_steps, float flatness_tolerance, std::vector<std::array<float, 2>> & out)
+    {
+        if constexpr (Degree == 0)
+        {
+            out.insert(out.end(), static_cast<size_t>(n_steps) + 1, points[0]); // not a segment, kept so the table is indexed by degree
+        }
+        else if constexpr (Degree <= 3)
+        {
+            Bezier<Degree, float> segment;
+            std::copy_n(points.begin(), Degree + 1, segment.points.begin());
+            Tessellate<Degree, Mode>(segment, n_steps, flatness_tolerance, out);
+        }
+        else if constexpr (Mode == TESSELLATION_MODE::ADAPTIVE)
+        {
+            curve_kernel::FlattenBezier(points, flatness_tolerance, out);
+        }
+        else
+        {
+            size_t curve_offset = out.size();
+            out.resize(curve_offset + n_steps + 1);
+
+            if constexpr (Degree <= curve_kernel::maxHornerDegree)
+            {
+                Bezier<Degree, float> segment;
+                std::copy_n(points.begin(), Degree + 1, segment.points.begin());
+                curve_kernel::Evaluate<Degree>(segment, n_steps, out.data() + curve_offset);
+            }
+            else
+            {
+                curve_kernel::EvaluateBezier(points, n_steps, out.data() + curve_offset);
+            }
+        }
+    }
+
+    using BezierTessellateKernels = std::array<BezierTessellateKernel, bezier::maxDegree + 1>; // indexed by degree
+
+    template<TESSELLATION_MODE Mode>
+    constexpr BezierTessellateKernels bezierKernelsFor = []<size_t... D>(std::index_sequence<D...>)
+    {
+        return BezierTessellateKernels{&TessellateBezier<D, Mode>...};
+    }(std::make_index_sequence<bezier::maxDegree + 1>{});
+
+    // indexed by TESSELLATION_MODE
+    constexpr std::array<const BezierTessellateKernels *, 4> bezierTessellateKernels = {&bezierKernelsFor<TESSELLATION_MODE::UNIFORM>, &bezierKernelsFor<TESSELLATION_MODE::FORWARD_DIFFERENCE>,
+                                                                                        &bezierKernelsFor<TESSELLATION_MODE::ADAPTIVE>, &bezierKernelsFor<TESSELLATION_MODE::ARC_LENGTH>};
+
+    inline const BezierTessellateKernels & SelectBezierKernels(TESSELLATION_MODE mode)
+    {
+        const size_t index = static_cast<size_t>(mode);
+        return *bezierTessellateKernels[(index < bezierTessellateKernels.size()) ? index : 0];
+    }
+}
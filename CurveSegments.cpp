@@ -0,0 +1,118 @@
+#include "CurveSegments.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // overwrite the range [begin, begin + old_size) of list with the values, growing or shrinking the list in place
+    template<typename T, typename Iterator>
+    void replaceRange(std::vector<T> & list, size_t begin, size_t old_size, Iterator values, size_t new_size)
+    {
+        const size_t n_copy = std::min(old_size, new_size);
+        std::copy(values, values + n_copy, list.begin() + begin);
+
+        if (new_size > old_size)
+        {
+            list.insert(list.begin() + begin + old_size, values + old_size, values + new_size);
+        }
+        else if (new_size < old_size)
+        {
+            list.erase(list.begin() + begin + new_size, list.begin() + begin + old_size);
+        }
+    }
+
+    // iterator adding a fixed offset to each segment start so the new offsets can be copied without a temporary list
+    struct OffsetIterator
+    {
+        std::vector<size_t>::const_iterator it;
+        size_t base = 0;
+
+        size_t operator*() const { return base + *it; }
+        OffsetIterator & operator++() { ++it; return *this; }
+        OffsetIterator operator+(size_t n) const { return {it + static_cast<std::ptrdiff_t>(n), base}; }
+        std::ptrdiff_t operator-(const OffsetIterator & rhs) const { return it - rhs.it; }
+        bool operator!=(const OffsetIterator & rhs) const { return it != rhs.it; }
+        bool operator==(const OffsetIterator & rhs) const { return it == rhs.it; }
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_t*;
+        using reference = size_t;
+    };
+}
+
+namespace curve_segments
+{
+    void Splice(std::vector<std::array<float, 2>> & samples, std::vector<size_t> & offsets, size_t first_segment, size_t old_count, const std::vector<std::array<float, 2>> & new_samples, const std::vector<size_t> & new_offsets)
+    {
+        const size_t begin = offsets[first_segment];
+        const size_t end = offsets[first_segment + old_count];
+        const size_t new_count = new_offsets.size();
+
+        replaceRange(samples, begin, (end - begin), new_samples.begin(), new_samples.size());
+        replaceRange(offsets, first_segment, old_count, OffsetIterator{new_offsets.begin(), begin}, new_count);
+
+        // shift the segments (and end marker) following the spliced range
+        if (new_samples.size() != (end - begin))
+        {
+            for (size_t i=(first_segment + new_count); i<offsets.size(); i++)
+            {
+                offsets[i] = (offsets[i] - end) + begin + new_samples.size();
+            }
+        }
+    }
+
+    void CopyStrided(const std::vector<std::array<float, 2>> & samples, size_t first, size_t n_samples, float * out, size_t stride)
+    {
+        auto * out_bytes = reinterpret_cast<unsigned char *>(out);
+
+        for (size_t i=0; i<n_samples; i++)
+        {
+            std::memcpy(out_bytes + (i * stride), samples[first + i].data(), sizeof(std::array<float, 2>));
+        }
+    }
+
+    void EditLog::Record(uint64_t generation, size_t first, size_t old_count, size_t new_count, bool is_handle_edit)
+    {
+        if ((old_count == 0) && (new_count == 0))
+        {
+            return;
+        }
+
+        if (edits.size() >= maxEdits)
+        {
+            firstGeneration = std::max(firstGeneration, edits.front().generation);
+            edits.erase(edits.begin());
+        }
+
+        edits.push_back({generation, first, old_count, new_count, is_handle_edit});
+    }
+
+    void EditLog::Reset(uint64_t generation)
+    {
+        edits.clear();
+        firstGeneration = generation; // a copy made at generation is the regenerated data
+    }
+
+    bool EditLog::Since(uint64_t generation, std::vector<SampleEdit> & out) const
+    {
+        out.clear();
+
+        if (generation < firstGeneration)
+        {
+            return false;
+        }
+
+        for (const SampleEdit & edit : edits)
+        {
+            if (edit.generation > generation)
+            {
+                out.push_back(edit);
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Curve.h"
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <algorithm>
+
+namespace curve_segments
+{
+    // replace the tessellated samples of old_count segments starting at first_segment with the segments in new_samples.
+    // offsets holds the start of every segment in samples followed by the end of the last segment, new_offsets holds
+    // the start of every segment in new_samples. offsets after the spliced range are only shifted when the number of
+    // samples changes
+    void Splice(std::vector<std::array<float, 2>> & samples, std::vector<size_t> & offsets, size_t first_segment, size_t old_count, const std::vector<std::array<float, 2>> & new_samples, const std::vector<size_t> & new_offsets);
+
+    // same as above for lists where every segment has a fixed number of entries (e.g. handles or bounds)
+    template<typename T>
+    void SpliceFixed(std::vector<T> & list, size_t stride, size_t first_segment, size_t old_count, const std::vector<T> & new_items)
+    {
+        const size_t begin = first_segment * stride;
+        const size_t old_size = old_count * stride;
+        const size_t n_copy = std::min(old_size, new_items.size());
+
+        std::copy(new_items.begin(), new_items.begin() + n_copy, list.begin() + begin);
+
+        if (new_items.size() > old_size)
+        {
+            list.insert(list.begin() + begin + old_size, new_items.begin() + old_size, new_items.end());
+        }
+        else if (new_items.size() < old_size)
+        {
+            list.erase(list.begin() + begin + new_items.size(), list.begin() + begin + old_size);
+        }
+    }
+
+    // write the positions of n_samples samples starting at first to out, stride bytes apart (e.g. into the position of
+    // an interleaved vertex layout)
+    void CopyStrided(const std::vector<std::array<float, 2>> & samples, size_t first, size_t n_samples, float * out, size_t stride);
+
+    // bounded log of the edits made to the samples and handles of a curve, so copies of them (like the vertices of
+    // DrawCurve) only need the edited ranges patched instead of being copied again
+    class EditLog
+    {
+        private:
+            std::vector<SampleEdit> edits;
+            uint64_t firstGeneration = 0; // copies older than this have missed edits
+
+        public:
+            static constexpr size_t maxEdits = 64; // older edits are dropped
+
+            void Record(uint64_t generation, size_t first, size_t old_count, size_t new_count, bool is_handle_edit);
+            void Reset(uint64_t generation); // everything was regenerated at generation
+            bool Since(uint64_t generation, std::vector<SampleEdit> & out) const; // edits made after generation in order, false if some are no longer known
+    };
+}
@@ -0,0 +1,397 @@
+#include "CurveStorage.h"
+#include "CurveKernel.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define CURVE_STORAGE_X86 1
+#include <immintrin.h>
+#else
+#define CURVE_STORAGE_X86 0
+#endif
+
+// the avx2 paths are compiled with a target attribute like the curve kernels, the rest of the file keeps the baseline
+#if CURVE_STORAGE_X86 && (defined(__GNUC__) || defined(__clang__))
+#define CURVE_STORAGE_AVX2 1
+#define CURVE_STORAGE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CURVE_STORAGE_AVX2 0
+#define CURVE_STORAGE_TARGET(isa)
+#endif
+
+static_assert((sizeof(SegmentBlock) % curve_storage::alignment) == 0, "segment blocks fill whole cache lines");
+
+namespace
+{
+    constexpr size_t blockWidth = SegmentBlock::blockWidth;
+
+    float distanceSquared(float x, float y, const std::array<float, 2> & point)
+    {
+        const float dx = x - point[0];
+        const float dy = y - point[1];
+        return (dx * dx) + (dy * dy);
+    }
+
+    void nearestScalar(const float * x, const float * y, size_t stride, size_t begin, size_t n_samples, const std::array<float, 2> & point, curve_storage::NearestSample & nearest)
+    {
+        for (size_t i=begin; i<n_samples; i++)
+        {
+            const float distance = distanceSquared(x[i * stride], y[i * stride], point);
+            if (distance < nearest.distanceSquared)
+            {
+                nearest.distanceSquared = distance;
+                nearest.index = static_cast<int64_t>(i);
+            }
+        }
+    }
+
+    bool isNearBounds(const std::array<float, 2> & min, const std::array<float, 2> & max, const std::array<float, 2> & point, float radius)
+    {
+        return (min[0] <= (point[0] + radius)) && (max[0] >= (point[0] - radius)) && (min[1] <= (point[1] + radius)) && (max[1] >= (point[1] - radius));
+    }
+
+    bool isSegmentNear(const SegmentControls & controls, const std::array<float, 2> & point, float radius)
+    {
+        std::array<float, 2> min = controls[0];
+        std::array<float, 2> max = controls[0];
+
+        for (size_t k=1; k<4; k++)
+        {
+            min = {std::min(min[0], controls[k][0]), std::min(min[1], controls[k][1])};
+            max = {std::max(max[0], controls[k][0]), std::max(max[1], controls[k][1])};
+        }
+
+        return isNearBounds(min, max, point, radius);
+    }
+
+#if CURVE_STORAGE_AVX2
+    constexpr size_t nearestChunk = 64; // samples reduced to their minimum distance before it is compared to the nearest so far
+
+    // squared distances of 8 samples. the interleaved layout has to be split into x and y with two shuffles first,
+    // which leaves the samples in the order 0 1 4 5 2 3 6 7 (the shuffles work per 128-bit lane, the order doesn't
+    // matter for the minimum)
+    template<bool IsInterleaved>
+    CURVE_STORAGE_TARGET("avx2")
+    __m256 distances8(const float * x, const float * y, size_t i, __m256 px, __m256 py)
+    {
+        __m256 dx;
+        __m256 dy;
+
+        if constexpr (IsInterleaved)
+        {
+            const __m256 a = _mm256_loadu_ps(x + (i * 2));
+            const __m256 b = _mm256_loadu_ps(x + (i * 2) + 8);
+            dx = _mm256_sub_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), px);
+            dy = _mm256_sub_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), py);
+        }
+        else
+        {
+            dx = _mm256_sub_ps(_mm256_load_ps(x + i), px);
+            dy = _mm256_sub_ps(_mm256_load_ps(y + i), py);
+        }
+
+        return _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    }
+
+    // the minimum of every chunk comes from 4 independent min chains, only a chunk below the nearest distance so far
+    // needs a horizontal minimum. the chunk with the nearest sample is scanned again for the first sample at that
+    // distance, so the result matches the scalar scan. returns the samples done, the rest is left to the scalar scan
+    template<bool IsInterleaved>
+    CURVE_STORAGE_TARGET("avx2")
+    size_t nearestAvx2(const float * x, const float * y, size_t n_samples, const std::array<float, 2> & point, curve_storage::NearestSample & nearest)
+    {
+        const __m256 px = _mm256_set1_ps(point[0]);
+        const __m256 py = _mm256_set1_ps(point[1]);
+        const size_t stride = IsInterleaved ? 2 : 1;
+
+        float best_distance = nearest.distanceSquared;
+        size_t best_chunk = n_samples;
+
+        size_t i = 0;
+        for (; (i + nearestChunk) <= n_samples; i+=nearestChunk)
+        {
+            __m256 m0 = distances8<IsInterleaved>(x, y, i, px, py);
+            __m256 m1 = distances8<IsInterleaved>(x, y, i + 8, px, py);
+            __m256 m2 = distances8<IsInterleaved>(x, y, i + 16, px, py);
+            __m256 m3 = distances8<IsInterleaved>(x, y, i + 24, px, py);
+
+            for (size_t j=32; j<nearestChunk; j+=32)
+            {
+                m0 = _mm256_min_ps(m0, distances8<IsInterleaved>(x, y, i + j, px, py));
+                m1 = _mm256_min_ps(m1, distances8<IsInterleaved>(x, y, i + j + 8, px, py));
+                m2 = _mm256_min_ps(m2, distances8<IsInterleaved>(x, y, i + j + 16, px, py));
+                m3 = _mm256_min_ps(m3, distances8<IsInterleaved>(x, y, i + j + 24, px, py));
+            }
+
+            const __m256 m = _mm256_min_ps(_mm256_min_ps(m0, m1), _mm256_min_ps(m2, m3));
+            if (_mm256_movemask_ps(_mm256_cmp_ps(m, _mm256_set1_ps(best_distance), _CMP_LT_OQ)) != 0)
+            {
+                __m128 low = _mm_min_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+                low = _mm_min_ps(low, _mm_shuffle_ps(low, low, _MM_SHUFFLE(1, 0, 3, 2)));
+                low = _mm_min_ps(low, _mm_shuffle_ps(low, low, _MM_SHUFFLE(2, 3, 0, 1)));
+
+                best_distance = _mm_cvtss_f32(low);
+                best_chunk = i;
+            }
+        }
+
+        if (best_chunk < n_samples)
+        {
+            nearestScalar(x, y, stride, best_chunk, best_chunk + nearestChunk, point, nearest);
+        }
+
+        return i;
+    }
+
+    // a whole block per step: the bounds of the control points of 8 segments from 8 aligned loads
+    CURVE_STORAGE_TARGET("avx2")
+    void segmentsNearAvx2(const SegmentBlocks & segments, const std::array<float, 2> & point, float radius, std::vector<uint32_t> & out)
+    {
+        const __m256 low_x = _mm256_set1_ps(point[0] - radius);
+        const __m256 high_x = _mm256_set1_ps(point[0] + radius);
+        const __m256 low_y = _mm256_set1_ps(point[1] - radius);
+        const __m256 high_y = _mm256_set1_ps(point[1] + radius);
+
+        for (size_t b=0; b<segments.BlockCount(); b++)
+        {
+            const SegmentBlock & block = segments.Blocks()[b];
+
+            __m256 min_x = _mm256_load_ps(block.x[0]);
+            __m256 max_x = min_x;
+            __m256 min_y = _mm256_load_ps(block.y[0]);
+            __m256 max_y = min_y;
+
+            for (size_t k=1; k<4; k++)
+            {
+                const __m256 x = _mm256_load_ps(block.x[k]);
+                const __m256 y = _mm256_load_ps(block.y[k]);
+                min_x = _mm256_min_ps(min_x, x);
+                max_x = _mm256_max_ps(max_x, x);
+                min_y = _mm256_min_ps(min_y, y);
+                max_y = _mm256_max_ps(max_y, y);
+            }
+
+            const __m256 is_near = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(min_x, high_x, _CMP_LE_OQ), _mm256_cmp_ps(max_x, low_x, _CMP_GE_OQ)),
+                                                 _mm256_and_ps(_mm256_cmp_ps(min_y, high_y, _CMP_LE_OQ), _mm256_cmp_ps(max_y, low_y, _CMP_GE_OQ)));
+
+            auto mask = static_cast<uint32_t>(_mm256_movemask_ps(is_near));
+            while (mask != 0)
+            {
+                const size_t segment = (b * blockWidth) + static_cast<size_t>(__builtin_ctz(mask));
+                mask &= mask - 1;
+
+                // the padding lanes repeat the last segment
+                if (segment < segments.size())
+                {
+                    out.push_back(static_cast<uint32_t>(segment));
+                }
+            }
+        }
+    }
+#endif
+}
+
+void PointArrays::Clear()
+{
+    xs.clear();
+    ys.clear();
+}
+
+void PointArrays::Resize(size_t n_points)
+{
+    xs.resize(n_points);
+    ys.resize(n_points);
+}
+
+void PointArrays::Assign(std::span<const std::array<float, 2>> points)
+{
+    Resize(points.size());
+
+    for (size_t i=0; i<points.size(); i++)
+    {
+        xs[i] = points[i][0];
+        ys[i] = points[i][1];
+    }
+}
+
+void PointArrays::Assign(const PointList & points)
+{
+    Resize(points.size());
+
+    size_t i = 0;
+    for (const auto & point : points)
+    {
+        xs[i] = point[0];
+        ys[i] = point[1];
+        i++;
+    }
+}
+
+void PointArrays::Splice(size_t first, size_t old_count, std::span<const std::array<float, 2>> points)
+{
+    const auto end = static_cast<std::ptrdiff_t>(first + old_count);
+    const size_t new_count = points.size();
+
+    if (new_count > old_count)
+    {
+        xs.insert(xs.begin() + end, (new_count - old_count), 0.0f);
+        ys.insert(ys.begin() + end, (new_count - old_count), 0.0f);
+    }
+    else if (new_count < old_count)
+    {
+        const auto new_end = static_cast<std::ptrdiff_t>(first + new_count);
+        xs.erase(xs.begin() + new_end, xs.begin() + end);
+        ys.erase(ys.begin() + new_end, ys.begin() + end);
+    }
+
+    for (size_t i=0; i<new_count; i++)
+    {
+        xs[first + i] = points[i][0];
+        ys[first + i] = points[i][1];
+    }
+}
+
+void PointArrays::CopyTo(std::vector<std::array<float, 2>> & out) const
+{
+    out.resize(size());
+
+    for (size_t i=0; i<size(); i++)
+    {
+        out[i] = {xs[i], ys[i]};
+    }
+}
+
+void SegmentBlocks::write(size_t segment, const SegmentControls & controls)
+{
+    SegmentBlock & block = blocks[segment / blockWidth];
+    const size_t lane = segment % blockWidth;
+
+    for (size_t k=0; k<4; k++)
+    {
+        block.x[k][lane] = controls[k][0];
+        block.y[k][lane] = controls[k][1];
+    }
+}
+
+void SegmentBlocks::padLastBlock()
+{
+    if ((count % blockWidth) == 0)
+    {
+        return;
+    }
+
+    const SegmentControls last = (*this)[count - 1];
+    for (size_t segment=count; segment<(blocks.size() * blockWidth); segment++)
+    {
+        write(segment, last);
+    }
+}
+
+SegmentControls SegmentBlocks::operator[](size_t segment) const
+{
+    const SegmentBlock & block = blocks[segment / blockWidth];
+    const size_t lane = segment % blockWidth;
+
+    SegmentControls controls;
+    for (size_t k=0; k<4; k++)
+    {
+        controls[k] = {block.x[k][lane], block.y[k][lane]};
+    }
+
+    return controls;
+}
+
+void SegmentBlocks::Clear()
+{
+    blocks.clear();
+    count = 0;
+}
+
+void SegmentBlocks::Assign(std::span<const SegmentControls> segments)
+{
+    Update(segments, 0, segments.size());
+}
+
+void SegmentBlocks::Update(std::span<const SegmentControls> segments, size_t first_segment, size_t n_segments)
+{
+    count = segments.size();
+    blocks.resize((count + blockWidth - 1) / blockWidth);
+
+    const size_t end = std::min(first_segment + n_segments, count);
+    for (size_t segment=first_segment; segment<end; segment++)
+    {
+        write(segment, segments[segment]);
+    }
+
+    padLastBlock();
+}
+
+namespace curve_storage
+{
+    NearestSample FindNearestSample(std::span<const std::array<float, 2>> samples, const std::array<float, 2> & point)
+    {
+        NearestSample nearest;
+        size_t begin = 0;
+        const auto * coordinates = reinterpret_cast<const float *>(samples.data());
+
+#if CURVE_STORAGE_AVX2
+        if (curve_kernel::ActiveIsa() >= KERNEL_ISA::AVX2)
+        {
+            begin = nearestAvx2<true>(coordinates, coordinates + 1, samples.size(), point, nearest);
+        }
+#endif
+
+        nearestScalar(coordinates, coordinates + 1, 2, begin, samples.size(), point, nearest);
+        return nearest;
+    }
+
+    NearestSample FindNearestSample(const PointArrays & samples, const std::array<float, 2> & point)
+    {
+        NearestSample nearest;
+        size_t begin = 0;
+
+#if CURVE_STORAGE_AVX2
+        if (curve_kernel::ActiveIsa() >= KERNEL_ISA::AVX2)
+        {
+            begin = nearestAvx2<false>(samples.X(), samples.Y(), samples.size(), point, nearest);
+        }
+#endif
+
+        nearestScalar(samples.X(), samples.Y(), 1, begin, samples.size(), point, nearest);
+        return nearest;
+    }
+
+    void SegmentsNearPoint(std::span<const SegmentControls> segments, const std::array<float, 2> & point, float radius, std::vector<uint32_t> & out)
+    {
+        out.clear();
+
+        for (size_t i=0; i<segments.size(); i++)
+        {
+            if (isSegmentNear(segments[i], point, radius))
+            {
+                out.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    void SegmentsNearPoint(const SegmentBlocks & segments, const std::array<float, 2> & point, float radius, std::vector<uint32_t> & out)
+    {
+        out.clear();
+
+#if CURVE_STORAGE_AVX2
+        if (curve_kernel::ActiveIsa() >= KERNEL_ISA::AVX2)
+        {
+            segmentsNearAvx2(segments, point, radius, out);
+            return;
+        }
+#endif
+
+        for (size_t i=0; i<segments.size(); i++)
+        {
+            if (isSegmentNear(segments[i], point, radius))
+            {
+                out.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Curve.h"
+#include "CurveArcLength.h"
+
+#include <new>
+#include <span>
+#include <array>
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+
+namespace curve_storage
+{
+    constexpr size_t alignment = 64; // cache line (and avx512 register) size the arrays start on
+
+    // std::allocator that aligns every allocation to alignment, so the first element of an array can be loaded with
+    // aligned simd loads and never shares a cache line with other data
+    template<typename T>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        AlignedAllocator() = default;
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U> &) {}
+
+        T * allocate(size_t n)
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignment}));
+        }
+
+        void deallocate(T * ptr, size_t)
+        {
+            ::operator delete(ptr, std::align_val_t{alignment});
+        }
+
+        template<typename U>
+        bool operator==(const AlignedAllocator<U> &) const { return true; }
+    };
+}
+
+template<typename T>
+using AlignedVector = std::vector<T, curve_storage::AlignedAllocator<T>>;
+
+// structure of arrays copy of a list of points: x and y in separate 64 byte aligned arrays. simd code can load 4, 8 or
+// 16 x values (and the matching y values) straight into registers instead of de-interleaving x/y pairs first
+class PointArrays
+{
+    private:
+        AlignedVector<float> xs;
+        AlignedVector<float> ys;
+
+    public:
+        PointArrays() = default;
+
+        size_t size() const { return xs.size(); }
+        bool empty() const { return xs.empty(); }
+        const float * X() const { return xs.data(); }
+        const float * Y() const { return ys.data(); }
+        float * X() { return xs.data(); }
+        float * Y() { return ys.data(); }
+        std::array<float, 2> operator[](size_t index) const { return {xs[index], ys[index]}; }
+
+        void Clear();
+        void Resize(size_t n_points);
+        void Assign(std::span<const std::array<float, 2>> points); // copy of interleaved points
+        void Assign(const PointList & points); // copy of a point list (its gap is skipped)
+        void Splice(size_t first, size_t old_count, std::span<const std::array<float, 2>> points); // replace old_count points starting at first with points
+        void CopyTo(std::vector<std::array<float, 2>> & out) const; // the points interleaved again (replaces out)
+};
+
+// controls of blockWidth segments packed together: control point k of the segment in lane i is at x[k][i], y[k][i].
+// a block is 4 cache lines and one avx2 load gets the same control point of 8 segments
+struct alignas(curve_storage::alignment) SegmentBlock
+{
+    static constexpr size_t blockWidth = 8;
+
+    float x[4][blockWidth];
+    float y[4][blockWidth];
+};
+
+// SegmentControls of a curve packed into SegmentBlock (array of structures of arrays). the lanes after the last
+// segment repeat it so a block can always be processed whole
+class SegmentBlocks
+{
+    private:
+        AlignedVector<SegmentBlock> blocks;
+        size_t count = 0;
+
+        void write(size_t segment, const SegmentControls & controls);
+        void padLastBlock();
+
+    public:
+        SegmentBlocks() = default;
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const SegmentBlock * Blocks() const { return blocks.data(); }
+        size_t BlockCount() const { return blocks.size(); }
+        SegmentControls operator[](size_t segment) const;
+
+        void Clear();
+        void Assign(std::span<const SegmentControls> segments);
+        void Update(std::span<const SegmentControls> segments, size_t first_segment, size_t n_segments); // resize to segments and copy n_segments starting at first_segment again
+};
+
+// hit test kernels over the generated curve in both layouts. they find the same results (ties go to the lowest index),
+// the benchmark compares them
+namespace curve_storage
+{
+    struct NearestSample
+    {
+        int64_t index = -1; // -1 if there are no samples
+        float distanceSquared = std::numeric_limits<float>::max();
+    };
+
+    // closest sample to point by a linear scan
+    NearestSample FindNearestSample(std::span<const std::array<float, 2>> samples, const std::array<float, 2> & point);
+    NearestSample FindNearestSample(const PointArrays & samples, const std::array<float, 2> & point);
+
+    // indices of the segments that can be within radius of point: the bounds of their control points are, which also
+    // bound the segment. replaces out
+    void SegmentsNearPoint(std::span<const SegmentControls> segments, const std::array<float, 2> & point, float radius, std::vector<uint32_t> & out);
+    void SegmentsNearPoint(const SegmentBlocks & segments, const std::array<float, 2> & point, float radius, std::vector<uint32_t> & out);
+}
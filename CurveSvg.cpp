@@ -0,0 +1,568 @@
+#include "CurveSvg.h"
+#include "CubicCurve.h"
+#include "QuadraticCurve.h"
+#include "LinearCurve.h"
+#include "CurveTrace.h"
+
+#include <charconv>
+#include <system_error>
+
+namespace
+{
+    constexpr size_t chunkSize = 1 << 16; // bytes read from a stream at a time
+
+    bool isSeparator(char c)
+    {
+        return (c == ' ') || (c == ',') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\f');
+    }
+
+    bool isDigit(char c)
+    {
+        return (c >= '0') && (c <= '9');
+    }
+
+    bool isLetter(char c)
+    {
+        return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
+    }
+
+    char lowerCommand(char c)
+    {
+        return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    uint32_t commandArgCount(char command)
+    {
+        switch (lowerCommand(command))
+        {
+            case 'm':
+            case 'l':
+                return 2;
+
+            case 'q':
+                return 4;
+
+            case 'c':
+                return 6;
+
+            default:
+                return 0;
+        }
+    }
+
+    // end of the number starting at begin (begin if there is none). a number that may go on after the end of text ends
+    // at text.size()
+    size_t scanNumber(std::string_view text, size_t begin)
+    {
+        size_t i = begin;
+        size_t n_digits = 0;
+
+        if ((i < text.size()) && ((text[i] == '+') || (text[i] == '-')))
+        {
+            i++;
+        }
+
+        for (; (i < text.size()) && isDigit(text[i]); i++) { n_digits++; }
+
+        if ((i < text.size()) && (text[i] == '.'))
+        {
+            for (i++; (i < text.size()) && isDigit(text[i]); i++) { n_digits++; }
+        }
+
+        if (n_digits == 0)
+        {
+            return (i == text.size()) ? i : begin;
+        }
+
+        if ((i < text.size()) && ((text[i] == 'e') || (text[i] == 'E')))
+        {
+            size_t exponent = i + 1;
+            if ((exponent < text.size()) && ((text[exponent] == '+') || (text[exponent] == '-')))
+            {
+                exponent++;
+            }
+
+            if (exponent == text.size())
+            {
+                return exponent;
+            }
+
+            if (isDigit(text[exponent]))
+            {
+                for (i = exponent; (i < text.size()) && isDigit(text[i]); i++) {}
+            }
+        }
+
+        return i;
+    }
+
+    std::array<float, 2> lerp(const std::array<float, 2> & a, const std::array<float, 2> & b, float t)
+    {
+        return {a[0] + ((b[0] - a[0]) * t), a[1] + ((b[1] - a[1]) * t)};
+    }
+
+    std::array<float, 2> mirror(const std::array<float, 2> & point, const std::array<float, 2> & center)
+    {
+        return {(2.0f * center[0]) - point[0], (2.0f * center[1]) - point[1]};
+    }
+
+    template<typename CurveClass>
+    void addCurve(const SvgSubpath & subpath, std::vector<std::unique_ptr<CurveData>> & curves)
+    {
+        auto curve_data = CurveClass::NewCurveData();
+        curve_data->isCloseLoop = subpath.isClosed;
+
+        CurveClass curve (curve_data.get());
+        curve.BuildFromAnchors(subpath.anchors, subpath.handles);
+        curves.push_back(std::move(curve_data));
+    }
+
+    bool importPath(CURVE_TYPE curve_type, std::vector<std::unique_ptr<CurveData>> & curves, std::string * error, const std::function<bool(SvgPathParser &)> & feed)
+    {
+        CURVE_TRACE_SCOPE("curve_svg::ImportPath");
+
+        if ((curve_type != CURVE_TYPE::LINEAR) && (curve_type != CURVE_TYPE::QUADRATIC) && (curve_type != CURVE_TYPE::CUBIC))
+        {
+            if (error)
+            {
+                *error = "unknown curve type";
+            }
+
+            return false;
+        }
+
+        SvgPathParser parser (curve_type, [&](const SvgSubpath & subpath)
+        {
+            switch (curve_type)
+            {
+                case CURVE_TYPE::CUBIC:
+                    addCurve<CubicCurve>(subpath, curves);
+                    break;
+
+                case CURVE_TYPE::QUADRATIC:
+                    addCurve<QuadraticCurve>(subpath, curves);
+                    break;
+
+                default:
+                    addCurve<LinearCurve>(subpath, curves);
+                    break;
+            }
+        });
+
+        if (!feed(parser) || !parser.Finish())
+        {
+            if (error)
+            {
+                *error = std::string(parser.Error()) + " at byte " + std::to_string(parser.ErrorOffset());
+            }
+
+            return false;
+        }
+
+        return true;
+    }
+}
+
+SvgPathParser::SvgPathParser(CURVE_TYPE curve_type, SubpathCallback on_subpath)
+    : curveType(curve_type)
+    , onSubpath(std::move(on_subpath))
+{
+}
+
+void SvgPathParser::fail(const char * message, size_t text_offset)
+{
+    error = message;
+    errorOffset = offset + text_offset;
+}
+
+size_t SvgPathParser::parse(std::string_view text, bool is_complete)
+{
+    size_t i = 0;
+
+    while ((i < text.size()) && !error)
+    {
+        const char c = text[i];
+
+        if (isSeparator(c))
+        {
+            i++;
+            continue;
+        }
+
+        if (isLetter(c))
+        {
+            if (argCount != 0)
+            {
+                fail("missing command arguments", i);
+                break;
+            }
+
+            if (lowerCommand(c) == 'z')
+            {
+                closeSubpath();
+            }
+            else if (commandArgCount(c) == 0)
+            {
+                fail("unsupported path command", i);
+                break;
+            }
+
+            command = c;
+            i++;
+            continue;
+        }
+
+        const size_t end = scanNumber(text, i);
+        if (end == i)
+        {
+            fail("expected a number", i);
+            break;
+        }
+
+        if ((end == text.size()) && !is_complete)
+        {
+            break; // the number may go on in the next chunk
+        }
+
+        if (commandArgCount(command) == 0)
+        {
+            fail("number without a command", i);
+            break;
+        }
+
+        // from_chars doesn't take a plus sign
+        const char * first = text.data() + i + ((text[i] == '+') ? 1 : 0);
+        const char * last = text.data() + end;
+        float value = 0.0f;
+        auto [number_end, ec] = std::from_chars(first, last, value);
+
+        if ((ec != std::errc()) || (number_end != last))
+        {
+            fail("invalid number", i);
+            break;
+        }
+
+        args[argCount++] = value;
+        i = end;
+
+        if (argCount == commandArgCount(command))
+        {
+            runCommand();
+            argCount = 0;
+        }
+    }
+
+    return i;
+}
+
+void SvgPathParser::runCommand()
+{
+    // relative coordinates are offsets from the current point at the start of the command
+    const bool is_relative = (command >= 'a') && (command <= 'z');
+    const float dx = is_relative ? currentPoint[0] : 0.0f;
+    const float dy = is_relative ? currentPoint[1] : 0.0f;
+
+    std::array<std::array<float, 2>, 3> points;
+    const uint32_t n_points = commandArgCount(command) / 2;
+
+    for (uint32_t i=0; i<n_points; i++)
+    {
+        points[i] = {args[i*2 + 0] + dx, args[i*2 + 1] + dy};
+    }
+
+    if (lowerCommand(command) == 'm')
+    {
+        beginSubpath(points[0]);
+        command = is_relative ? 'l' : 'L'; // more coordinate pairs after a moveto are lines
+    }
+    else
+    {
+        addSegment(points.data(), n_points);
+    }
+}
+
+void SvgPathParser::beginSubpath(const std::array<float, 2> & point)
+{
+    if (isSubpathOpen)
+    {
+        endSubpath(false);
+    }
+
+    anchors.clear();
+    handles.clear();
+    anchors.push_back(point);
+
+    // handles of an end of the curve are only known once the subpath ends
+    if (curveType == CURVE_TYPE::CUBIC)
+    {
+        handles.push_back(point);
+        handles.push_back(point);
+    }
+    else if (curveType == CURVE_TYPE::QUADRATIC)
+    {
+        handles.push_back(point);
+    }
+
+    currentPoint = point;
+    subpathStart = point;
+    isSubpathOpen = true;
+}
+
+void SvgPathParser::addSegment(const std::array<float, 2> * points, uint32_t n_points)
+{
+    if (!isSubpathOpen)
+    {
+        beginSubpath(currentPoint); // a segment after a Z starts a new subpath at the start of the closed one
+    }
+
+    const std::array<float, 2> p0 = currentPoint;
+    const std::array<float, 2> & p1 = points[n_points - 1];
+
+    if (curveType == CURVE_TYPE::CUBIC)
+    {
+        std::array<float, 2> c1 = points[0];
+        std::array<float, 2> c2 = (n_points == 3) ? points[1] : points[0];
+
+        if (n_points == 1)
+        {
+            c1 = lerp(p0, p1, 1.0f / 3.0f);
+            c2 = lerp(p0, p1, 2.0f / 3.0f);
+        }
+        else if (n_points == 2)
+        {
+            // degree elevation of the quadratic
+            c1 = lerp(p0, points[0], 2.0f / 3.0f);
+            c2 = lerp(p1, points[0], 2.0f / 3.0f);
+        }
+
+        handles.back() = c1; // right handle of the last anchor
+        anchors.push_back(p1);
+        handles.push_back(c2);
+        handles.push_back(p1);
+    }
+    else if (curveType == CURVE_TYPE::QUADRATIC)
+    {
+        std::array<float, 2> control = points[0];
+
+        if (n_points == 1)
+        {
+            control = lerp(p0, p1, 0.5f);
+        }
+        else if (n_points == 3)
+        {
+            // the quadratic that goes through the midpoint of the cubic with the same end points
+            control = {((3.0f * (points[0][0] + points[1][0])) - (p0[0] + p1[0])) * 0.25f, ((3.0f * (points[0][1] + points[1][1])) - (p0[1] + p1[1])) * 0.25f};
+        }
+
+        handles.back() = control;
+        anchors.push_back(p1);
+        handles.push_back(p1);
+    }
+    else
+    {
+        if (n_points > 1)
+        {
+            for (uint32_t step=1; step<flattenSteps; step++)
+            {
+                // de casteljau on the control points of the segment
+                std::array<std::array<float, 2>, 4> control_points = {p0, points[0], points[1], (n_points > 2) ? points[2] : p1};
+                const float t = static_cast<float>(step) / static_cast<float>(flattenSteps);
+
+                for (uint32_t degree=n_points; degree>0; degree--)
+                {
+                    for (uint32_t i=0; i<degree; i++)
+                    {
+                        control_points[i] = lerp(control_points[i], control_points[i + 1], t);
+                    }
+                }
+
+                anchors.push_back(control_points[0]);
+            }
+        }
+
+        anchors.push_back(p1);
+    }
+
+    currentPoint = p1;
+}
+
+void SvgPathParser::closeSubpath()
+{
+    if (!isSubpathOpen)
+    {
+        currentPoint = subpathStart;
+        return;
+    }
+
+    if ((anchors.size() > 1) && (anchors.size() < 4) && (anchors.back() == anchors.front()))
+    {
+        // the segments already end at the start, but without the end anchor fewer than the 3 anchors the curve classes
+        // generate a closing segment for would be left (a lens of 2 arcs would lose one). the end anchor is kept and
+        // the curve stays open, its own segments close it
+        currentPoint = subpathStart;
+        endSubpath(false);
+        return;
+    }
+
+    if ((anchors.size() > 1) && (anchors.back() == anchors.front()))
+    {
+        // the last segment already ends at the start, the first anchor takes its place
+        if (curveType == CURVE_TYPE::CUBIC)
+        {
+            handles[0] = handles[handles.size() - 2];
+            handles.pop_back();
+            handles.pop_back();
+        }
+        else if (curveType == CURVE_TYPE::QUADRATIC)
+        {
+            handles.pop_back();
+        }
+
+        anchors.pop_back();
+    }
+    else if (anchors.size() > 1)
+    {
+        // closing line back to the start
+        if (curveType == CURVE_TYPE::CUBIC)
+        {
+            handles.back() = lerp(anchors.back(), anchors.front(), 1.0f / 3.0f);
+            handles[0] = lerp(anchors.back(), anchors.front(), 2.0f / 3.0f);
+        }
+        else if (curveType == CURVE_TYPE::QUADRATIC)
+        {
+            handles.back() = lerp(anchors.back(), anchors.front(), 0.5f);
+        }
+    }
+
+    currentPoint = subpathStart;
+    endSubpath(true);
+}
+
+void SvgPathParser::endSubpath(bool is_closed)
+{
+    // the free handles at the ends of an open curve mirror their neighbours, like the smooth handles of AddAnchor
+    if (!is_closed && (anchors.size() > 1))
+    {
+        if (curveType == CURVE_TYPE::CUBIC)
+        {
+            handles[0] = mirror(handles[1], anchors.front());
+            handles.back() = mirror(handles[handles.size() - 2], anchors.back());
+        }
+        else if (curveType == CURVE_TYPE::QUADRATIC)
+        {
+            handles.back() = mirror(handles[handles.size() - 2], anchors.back());
+        }
+    }
+
+    isSubpathOpen = false;
+
+    if ((anchors.size() > 1) && onSubpath)
+    {
+        onSubpath({anchors, handles, is_closed});
+    }
+}
+
+bool SvgPathParser::Feed(std::string_view chunk)
+{
+    if (error)
+    {
+        return false;
+    }
+
+    if (!carry.empty())
+    {
+        // a number that reached the end of the last chunk ends at the first separator of this one
+        size_t n_carried = 0;
+        while ((n_carried < chunk.size()) && !isSeparator(chunk[n_carried]))
+        {
+            n_carried++;
+        }
+
+        carry.append(chunk.substr(0, n_carried));
+        chunk.remove_prefix(n_carried);
+
+        if (chunk.empty())
+        {
+            return true;
+        }
+
+        offset += parse(carry, true);
+        carry.clear();
+    }
+
+    const size_t consumed = parse(chunk, false);
+    offset += consumed;
+    carry.assign(chunk.substr(consumed));
+
+    return !error;
+}
+
+bool SvgPathParser::Finish()
+{
+    if (!error && !carry.empty())
+    {
+        offset += parse(carry, true);
+        carry.clear();
+    }
+
+    if (!error && (argCount != 0))
+    {
+        fail("missing command arguments", 0);
+    }
+
+    if (error)
+    {
+        return false;
+    }
+
+    if (isSubpathOpen)
+    {
+        endSubpath(false);
+    }
+
+    return true;
+}
+
+void SvgPathParser::Reset()
+{
+    anchors.clear();
+    handles.clear();
+    currentPoint = {0.0f, 0.0f};
+    subpathStart = {0.0f, 0.0f};
+    isSubpathOpen = false;
+    command = 0;
+    argCount = 0;
+    carry.clear();
+    offset = 0;
+    error = nullptr;
+    errorOffset = 0;
+}
+
+namespace curve_svg
+{
+    bool ImportPath(std::string_view path_data, CURVE_TYPE curve_type, std::vector<std::unique_ptr<CurveData>> & curves, std::string * error)
+    {
+        return importPath(curve_type, curves, error, [&](SvgPathParser & parser) { return parser.Feed(path_data); });
+    }
+
+    bool ImportPath(std::istream & input, CURVE_TYPE curve_type, std::vector<std::unique_ptr<CurveData>> & curves, std::string * error)
+    {
+        return importPath(curve_type, curves, error, [&](SvgPathParser & parser)
+        {
+            std::vector<char> chunk (chunkSize);
+
+            while (input)
+            {
+                input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                const auto n_read = static_cast<size_t>(input.gcount());
+
+                if ((n_read > 0) && !parser.Feed({chunk.data(), n_read}))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+}
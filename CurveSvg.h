@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Curve.h"
+
+#include <span>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// a subpath of svg path data converted to a curve type: anchors and handles in the layout BuildFromAnchors of that
+// curve class takes (cubic: left and right handle of every anchor, quadratic: the control point after every anchor,
+// linear: no handles)
+struct SvgSubpath
+{
+    std::span<const std::array<float, 2>> anchors;
+    std::span<const std::array<float, 2>> handles;
+    bool isClosed = false;
+};
+
+// streaming parser of the svg path data ("d" attribute) commands M, L, Q, C and Z (absolute and relative). the data can
+// be fed in chunks of any size, a number split between two chunks is completed by the next one. segments that don't
+// match the curve type are converted: lines and quadratics are raised to cubics exactly, a cubic becomes the quadratic
+// through its midpoint and curves are split into flattenSteps lines for linear curves. every subpath (started by an
+// M or after a Z) is passed to the callback when it ends, the anchor and handle buffers are reused between subpaths
+class SvgPathParser
+{
+    public:
+        static constexpr uint32_t flattenSteps = 8; // lines per curve segment of a linear curve
+
+        using SubpathCallback = std::function<void(const SvgSubpath & subpath)>;
+
+    private:
+        CURVE_TYPE curveType;
+        SubpathCallback onSubpath;
+
+        std::vector<std::array<float, 2>> anchors;
+        std::vector<std::array<float, 2>> handles;
+        std::array<float, 2> currentPoint = {0.0f, 0.0f};
+        std::array<float, 2> subpathStart = {0.0f, 0.0f};
+        bool isSubpathOpen = false;
+
+        char command = 0; // command the next arguments belong to (0 before the first command)
+        std::array<float, 6> args = {};
+        uint32_t argCount = 0;
+
+        std::string carry; // end of the last chunk that may be the start of a number
+        size_t offset = 0; // bytes of the data consumed before the current chunk
+        const char * error = nullptr;
+        size_t errorOffset = 0;
+
+        size_t parse(std::string_view text, bool is_complete); // bytes consumed, a number touching the end of text is left unless is_complete
+        void fail(const char * message, size_t text_offset);
+        void runCommand();
+        void beginSubpath(const std::array<float, 2> & point);
+        void addSegment(const std::array<float, 2> * points, uint32_t n_points); // points after the current point (1 for a line, 2 for a quadratic, 3 for a cubic)
+        void closeSubpath();
+        void endSubpath(bool is_closed);
+
+    public:
+        SvgPathParser(CURVE_TYPE curve_type, SubpathCallback on_subpath);
+
+        bool Feed(std::string_view chunk); // false once the data has an error
+        bool Finish(); // end of the data, ends the last subpath
+        void Reset(); // parse new data (keeps the buffers)
+
+        const char * Error() const { return error; } // nullptr if there is none
+        size_t ErrorOffset() const { return errorOffset; } // byte offset of the error in the data
+};
+
+namespace curve_svg
+{
+    // new curve data (of the curve class of curve_type) for every subpath with at least 2 anchors. false (and the error in
+    // error) if the data has an error, the curves before it are still added
+    bool ImportPath(std::string_view path_data, CURVE_TYPE curve_type, std::vector<std::unique_ptr<CurveData>> & curves, std::string * error = nullptr);
+    bool ImportPath(std::istream & input, CURVE_TYPE curve_type, std::vector<std::unique_ptr<CurveData>> & curves, std::string * error = nullptr); // path data read in chunks
+}
@@ -0,0 +1,185 @@
+#include "CurveTrace.h"
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char * name;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    constexpr size_t eventsPerChunk = 1 << 16; // events are stored in chunks so a full buffer never moves its events
+
+    struct ThreadBuffer
+    {
+        std::vector<std::unique_ptr<TraceEvent[]>> chunks;
+        size_t chunkCount = 0; // chunks used in the current session
+        TraceEvent * next = nullptr; // where the next event of the last used chunk goes
+        TraceEvent * chunkEnd = nullptr;
+        uint64_t session = 0; // session the events were recorded in (the buffer is reset on the first event of a new one)
+        uint32_t threadId = 0;
+
+        size_t Count() const
+        {
+            return (chunkCount == 0) ? 0 : (((chunkCount - 1) * eventsPerChunk) + static_cast<size_t>(next - chunks[chunkCount - 1].get()));
+        }
+
+        void NextChunk() // start filling the next chunk (allocated the first time it is used)
+        {
+            if (chunkCount == chunks.size())
+            {
+                chunks.emplace_back(new TraceEvent[eventsPerChunk]);
+            }
+
+            next = chunks[chunkCount++].get();
+            chunkEnd = next + eventsPerChunk;
+        }
+    };
+
+    std::mutex registryMutex; // only taken the first time a thread records an event, and to write the trace
+    std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers; // buffers of every thread that recorded an event (never freed so the thread_local pointers stay valid)
+    thread_local ThreadBuffer * threadBuffer = nullptr;
+
+    std::atomic<uint64_t> session {0};
+    uint64_t sessionStartTicks = 0;
+    std::chrono::steady_clock::time_point sessionStartTime;
+
+    ThreadBuffer * registerThread()
+    {
+        std::lock_guard<std::mutex> lock (registryMutex);
+
+        threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+        threadBuffers.back()->threadId = static_cast<uint32_t>(threadBuffers.size());
+        return threadBuffers.back().get();
+    }
+
+    void writeEscaped(std::ostream & os, const char * str)
+    {
+        for (; *str; str++)
+        {
+            if ((*str == '"') || (*str == '\\'))
+            {
+                os << '\\';
+            }
+
+            os << *str;
+        }
+    }
+}
+
+namespace curve_trace
+{
+    std::atomic<bool> isRecording {false};
+
+    void Record(const char * name, uint64_t begin, uint64_t end)
+    {
+        ThreadBuffer * buffer = threadBuffer;
+        if (!buffer)
+        {
+            buffer = registerThread();
+            threadBuffer = buffer;
+        }
+
+        const uint64_t current_session = session.load(std::memory_order_relaxed);
+        if (buffer->session != current_session)
+        {
+            buffer->session = current_session;
+            buffer->chunkCount = 0;
+            buffer->next = nullptr;
+            buffer->chunkEnd = nullptr;
+        }
+
+        if (buffer->next == buffer->chunkEnd)
+        {
+            buffer->NextChunk();
+        }
+
+        *buffer->next++ = {name, begin, end};
+    }
+
+    void Start()
+    {
+        sessionStartTime = std::chrono::steady_clock::now();
+        sessionStartTicks = Now();
+        session.fetch_add(1, std::memory_order_relaxed);
+        isRecording.store(true, std::memory_order_relaxed);
+    }
+
+    void Stop()
+    {
+        isRecording.store(false, std::memory_order_relaxed);
+    }
+
+    bool IsRecording()
+    {
+        return isRecording.load(std::memory_order_relaxed);
+    }
+
+    size_t EventCount()
+    {
+        std::lock_guard<std::mutex> lock (registryMutex);
+        const uint64_t current_session = session.load(std::memory_order_relaxed);
+        size_t n_events = 0;
+
+        for (const auto & buffer : threadBuffers)
+        {
+            n_events += (buffer->session == current_session) ? buffer->Count() : 0;
+        }
+
+        return n_events;
+    }
+
+    bool WriteJson(const std::string & path)
+    {
+        std::ofstream file (path);
+        if (!file)
+        {
+            return false;
+        }
+
+        // ticks per microsecond over the whole session
+        const uint64_t elapsed_ticks = Now() - sessionStartTicks;
+        const double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sessionStartTime).count();
+        const double ticks_per_us = ((elapsed_us > 0.0) && (elapsed_ticks > 0)) ? (static_cast<double>(elapsed_ticks) / elapsed_us) : 1000.0;
+
+        std::lock_guard<std::mutex> lock (registryMutex);
+        const uint64_t current_session = session.load(std::memory_order_relaxed);
+        bool is_first_event = true;
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+
+        for (const auto & buffer : threadBuffers)
+        {
+            if (buffer->session != current_session)
+            {
+                continue;
+            }
+
+            file << (is_first_event ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadId << ", \"args\": {\"name\": \"thread " << buffer->threadId << "\"}}";
+            is_first_event = false;
+
+            const size_t n_events = buffer->Count();
+            for (size_t i=0; i<n_events; i++)
+            {
+                const TraceEvent & event = buffer->chunks[i / eventsPerChunk][i % eventsPerChunk];
+                const double begin_us = static_cast<double>(static_cast<int64_t>(event.begin - sessionStartTicks)) / ticks_per_us;
+                const double duration_us = static_cast<double>(event.end - event.begin) / ticks_per_us;
+
+                file << ",\n{\"name\": \"";
+                writeEscaped(file, event.name);
+                file << "\", \"cat\": \"curve\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId << ", \"ts\": " << begin_us << ", \"dur\": " << duration_us << "}";
+            }
+        }
+
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+}
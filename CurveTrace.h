@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// chrome/perfetto trace events of the curve operations. CURVE_TRACE_SCOPE("name") records a complete event (begin and
+// end time) for the rest of the scope into a buffer of the calling thread, and WriteJson writes the events of every
+// thread in the trace event format (open it in chrome://tracing or ui.perfetto.dev). when CURVE_TRACE_ENABLED is 0
+// (the default, set by the BASIC_CURVES_TRACE cmake option) the scopes compile to nothing
+#ifndef CURVE_TRACE_ENABLED
+#define CURVE_TRACE_ENABLED 0
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CURVE_TRACE_TSC 1
+#include <x86intrin.h>
+#elif defined(_M_X64)
+#define CURVE_TRACE_TSC 1
+#include <intrin.h>
+#else
+#define CURVE_TRACE_TSC 0
+#endif
+
+namespace curve_trace
+{
+    extern std::atomic<bool> isRecording;
+
+    // timestamp of an event. the time stamp counter where there is one (a few ns to read), converted to time when the
+    // trace is written
+    inline uint64_t Now()
+    {
+#if CURVE_TRACE_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    void Record(const char * name, uint64_t begin, uint64_t end); // add an event to the buffer of the calling thread. name must outlive the trace (a string literal)
+
+    void Start(); // drop the recorded events and start recording
+    void Stop();
+    bool IsRecording();
+    size_t EventCount(); // events recorded by every thread
+    bool WriteJson(const std::string & path); // write the recorded events, call it while the traced threads aren't in a scope (e.g. after Stop). false if the file can't be written
+
+    class Scope
+    {
+        private:
+            const char * name;
+            uint64_t begin = 0;
+            bool isActive;
+
+        public:
+            explicit Scope(const char * scope_name)
+                : name(scope_name)
+                , isActive(isRecording.load(std::memory_order_relaxed))
+            {
+                if (isActive)
+                {
+                    begin = Now();
+                }
+            }
+
+            ~Scope()
+            {
+                if (isActive)
+                {
+                    Record(name, begin, Now());
+                }
+            }
+
+            Scope(const Scope &) = delete;
+            Scope & operator=(const Scope &) = delete;
+    };
+}
+
+#define CURVE_TRACE_CONCAT_INNER(a, b) a##b
+#define CURVE_TRACE_CONCAT(a, b) CURVE_TRACE_CONCAT_INNER(a, b)
+
+#if CURVE_TRACE_ENABLED
+#define CURVE_TRACE_SCOPE(name) curve_trace::Scope CURVE_TRACE_CONCAT(curve_trace_scope_, __LINE__)(name)
+#else
+#define CURVE_TRACE_SCOPE(name)
+#endif
@@ -1,46 +1,342 @@
 #include "DrawCurve.h"
+#include "CurveBvh.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
 
 #include <cmath>
 #include <algorithm>
 
-void DrawCurve::HoverAnimation(ICurve* curve, int32_t x, int32_t y)
+void DrawCurve::updateVertexCache(ICurve* curve, VertexCache & cache, bool is_handle_cache)
 {
-    if (!pointRadiusValues.empty())
+    // only touch the vertices if the curve has been edited since they were last updated. generations are only
+    // comparable while the curve keeps its curve data block, a new block needs every vertex again
+    const bool is_same_data = cache.isBuilt && (cache.dataEpoch == curve->DataEpoch());
+    if (is_same_data && !curve->HasChangedSince(cache.generation))
     {
-        const std::vector<std::array<float,2>> & points = curve->GetPointData();
-        pointRadiusValues.resize(points.size()); // resize in case an anchor has been deleted
+        return;
+    }
 
-        size_t n_points = points.size();
+    const size_t n_points = is_handle_cache ? curve->HandleData().size() : curve->Data().size();
+    const sf::Vertex new_vertex(sf::Vector2f(0.0f, 0.0f), lineColor);
+    bool is_patched = false;
 
-        for (size_t i=0; i<n_points; i++)
+    if (is_same_data && curve->EditsSince(cache.generation, sampleEdits))
+    {
+        // replay the edits on the vertices: grow or shrink the edited ranges so the vertices after them line up with
+        // the curve again, and remember which ranges have to be copied from the curve
+        dirtyVertexRanges.clear();
+        bool are_edits_valid = true;
+
+        for (const SampleEdit & edit : sampleEdits)
         {
-            float x_distance = static_cast<float>(x) - points[i][0];
-            float y_distance = static_cast<float>(y) - points[i][1];
+            if (edit.isHandleEdit != is_handle_cache)
+            {
+                continue;
+            }
+
+            const size_t edit_end = edit.first + edit.oldCount;
+            if (edit_end > cache.vertices.size())
+            {
+                are_edits_valid = false;
+                break;
+            }
+
+            const auto edit_position = cache.vertices.begin() + static_cast<std::ptrdiff_t>(edit.first);
+
+            if (edit.newCount > edit.oldCount)
+            {
+                cache.vertices.insert(edit_position + static_cast<std::ptrdiff_t>(edit.oldCount), (edit.newCount - edit.oldCount), new_vertex);
+            }
+            else if (edit.newCount < edit.oldCount)
+            {
+                cache.vertices.erase(edit_position + static_cast<std::ptrdiff_t>(edit.newCount), edit_position + static_cast<std::ptrdiff_t>(edit.oldCount));
+            }
+
+            for (auto & range : dirtyVertexRanges)
+            {
+                if (range.first >= edit_end)
+                {
+                    range.first = range.first - edit.oldCount + edit.newCount;
+                    range.second = range.second - edit.oldCount + edit.newCount;
+                }
+                else if (range.second > edit_end)
+                {
+                    // reaches past the edit, the part inside of it is covered by the edited range added below
+                    range.first = std::min(range.first, edit.first);
+                    range.second = range.second - edit.oldCount + edit.newCount;
+                }
+                else if (range.second > edit.first)
+                {
+                    // ends inside the edit, keep the part in front of it
+                    range.second = std::max(range.first, edit.first);
+                }
+            }
+
+            dirtyVertexRanges.emplace_back(edit.first, (edit.first + edit.newCount));
+        }
+
+        if (are_edits_valid && (cache.vertices.size() == n_points))
+        {
+            for (const auto & range : dirtyVertexRanges)
+            {
+                if (range.second > range.first)
+                {
+                    if (is_handle_cache)
+                    {
+                        curve->CopyHandleData(range.first, (range.second - range.first), &cache.vertices[range.first].position.x, sizeof(sf::Vertex));
+                    }
+                    else
+                    {
+                        curve->CopyData(range.first, (range.second - range.first), &cache.vertices[range.first].position.x, sizeof(sf::Vertex));
+                    }
+                }
+            }
+
+            is_patched = true;
+        }
+    }
 
-            float distance_squared = std::sqrt((x_distance*x_distance) + (y_distance*y_distance));
+    if (!is_patched)
+    {
+        cache.vertices.assign(n_points, new_vertex);
 
-            if (distance_squared <= initialRadius)
+        if (n_points > 0)
+        {
+            if (is_handle_cache)
             {
-                pointRadiusValues[i] = pointRadiusValues[i] + (hoverGrowthRate * ((1.0f + hoverGrowthRate) + (2.0f + hoverGrowthRate)));
-                hoverPoint = static_cast<int32_t>(i);
+                curve->CopyHandleData(0, n_points, &cache.vertices[0].position.x, sizeof(sf::Vertex));
             }
             else
             {
-                pointRadiusValues[i] = pointRadiusValues[i] - (hoverGrowthRate * ((1.0f + hoverGrowthRate) + (2.0f + hoverGrowthRate)));
+                curve->CopyData(0, n_points, &cache.vertices[0].position.x, sizeof(sf::Vertex));
             }
+        }
+    }
+
+    cache.generation = curve->Generation();
+    cache.dataEpoch = curve->DataEpoch();
+    cache.isBuilt = true;
+}
+
+void DrawCurve::updateCulledVertexCache(ICurve* curve, CulledVertexCache & cache, const CurveBounds & view_bounds, float pixel_scale)
+{
+    const std::array<float, 4> view_values = {view_bounds.min[0], view_bounds.min[1], view_bounds.max[0], view_bounds.max[1]};
+
+    if (cache.isBuilt && (cache.dataEpoch == curve->DataEpoch()) && !curve->HasChangedSince(cache.generation) && (cache.viewRect == view_values) && (cache.pixelScale == pixel_scale))
+    {
+        return;
+    }
 
-            pointRadiusValues[i] = std::clamp(pointRadiusValues[i], initialRadius, initialRadius + hoverRadius);
+    const std::vector<std::array<float, 2>> & samples = curve->Data();
+    const std::vector<size_t> & offsets = curve->SegmentOffsets();
+    const CurveBvh & segment_tree = curve->SegmentTree();
+
+    cache.vertices.clear();
+    bool is_run_open = false; // the last vertex is connected to the next sample added
+
+    // range of samples of a generated segment (a closing segment fills the rest of the samples)
+    auto segment_samples = [&](size_t segment)
+    {
+        if (segment >= offsets.size())
+        {
+            return std::pair<size_t, size_t>(samples.size(), samples.size());
+        }
+
+        const size_t end = ((segment + 1) < offsets.size()) ? offsets[segment + 1] : samples.size();
+        return std::pair<size_t, size_t>(offsets[segment], std::max(offsets[segment], end));
+    };
+
+    auto add_sample = [&](size_t sample)
+    {
+        const sf::Vector2f position(samples[sample][0], samples[sample][1]);
+
+        if (!is_run_open && !cache.vertices.empty())
+        {
+            // join the runs with a transparent line so everything is still drawn with one call
+            cache.vertices.emplace_back(cache.vertices.back().position, sf::Color::Transparent);
+            cache.vertices.emplace_back(position, sf::Color::Transparent);
         }
+        else if (is_run_open && (cache.vertices.back().position.x == position.x) && (cache.vertices.back().position.y == position.y))
+        {
+            return; // segments next to each other share their end and start sample
+        }
+
+        cache.vertices.emplace_back(position, lineColor);
+        is_run_open = true;
+    };
+
+    // segments are visited in curve order. every node outside of the view is skipped with everything below it and
+    // every node too small to see is drawn as a line between its first and last sample, so the number of vertices
+    // depends on how much of the curve is on screen instead of how many segments it has
+    segment_tree.Traverse([&](const CurveBounds & bounds, size_t first_segment, size_t n_segments)
+    {
+        if (!bounds.Intersects(view_bounds))
+        {
+            is_run_open = false;
+            return false;
+        }
+
+        const float screen_size = ((bounds.max[0] - bounds.min[0]) + (bounds.max[1] - bounds.min[1])) * pixel_scale;
+        const size_t first_sample = segment_samples(first_segment).first;
+        const size_t end_sample = segment_samples(first_segment + n_segments - 1).second;
+
+        if ((screen_size > lodPixelSize) && (n_segments > 1))
+        {
+            return true;
+        }
+
+        if (end_sample <= first_sample)
+        {
+            return false;
+        }
+
+        // a single visible segment keeps one sample every lodSampleSpacing pixels (at most every sample it has)
+        const size_t n_samples = end_sample - first_sample;
+        size_t n_steps = 1;
+
+        if (screen_size > lodPixelSize)
+        {
+            n_steps = std::clamp(static_cast<size_t>(std::ceil(screen_size / lodSampleSpacing)), size_t(1), std::max(n_samples - 1, size_t(1)));
+        }
+
+        for (size_t i=0; i<=n_steps; i++)
+        {
+            add_sample(first_sample + ((i * (n_samples - 1)) / n_steps));
+        }
+
+        return false;
+    });
+
+    cache.generation = curve->Generation();
+    cache.dataEpoch = curve->DataEpoch();
+    cache.viewRect = view_values;
+    cache.pixelScale = pixel_scale;
+    cache.isBuilt = true;
+}
+
+CurveBounds DrawCurve::viewBounds(const sf::RenderWindow & window)
+{
+    const sf::FloatRect view_rect = activeView(window).getInverseTransform().transformRect(sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f));
+
+    CurveBounds view_bounds;
+    view_bounds.min = {view_rect.left, view_rect.top};
+    view_bounds.max = {view_rect.left + view_rect.width, view_rect.top + view_rect.height};
+    return view_bounds;
+}
+
+float DrawCurve::pixelScale(const sf::RenderWindow & window)
+{
+    const sf::View & curve_view = activeView(window);
+    return (static_cast<float>(window.getSize().x) * curve_view.getViewport().width) / std::abs(curve_view.getSize().x);
+}
+
+DrawCurve::CurveCaches & DrawCurve::cachesOf(const ICurve* curve)
+{
+    cacheUses++;
+
+    if ((cacheUses % cacheLifetime) == 0)
+    {
+        std::erase_if(curveCaches, [&](const auto & entry)
+        {
+            return ((cacheUses - entry.second.lastUse) > cacheLifetime) && (entry.first != curve);
+        });
+    }
+
+    CurveCaches & caches = curveCaches[curve];
+    caches.lastUse = cacheUses;
+    return caches;
+}
+
+const sf::View & DrawCurve::activeView(const sf::RenderWindow & window)
+{
+    if (!isViewSet)
+    {
+        view = window.getDefaultView();
+        isViewSet = true;
+    }
+
+    return view;
+}
+
+void DrawCurve::SetView(const sf::View & curve_view)
+{
+    view = curve_view;
+    isViewSet = true;
+}
+
+const sf::View & DrawCurve::GetView() const
+{
+    return view;
+}
+
+void DrawCurve::SetCulling(bool enable)
+{
+    isCullingEnabled = enable;
+}
+
+bool DrawCurve::IsCullingEnabled() const
+{
+    return isCullingEnabled;
+}
+
+void DrawCurve::HoverAnimation(ICurve* curve, int32_t x, int32_t y)
+{
+    CURVE_TRACE_SCOPE("DrawCurve::HoverAnimation");
+    CURVE_ALLOCATION_SCOPE(DRAW);
+
+    if (!pointRadiusValues.empty())
+    {
+        const PointList & points = curve->GetPointData();
+        pointRadiusValues.resize(points.size(), initialRadius); // resize in case an anchor has been deleted
+
+        const float growth = hoverGrowthRate * ((1.0f + hoverGrowthRate) + (2.0f + hoverGrowthRate));
+
+        // only the points under the cursor grow and every other point shrinks back to its initial radius, so only the
+        // points the grid finds under the cursor and the points that are still shrinking need to be visited
+        curve->PointsInRadius({static_cast<float>(x), static_cast<float>(y)}, initialRadius, hoveredPoints);
+
+        for (uint32_t i : animatedPoints)
+        {
+            if ((i < pointRadiusValues.size()) && (std::find(hoveredPoints.begin(), hoveredPoints.end(), i) == hoveredPoints.end()))
+            {
+                pointRadiusValues[i] = std::clamp((pointRadiusValues[i] - growth), initialRadius, initialRadius + hoverRadius);
+            }
+        }
+
+        for (uint32_t i : hoveredPoints)
+        {
+            pointRadiusValues[i] = std::clamp((pointRadiusValues[i] + growth), initialRadius, initialRadius + hoverRadius);
+
+            if (std::find(animatedPoints.begin(), animatedPoints.end(), i) == animatedPoints.end())
+            {
+                animatedPoints.push_back(i);
+            }
+        }
+
+        // the point drawn last (on top) is the hovered one
+        if (!hoveredPoints.empty())
+        {
+            hoverPoint = static_cast<int32_t>(*std::max_element(hoveredPoints.begin(), hoveredPoints.end()));
+        }
+
+        // drop points that are back to their initial radius (or have been deleted)
+        std::erase_if(animatedPoints, [&](uint32_t i)
+        {
+            return (i >= pointRadiusValues.size()) || (pointRadiusValues[i] <= initialRadius);
+        });
     }
 }
 
 void DrawCurve::DrawIntersectionPoint(ICurve* curve, int32_t x, int32_t y, sf::RenderWindow & window)
 {
+    CURVE_TRACE_SCOPE("DrawCurve::DrawIntersectionPoint");
+    CURVE_ALLOCATION_SCOPE(DRAW);
+
     // The curve needs to exist and work/curve types need to match to do an insertion.
     if (curve && (curve->CurveType() == curve->WorkCurveType()))
     {
         auto intersect_on_curve = curve->IntersectionOnCurve({(float)x, (float)y});
-        auto insert_index = static_cast<int32_t>(intersect_on_curve.second);
+        const int32_t insert_index = (intersect_on_curve.second != noInsertIndex) ? static_cast<int32_t>(intersect_on_curve.second) : -1;
 
         if (insert_index >= 1)
         {
@@ -89,7 +385,10 @@ void DrawCurve::DrawIntersectionPoint(ICurve* curve, int32_t x, int32_t y, sf::R
                 circle_shape.setOutlineColor(outlineColor);
                 circle_shape.setPosition(sf::Vector2f(intersect_on_curve.first[0]-initialRadius, intersect_on_curve.first[1]-initialRadius));
 
+                const sf::View window_view = window.getView();
+                window.setView(activeView(window));
                 window.draw(circle_shape);
+                window.setView(window_view);
             }
         }
     }
@@ -102,32 +401,27 @@ void DrawCurve::SelectedPoint(int32_t index)
 
 void DrawCurve::DrawPoints(ICurve* curve, bool draw_handles, sf::RenderWindow & window)
 {
+    CURVE_TRACE_SCOPE("DrawCurve::DrawPoints");
+    CURVE_ALLOCATION_SCOPE(DRAW);
+
     if (curve)
     {
         if (draw_handles)
         {
-            const std::vector<std::array<float,2>> & handle_data = curve->HandleData();
-            const size_t n_handle_points = handle_data.size();
-
-            std::vector<sf::Vertex> handlePointList (n_handle_points);
+            const sf::View window_view = window.getView();
+            window.setView(activeView(window));
 
-            for (size_t i=0; i<n_handle_points; i++)
-            {
-                handlePointList[i] = sf::Vector2f(handle_data[i][0], handle_data[i][1]);
-                handlePointList[i].color = lineColor;
-            }
+            VertexCache & handle_cache = cachesOf(curve).handleVertices;
+            updateVertexCache(curve, handle_cache, true);
 
-            window.draw(handlePointList.data(), handlePointList.size(), sf::PrimitiveType::Lines);
+            window.draw(handle_cache.vertices.data(), handle_cache.vertices.size(), sf::PrimitiveType::Lines);
 
             // generate radius data for each point. Should only truly resize of the number of points has changed
-            const std::vector<std::array<float,2>> & point_data = curve->GetPointData();
+            const PointList & point_data = curve->GetPointData();
             const size_t n_points = point_data.size();
             pointRadiusValues.resize(n_points, initialRadius);
 
-            sf::CircleShape circle_shape;
-            circle_shape.setOutlineThickness(outlineThickness);
-
-            const std::vector<std::array<float,2>> & points = curve->GetPointData();
+            const PointList & points = curve->GetPointData();
             const std::vector<float> & points_radius = pointRadiusValues;
 
             size_t start = 0;
@@ -159,6 +453,11 @@ void DrawCurve::DrawPoints(ICurve* curve, bool draw_handles, sf::RenderWindow &
                 // nothing to implement
             }
 
+            // build the circles of every point into one triangle list and draw it with a single call. circles whose
+            // position, radius and colors haven't changed since the last frame are not regenerated
+            pointBatch.SetOutlineThickness(outlineThickness);
+            size_t n_drawn_points = 0;
+
             for (size_t i=start; i<n_points; i+=increment)
             {
                 if ((ignore_count > 0) && ((i % ignore_count) == 0))
@@ -166,32 +465,37 @@ void DrawCurve::DrawPoints(ICurve* curve, bool draw_handles, sf::RenderWindow &
                     continue;
                 }
 
-                circle_shape.setFillColor(unselectedColor);
-                circle_shape.setOutlineColor(outlineColor);
+                PointBatch::PointStyle style;
+                style.position = points[i];
+                style.radius = points_radius[i];
+                style.fillColor = unselectedColor;
+                style.outlineColor = outlineColor;
 
                 if (i == hoverPoint)
                 {
-                    circle_shape.setFillColor(hoverColor);
+                    style.fillColor = hoverColor;
                 }
 
                 if (i == selectedPoint)
                 {
                     if (i == hoverPoint)
                     {
-                        circle_shape.setOutlineColor(selectedColor);
-                        circle_shape.setFillColor(hoverColor);
+                        style.outlineColor = selectedColor;
+                        style.fillColor = hoverColor;
                     }
                     else
                     {
-                        circle_shape.setFillColor(selectedColor);
+                        style.fillColor = selectedColor;
                     }
                 }
 
-                circle_shape.setRadius(points_radius[i]);
-                circle_shape.setPosition((points[i][0] - points_radius[i]), (points[i][1] - points_radius[i]));
-
-                window.draw(circle_shape);
+                pointBatch.SetPoint(n_drawn_points++, style);
             }
+
+            pointBatch.Resize(n_drawn_points);
+            window.draw(pointBatch.Vertices().data(), pointBatch.Vertices().size(), sf::PrimitiveType::Triangles);
+
+            window.setView(window_view);
         }
 
         hoverPoint = -1; // clear hover index
@@ -200,16 +504,40 @@ void DrawCurve::DrawPoints(ICurve* curve, bool draw_handles, sf::RenderWindow &
 
 void DrawCurve::RenderCurve(ICurve* curve, sf::RenderWindow & window, const sf::PrimitiveType & primitive_type)
 {
-    const std::vector<std::array<float,2>> & curve_data = curve->Data();
-    const size_t n_curve_points = curve_data.size();
+    CURVE_TRACE_SCOPE("DrawCurve::RenderCurve");
+    CURVE_ALLOCATION_SCOPE(DRAW);
+
+    const sf::View window_view = window.getView();
+    window.setView(activeView(window));
+
+    // the culled vertices are a single strip, other primitive types need every vertex of the curve. the culled strip
+    // is rebuilt from the visible segments whenever the curve is edited, so a curve that is entirely on screen without
+    // being zoomed out (nothing to cull and next to nothing to reduce) is drawn from the full vertices, which are only
+    // patched where the edits are
+    bool is_culled = isCullingEnabled && ((primitive_type == sf::PrimitiveType::LineStrip) || (primitive_type == sf::PrimitiveType::Points));
+    const CurveBounds view_bounds = viewBounds(window);
+    const float pixel_scale = pixelScale(window);
+
+    if (is_culled && (pixel_scale >= 1.0f))
+    {
+        const CurveBounds curve_bounds = curve->Bounds();
+        is_culled = !curve_bounds.IsEmpty() && !(view_bounds.Contains(curve_bounds.min) && view_bounds.Contains(curve_bounds.max));
+    }
 
-    std::vector<sf::Vertex> vertexList (n_curve_points);
+    if (is_culled)
+    {
+        CulledVertexCache & culled_cache = cachesOf(curve).culledVertices;
+        updateCulledVertexCache(curve, culled_cache, view_bounds, pixel_scale);
 
-    for (size_t i=0; i<n_curve_points; i++)
+        window.draw(culled_cache.vertices.data(), culled_cache.vertices.size(), primitive_type);
+    }
+    else
     {
-        vertexList[i] = sf::Vector2f(curve_data[i][0], curve_data[i][1]);
-        vertexList[i].color = lineColor;
+        VertexCache & cache = cachesOf(curve).curveVertices;
+        updateVertexCache(curve, cache, false);
+
+        window.draw(cache.vertices.data(), cache.vertices.size(), primitive_type);
     }
 
-    window.draw(vertexList.data(), vertexList.size(), primitive_type);
+    window.setView(window_view);
 }
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "Curve.h"
+#include "PointBatch.h"
 
 #include <vector>
+#include <array>
+#include <unordered_map>
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/View.hpp>
 
 class DrawCurve
 {
@@ -18,6 +22,43 @@ class DrawCurve
         sf::Color lineColor = sf::Color::White;
 
         std::vector<float> pointRadiusValues;
+        std::vector<uint32_t> hoveredPoints; // points under the cursor (reused every frame)
+        std::vector<uint32_t> animatedPoints; // points with a radius above initialRadius
+        struct VertexCache
+        {
+            std::vector<sf::Vertex> vertices;
+            uint64_t generation = 0; // generation of the curve the vertices are up to date with
+            uint64_t dataEpoch = 0; // data epoch of the curve the generation belongs to
+            bool isBuilt = false;
+        };
+
+        // vertices of the part of a curve inside of the view, with the detail reduced to what is visible on screen
+        struct CulledVertexCache
+        {
+            std::vector<sf::Vertex> vertices; // a single strip, runs apart from each other are joined by transparent vertices
+            uint64_t generation = 0; // generation of the curve the vertices were built from
+            uint64_t dataEpoch = 0; // data epoch of the curve the generation belongs to
+            std::array<float, 4> viewRect = {}; // left, top, right and bottom of the view (in curve units) the vertices were built for
+            float pixelScale = 0.0f; // pixels per curve unit the vertices were built for
+            bool isBuilt = false;
+        };
+
+        struct CurveCaches
+        {
+            VertexCache curveVertices;
+            CulledVertexCache culledVertices;
+            VertexCache handleVertices;
+            uint64_t lastUse = 0; // cacheUses when the caches were last drawn
+        };
+
+        // caches of the curves drawn recently. a curve doesn't tell when it is destroyed, so caches that haven't been
+        // drawn for cacheLifetime lookups are dropped (a new curve at the address of a dropped one has another data
+        // epoch and never picks up its vertices)
+        std::unordered_map<const ICurve*, CurveCaches> curveCaches;
+        uint64_t cacheUses = 0; // lookups of curveCaches so far
+        static constexpr uint64_t cacheLifetime = 1024;
+        std::vector<SampleEdit> sampleEdits; // reused while patching the caches
+        std::vector<std::pair<size_t, size_t>> dirtyVertexRanges; // reused while patching the caches ([begin, end) of vertices to copy again)
 
         float hoverGrowthRate = 0.25f;
         float hoverRadius = 5.0f;
@@ -25,6 +66,20 @@ class DrawCurve
         float outlineThickness = 2.0f;
         int32_t selectedPoint = -1;
         int32_t hoverPoint = -1;
+        PointBatch pointBatch{30, outlineThickness}; // circles of the points (same number of segments as sf::CircleShape)
+
+        sf::View view; // camera the curves are drawn with (the default view of the window until one is set)
+        bool isViewSet = false;
+        bool isCullingEnabled = true;
+        float lodPixelSize = 2.0f; // parts of the curve smaller than this on screen (in pixels) are drawn as a single line
+        float lodSampleSpacing = 4.0f; // min distance on screen (in pixels) between the samples drawn of a visible segment
+
+        void updateVertexCache(ICurve* curve, VertexCache & cache, bool is_handle_cache); // bring cache up to date with the curve data (or handle data)
+        void updateCulledVertexCache(ICurve* curve, CulledVertexCache & cache, const CurveBounds & view_bounds, float pixel_scale); // rebuild cache if the curve or the view changed since it was built
+        const sf::View & activeView(const sf::RenderWindow & window); // view the curves are drawn with
+        CurveBounds viewBounds(const sf::RenderWindow & window); // area of the curves inside of the view
+        float pixelScale(const sf::RenderWindow & window); // pixels per curve unit on screen
+        CurveCaches & cachesOf(const ICurve* curve); // caches of curve (created if it has none), drops the caches that weren't used for a while
 
     public:
         DrawCurve() = default;
@@ -33,6 +88,11 @@ class DrawCurve
         void HoverAnimation(ICurve* curve, int32_t x, int32_t y);
         void SelectedPoint(int32_t index);
 
+        void SetView(const sf::View & curve_view); // pan/zoom of the curves. positions passed to the other functions are in the coordinates of this view
+        const sf::View & GetView() const;
+        void SetCulling(bool enable); // skip the segments outside of the view and reduce the detail of small ones when the curve isn't entirely on screen (on by default)
+        bool IsCullingEnabled() const;
+
         void DrawIntersectionPoint(ICurve* curve, int32_t x, int32_t y, sf::RenderWindow & window);
         void RenderCurve(ICurve* curve, sf::RenderWindow & window, const sf::PrimitiveType & primitive_type = sf::PrimitiveType::LineStrip);
     void DrawPoints(ICurve* curve, bool draw_handles, sf::RenderWindow & window);
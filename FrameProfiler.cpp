@@ -0,0 +1,214 @@
+#include "FrameProfiler.h"
+
+#include <fstream>
+#include <algorithm>
+
+FrameProfiler::ScopedTimer::ScopedTimer(FrameProfiler & frame_profiler, PROFILE_STAGE profile_stage)
+    : profiler(frame_profiler.isEnabled ? &frame_profiler : nullptr)
+    , stage(profile_stage)
+{
+    if (profiler)
+    {
+        begin = std::chrono::steady_clock::now();
+    }
+}
+
+FrameProfiler::ScopedTimer::~ScopedTimer()
+{
+    Stop();
+}
+
+void FrameProfiler::ScopedTimer::Stop()
+{
+    if (profiler)
+    {
+        auto end = std::chrono::steady_clock::now();
+        profiler->AddStageTime(stage, std::chrono::duration<float, std::milli>(end - begin).count());
+        profiler = nullptr;
+    }
+}
+
+void FrameProfiler::SetEnabled(bool enable)
+{
+    isEnabled = enable;
+    isFrameOpen = false; // a frame that was open when the profiler was toggled is dropped
+}
+
+void FrameProfiler::BeginFrame()
+{
+    if (!isEnabled)
+    {
+        return;
+    }
+
+    currentFrame = {};
+    currentFrame.frame = frameCount.load(std::memory_order_relaxed);
+    frameBegin = std::chrono::steady_clock::now();
+    frameBeginAllocations = allocation_counter::Snapshot();
+    isFrameOpen = true;
+}
+
+void FrameProfiler::EndFrame()
+{
+    if (!isEnabled || !isFrameOpen)
+    {
+        return;
+    }
+
+    auto frame_end = std::chrono::steady_clock::now();
+    currentFrame.frameMs = std::chrono::duration<float, std::milli>(frame_end - frameBegin).count();
+
+    const allocation_counter::AllocationStats frame_allocations = allocation_counter::Snapshot() - frameBeginAllocations;
+    currentFrame.allocations = frame_allocations.allocations;
+    currentFrame.allocatedBytes = frame_allocations.bytes;
+
+    for (size_t category=0; category<allocation_counter::categoryCount; category++)
+    {
+        currentFrame.categoryAllocations[category] = static_cast<uint32_t>(frame_allocations.categoryAllocations[category]);
+    }
+
+    // write the slot first and publish it after, so a reader that sees the new count also sees the frame
+    const uint64_t n_frames = frameCount.load(std::memory_order_relaxed);
+    frames[n_frames % frameCapacity] = currentFrame;
+    frameCount.store(n_frames + 1, std::memory_order_release);
+
+    isFrameOpen = false;
+}
+
+void FrameProfiler::AddStageTime(PROFILE_STAGE stage, float ms)
+{
+    if (isFrameOpen)
+    {
+        currentFrame.stageMs[static_cast<size_t>(stage)] += ms;
+    }
+}
+
+size_t FrameProfiler::FrameCount() const
+{
+    return static_cast<size_t>(std::min<uint64_t>(frameCount.load(std::memory_order_acquire), frameCapacity));
+}
+
+FrameProfiler::FrameTimes FrameProfiler::Frame(size_t age) const
+{
+    const uint64_t n_frames = frameCount.load(std::memory_order_acquire);
+    if (age >= std::min<uint64_t>(n_frames, frameCapacity))
+    {
+        return {};
+    }
+
+    return frames[(n_frames - 1 - age) % frameCapacity];
+}
+
+FrameProfiler::FrameTimes FrameProfiler::Average() const
+{
+    FrameTimes average;
+    const size_t n_frames = FrameCount();
+
+    if (n_frames == 0)
+    {
+        return average;
+    }
+
+    for (size_t i=0; i<n_frames; i++)
+    {
+        FrameTimes frame = Frame(i);
+        average.frameMs += frame.frameMs;
+
+        for (size_t stage=0; stage<stageCount; stage++)
+        {
+            average.stageMs[stage] += frame.stageMs[stage];
+        }
+
+        average.allocations += frame.allocations;
+        average.allocatedBytes += frame.allocatedBytes;
+
+        for (size_t category=0; category<allocation_counter::categoryCount; category++)
+        {
+            average.categoryAllocations[category] += frame.categoryAllocations[category];
+        }
+    }
+
+    average.frame = Frame(0).frame;
+    average.frameMs /= static_cast<float>(n_frames);
+
+    for (float & stage_ms : average.stageMs)
+    {
+        stage_ms /= static_cast<float>(n_frames);
+    }
+
+    average.allocations /= n_frames;
+    average.allocatedBytes /= n_frames;
+
+    for (uint32_t & category_allocations : average.categoryAllocations)
+    {
+        category_allocations /= static_cast<uint32_t>(n_frames);
+    }
+
+    return average;
+}
+
+bool FrameProfiler::WriteCsv(const std::string & path) const
+{
+    std::ofstream file (path);
+    if (!file)
+    {
+        return false;
+    }
+
+    file << "frame,frame_ms";
+    for (size_t stage=0; stage<stageCount; stage++)
+    {
+        file << "," << StageName(static_cast<PROFILE_STAGE>(stage)) << "_ms";
+    }
+
+    file << ",allocations,allocated_bytes";
+    for (size_t category=0; category<allocation_counter::categoryCount; category++)
+    {
+        file << "," << allocation_counter::CategoryName(static_cast<ALLOCATION_CATEGORY>(category)) << "_allocations";
+    }
+    file << "\n";
+
+    for (size_t age=FrameCount(); age>0; age--)
+    {
+        FrameTimes frame = Frame(age - 1);
+        file << frame.frame << "," << frame.frameMs;
+
+        for (float stage_ms : frame.stageMs)
+        {
+            file << "," << stage_ms;
+        }
+
+        file << "," << frame.allocations << "," << frame.allocatedBytes;
+        for (uint32_t category_allocations : frame.categoryAllocations)
+        {
+            file << "," << category_allocations;
+        }
+
+        file << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
+
+const char * FrameProfiler::StageName(PROFILE_STAGE stage)
+{
+    switch (stage)
+    {
+        case PROFILE_STAGE::EVENTS:
+            return "events";
+
+        case PROFILE_STAGE::INTERPOLATION:
+            return "interpolation";
+
+        case PROFILE_STAGE::GEOMETRY:
+            return "geometry";
+
+        case PROFILE_STAGE::OVERLAY:
+            return "overlay";
+
+        case PROFILE_STAGE::DISPLAY:
+            return "display";
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "AllocationCounter.h"
+
+enum class PROFILE_STAGE : uint16_t {EVENTS, INTERPOLATION, GEOMETRY, OVERLAY, DISPLAY};
+
+// times the stages of every frame of the editor loop and keeps the last frameCapacity frames in a ring buffer. the
+// loop is the only writer: a frame is written to the slot after the newest one and published by advancing
+// frameCount, so readers never wait on the writer (readers on another thread should stay well behind the oldest
+// frame, which is the next one overwritten)
+class FrameProfiler
+{
+    public:
+        static constexpr size_t stageCount = 5;
+        static constexpr size_t frameCapacity = 240; // frames kept in the ring buffer (4 seconds at 60 fps)
+
+        struct FrameTimes
+        {
+            uint64_t frame = 0; // number of the frame since the profiler was created
+            float frameMs = 0.0f; // time from BeginFrame to EndFrame
+            std::array<float, stageCount> stageMs = {}; // time spent in every stage (PROFILE_STAGE order)
+            uint64_t allocations = 0; // heap allocations from BeginFrame to EndFrame (0 unless allocation counting is compiled in)
+            uint64_t allocatedBytes = 0;
+            std::array<uint32_t, allocation_counter::categoryCount> categoryAllocations = {}; // ALLOCATION_CATEGORY order
+        };
+
+        // adds the time from its construction to its destruction (or to Stop) to a stage of the current frame
+        class ScopedTimer
+        {
+            private:
+                FrameProfiler * profiler;
+                PROFILE_STAGE stage;
+                std::chrono::steady_clock::time_point begin;
+
+            public:
+                ScopedTimer(FrameProfiler & frame_profiler, PROFILE_STAGE profile_stage);
+                ~ScopedTimer();
+
+                void Stop(); // end the stage before the end of the scope (the destructor then does nothing)
+
+                ScopedTimer(const ScopedTimer &) = delete;
+                ScopedTimer & operator=(const ScopedTimer &) = delete;
+        };
+
+    private:
+        std::array<FrameTimes, frameCapacity> frames;
+        std::atomic<uint64_t> frameCount {0}; // frames written so far, the newest is at (frameCount - 1) % frameCapacity
+        FrameTimes currentFrame; // frame being timed
+        std::chrono::steady_clock::time_point frameBegin;
+        allocation_counter::AllocationStats frameBeginAllocations;
+        bool isEnabled = false;
+        bool isFrameOpen = false;
+
+    public:
+        FrameProfiler() = default;
+
+        void SetEnabled(bool enable); // nothing is timed or recorded while disabled
+        bool IsEnabled() const { return isEnabled; }
+
+        void BeginFrame();
+        void EndFrame(); // publish the current frame to the ring buffer
+        void AddStageTime(PROFILE_STAGE stage, float ms); // add time to a stage of the current frame (used by ScopedTimer)
+        ScopedTimer Scope(PROFILE_STAGE stage) { return {*this, stage}; }
+
+        size_t FrameCount() const; // frames in the ring buffer (at most frameCapacity)
+        FrameTimes Frame(size_t age) const; // frame age frames before the newest one (0 is the newest)
+        FrameTimes Average() const; // mean of every frame in the ring buffer (the allocations are rounded down)
+
+        bool WriteCsv(const std::string & path) const; // write the frames in the ring buffer (oldest first), false if the file can't be written
+        static const char * StageName(PROFILE_STAGE stage);
+};
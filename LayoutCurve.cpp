@@ -0,0 +1,234 @@
+#include "LayoutCurve.h"
+#include "CurveKernel.h"
+#include "CurveLayout.h"
+#include "CurveSegments.h"
+#include "CurveArcLength.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+
+template<CURVE_TYPE WorkType>
+void LayoutCurve<WorkType>::tessellateSegment(const curve_layout::Segment<WorkType> & segment, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out)
+{
+    const auto & p = segment.points;
+
+    tessellateKernel(segment, n_steps, curveData->flatnessTolerance, out);
+
+    if constexpr (WorkType == CURVE_TYPE::CUBIC)
+    {
+        bounds_out.push_back(curve_kernel::BoundsCubic(p[0], p[1], p[2], p[3]));
+        controls_out.push_back(p);
+    }
+    else if constexpr (WorkType == CURVE_TYPE::QUADRATIC)
+    {
+        bounds_out.push_back(curve_kernel::BoundsQuadratic(p[0], p[1], p[2]));
+        controls_out.push_back(curve_arc_length::FromQuadratic(p[0], p[1], p[2]));
+    }
+    else
+    {
+        bounds_out.push_back(curve_kernel::BoundsLinear(p[0], p[1]));
+        controls_out.push_back(curve_arc_length::FromLinear(p[0], p[1]));
+    }
+}
+
+template<CURVE_TYPE WorkType>
+void LayoutCurve<WorkType>::appendSegment(const curve_layout::Segment<WorkType> & segment, const uint32_t & n_steps)
+{
+    tessellationStats.uniformVertexCount += (n_steps + 1);
+    segmentOffsets.push_back(curveList.size());
+
+    tessellateSegment(segment, n_steps, curveList, segmentBounds, segmentControls);
+}
+
+template<CURVE_TYPE WorkType>
+size_t LayoutCurve<WorkType>::segmentCount() const
+{
+    return curve_layout::SegmentCount<WorkType, WorkType>(curveData->pointList);
+}
+
+template<CURVE_TYPE WorkType>
+bool LayoutCurve<WorkType>::hasClosingSegment() const
+{
+    return curve_layout::HasClosingSegment<WorkType, WorkType>(*curveData);
+}
+
+template<CURVE_TYPE WorkType>
+void LayoutCurve<WorkType>::tessellatePointSegment(size_t segment, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out)
+{
+    tessellateSegment(curve_layout::SegmentAt<WorkType, WorkType>(curveData->pointList, segment), n_steps, out, bounds_out, controls_out);
+}
+
+template<CURVE_TYPE WorkType>
+void LayoutCurve<WorkType>::retessellateSegments(size_t first_segment, size_t old_count, size_t new_count)
+{
+    CURVE_TRACE_SCOPE("LayoutCurve::retessellateSegments");
+    CURVE_ALLOCATION_SCOPE(INTERPOLATION);
+
+    // only the hint of the work type maps generated segments 1:1 to segments of the point list. anything else (other
+    // hints, curves too short for a segment, settings changed since the last interpolation) falls back to a full
+    // interpolation
+    const size_t n_segments = segmentCount();
+    const size_t n_segments_prev = segmentOffsets.empty() ? 0 : (segmentOffsets.size() - 1);
+    const uint32_t n_steps = curve_kernel::StepCount(curveData->smoothFactor);
+    const size_t n_handles = curveData->areHandlesGenerated ? handlesPerSegment : 0;
+
+    if (!isSegmentDataValid || (curveData->curveType != WorkType) || (n_segments == 0)
+        || ((first_segment + old_count) > n_segments_prev) || ((n_segments_prev - old_count + new_count) != n_segments)
+        || (handleList.size() != (n_segments_prev * n_handles))
+        || (segmentBounds.size() < n_segments_prev) || (segmentControls.size() < n_segments_prev) || (n_steps != segmentStepCount) || (curveData->tessellationMode != segmentTessellationMode))
+    {
+        InterpolatePoints();
+        return;
+    }
+
+    // the closing segment is always generated last, drop it and regenerate it after the splice since it wraps around
+    // to the first anchor
+    const size_t n_closing_samples_prev = curveList.size() - segmentOffsets.back();
+    const size_t closing_first_prev = segmentOffsets.back();
+    curveList.resize(segmentOffsets.back());
+    segmentBounds.resize(n_segments_prev);
+    segmentControls.resize(n_segments_prev);
+
+    segmentScratch.clear();
+    segmentScratchOffsets.clear();
+    boundsScratch.clear();
+    controlsScratch.clear();
+    handleScratch.clear();
+
+    for (size_t i=first_segment; i<(first_segment + new_count); i++)
+    {
+        segmentScratchOffsets.push_back(segmentScratch.size());
+        tessellatePointSegment(i, n_steps, segmentScratch, boundsScratch, controlsScratch);
+
+        if (curveData->areHandlesGenerated)
+        {
+            curve_layout::AppendHandles<WorkType, WorkType>(curveData->pointList, i, handleScratch);
+        }
+    }
+
+    const size_t first_sample = segmentOffsets[first_segment];
+    const size_t n_samples_prev = segmentOffsets[first_segment + old_count] - first_sample;
+
+    curve_segments::Splice(curveList, segmentOffsets, first_segment, old_count, segmentScratch, segmentScratchOffsets);
+    curve_segments::SpliceFixed(segmentBounds, 1, first_segment, old_count, boundsScratch);
+    curve_segments::SpliceFixed(segmentControls, 1, first_segment, old_count, controlsScratch);
+    curve_segments::SpliceFixed(handleList, n_handles, first_segment, old_count, handleScratch);
+
+    size_t n_generated = n_segments;
+    if (hasClosingSegment())
+    {
+        tessellatePointSegment(n_segments, n_steps, curveList, segmentBounds, segmentControls);
+        n_generated++;
+    }
+
+    // the closing segment is logged as a separate edit at the end
+    const uint64_t generation = curveData->generation;
+    editLog.Record(generation, first_sample, n_samples_prev, segmentScratch.size(), false);
+    editLog.Record(generation, (first_segment * n_handles), (old_count * n_handles), handleScratch.size(), true);
+    editLog.Record(generation, segmentOffsets.back(), n_closing_samples_prev, (curveList.size() - segmentOffsets.back()), false);
+
+    // a drag keeps the number of segments, so only the nodes above the edited segments (and the closing segment,
+    // which is always regenerated) need to be refit
+    isCurveBoundsValid = false;
+    segmentTree.Refit(segmentBounds, first_segment, new_count);
+    arcLengthTable.Splice(first_segment, old_count, new_count);
+    if (hasClosingSegment())
+    {
+        segmentTree.Refit(segmentBounds, n_segments, 1);
+        arcLengthTable.Invalidate(n_segments, 1);
+    }
+
+    tessellationStats.uniformVertexCount = n_generated * (n_steps + 1);
+    tessellationStats.vertexCount = curveList.size();
+
+    // repeat the splice on the structure of arrays copies, or leave them to be converted when they are read
+    if (areStorageArraysValid && (curveData->sampleLayout == SAMPLE_LAYOUT::SOA))
+    {
+        const size_t first_moved = (old_count == new_count) ? n_segments : first_segment; // segments after the edit only move if their number changed
+
+        sampleArrays.Resize(closing_first_prev);
+        sampleArrays.Splice(first_sample, n_samples_prev, segmentScratch);
+        sampleArrays.Splice(segmentOffsets.back(), 0, std::span(curveList).subspan(segmentOffsets.back()));
+        segmentBlocks.Update(segmentControls, first_segment, new_count);
+        segmentBlocks.Update(segmentControls, first_moved, (segmentControls.size() - first_moved));
+    }
+    else
+    {
+        areStorageArraysValid = false;
+    }
+}
+
+template<CURVE_TYPE WorkType>
+template<CURVE_TYPE DataType>
+void LayoutCurve<WorkType>::interpolateWithHint()
+{
+    if constexpr (curve_layout::layoutOf<WorkType, DataType>.isGenerated)
+    {
+        interpolateWithLinearHint();
+    }
+    else
+    {
+        curveList.clear();
+        handleList.clear();
+
+        const uint32_t n_steps = curve_kernel::StepCount(curveData->smoothFactor); // the larger smoothFactor is the smoother the line
+
+        curve_layout::Interpolate<WorkType, DataType>(*curveData, n_steps, curveList, handleList, [&](const curve_layout::Segment<WorkType> & segment)
+        {
+            appendSegment(segment, n_steps);
+        });
+    }
+}
+
+template<CURVE_TYPE WorkType>
+const std::array<void (LayoutCurve<WorkType>::*)(), 4> LayoutCurve<WorkType>::interpolateKernels = {&LayoutCurve::interpolateWithHint<CURVE_TYPE::LINEAR>, &LayoutCurve::interpolateWithHint<CURVE_TYPE::LINEAR>,
+                                                                                                    &LayoutCurve::interpolateWithHint<CURVE_TYPE::QUADRATIC>, &LayoutCurve::interpolateWithHint<CURVE_TYPE::CUBIC>};
+
+template<CURVE_TYPE WorkType>
+void LayoutCurve<WorkType>::InterpolatePoints()
+{
+    CURVE_TRACE_SCOPE("LayoutCurve::InterpolatePoints");
+    CURVE_ALLOCATION_SCOPE(INTERPOLATION);
+
+    tessellationStats = {};
+    segmentOffsets.clear();
+    segmentBounds.clear();
+    segmentControls.clear();
+    isCurveBoundsValid = false;
+    segmentTree.Clear();
+    arcLengthTable.Clear();
+    editLog.Reset(curveData->generation);
+
+    // the tessellation mode and the data type are looked up once here, the segments are generated without branching on them
+    tessellateKernel = curve_layout::SelectTessellateKernel<curve_layout::Degree(WorkType)>(curveData->tessellationMode);
+    (this->*interpolateKernels[std::min(static_cast<size_t>(curveData->curveType), interpolateKernels.size() - 1)])();
+
+    tessellationStats.vertexCount = curveList.size();
+
+    // end the open segments. when the loop is closed the start of the closing segment already does
+    const size_t n_segments = segmentCount();
+    if (segmentOffsets.size() == n_segments)
+    {
+        segmentOffsets.push_back(curveList.size());
+    }
+
+    isSegmentDataValid = (curveData->curveType == WorkType) && (n_segments > 0) && (segmentOffsets.size() == (n_segments + 1));
+    segmentStepCount = curve_kernel::StepCount(curveData->smoothFactor);
+    segmentTessellationMode = curveData->tessellationMode;
+
+    areStorageArraysValid = false;
+    if (curveData->sampleLayout == SAMPLE_LAYOUT::SOA)
+    {
+        updateStorageArrays();
+    }
+}
+
+template<CURVE_TYPE WorkType>
+CURVE_TYPE LayoutCurve<WorkType>::WorkCurveType()
+{
+    return WorkType;
+}
+
+template class LayoutCurve<CURVE_TYPE::LINEAR>;
+template class LayoutCurve<CURVE_TYPE::QUADRATIC>;
+template class LayoutCurve<CURVE_TYPE::CUBIC>;
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "SegmentedCurve.h"
+#include "CurveLayout.h"
+#include <array>
+
+// curve class generating segments of one work type from point lists of every data type through the layouts of
+// curve_layout::hintLayouts. the segments of a point list of the work type itself map 1:1 to the generated segments and
+// are re-tessellated per segment after an edit, every other data type is re-tessellated as a whole
+template<CURVE_TYPE WorkType>
+class LayoutCurve : public SegmentedCurve
+{
+    protected:
+        static constexpr size_t handlesPerSegment = curve_layout::layoutOf<WorkType, WorkType>.nHandles; // handle points generated for each segment
+        static const std::array<void (LayoutCurve::*)(), 4> interpolateKernels; // interpolation from every data type, indexed by CURVE_TYPE
+        curve_layout::TessellateKernel<curve_layout::Degree(WorkType)> tessellateKernel = curve_layout::tessellateKernels<curve_layout::Degree(WorkType)>[0]; // tessellation of a single segment in the mode of the last interpolation
+
+        void tessellateSegment(const curve_layout::Segment<WorkType> & segment, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out); // tessellate a single segment to the end of out and add its bounds to bounds_out and its controls to controls_out
+        void appendSegment(const curve_layout::Segment<WorkType> & segment, const uint32_t & n_steps); // tessellate a single segment to the end of curveList
+        size_t segmentCount() const override; // number of open segments in the point layout of the work type
+        bool hasClosingSegment() const; // true if a segment from the last to the first anchor is generated
+        void tessellatePointSegment(size_t segment, const uint32_t & n_steps, std::vector<std::array<float, 2>> & out, std::vector<CurveBounds> & bounds_out, std::vector<SegmentControls> & controls_out); // tessellateSegment for segment of the point layout of the work type (segmentCount() is the closing segment)
+        void retessellateSegments(size_t first_segment, size_t old_count, size_t new_count) override; // replace old_count generated segments with new_count segments re-tessellated from the point list
+        template<CURVE_TYPE DataType>
+        void interpolateWithHint(); // generate the curve from the points of DataType (curve_layout::hintLayouts)
+        virtual void interpolateWithLinearHint() {} // generate the curve from linear data for the work types that generate its control points themselves (HintLayout::isGenerated)
+
+        void InterpolatePoints() override; // generate curve from CurveData point list
+
+    public:
+        CURVE_TYPE WorkCurveType() override;
+};
@@ -1,20 +1,16 @@
 #include "LinearCurve.h"
+#include "CurveKernel.h"
+#include "CurveLayout.h"
+#include "CurveSegments.h"
+#include "CurveArcLength.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
 
 #include <iostream>
 
-std::array<float, 2> LinearCurve::interpolate(const std::array<float, 2>  & a, const std::array<float, 2> & b, const float & parametric_t)
-{
-    // lerp p0(a), p1(b) which will result in xy
-    float x = std::lerp(a[0], b[0], parametric_t);
-    float y = std::lerp(a[1], b[1], parametric_t);
-
-    // point result on cubic curve
-    return {x, y};
-}
-
 int32_t LinearCurve::GetClosestAnchorPoint(const int32_t & index)
 {
     int32_t anchor_index = index;
@@ -27,292 +23,31 @@ bool LinearCurve::IsAnchorPoint(int32_t index)
     return (sel_idx == 0);
 }
 
-void LinearCurve::interpolateWithLinearHint()
-{
-    constexpr size_t min_points = 2;
-    curveList.clear();
-    handleList.clear();
-
-    if (curveData && curveData->pointList.size() >= min_points)
-    {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
-
-        size_t n_segments = (curveData->pointList.size() - 1);
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        for (size_t i=0; i<n_segments; i++)
-        {
-            uint32_t point_a = (i * 1) + 0;
-            uint32_t point_b = (i * 1) + 1;
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
-
-            if (curveData->areHandlesGenerated)
-            {
-                /*
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_a-1]);
-
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-                */
-            }
-
-        }
-
-        constexpr size_t min_points_for_closed_curve = 2;
-        if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
-        {
-            std::array<float, 2> new_point {};
-
-            if (!curveData->pointList.empty())
-            {
-                uint32_t point_a = curveData->pointList.size()-1;
-                uint32_t point_b = 0;
-
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
-            }
-        }
-    }
-    else if ((curveData && curveData->pointList.size() >= (min_points-1)) && curveData->areHandlesGenerated)
-    {
-        // draw handles if there are at least 3 points
-        /*
-        uint32_t point_a = 1;
-        uint32_t point_b = 2;
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_a-1]);
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_b]);
-        */
-    }
-    else
-    {
-        std::cerr << "no curve data available or not enough data points!\n";
-    }
-}
-
-void LinearCurve::interpolateWithQuadraticHint()
-{
-    constexpr size_t min_points = 4;
-    curveList.clear();
-    handleList.clear();
-
-    if (curveData && curveData->pointList.size() >= min_points)
-    {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
-
-        size_t n_segments = (curveData->pointList.size() / 2) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        for (size_t i=0; i<n_segments; i++)
-        {
-            uint32_t point_a = (i * 2) + 0;
-            uint32_t point_c = (i * 2) + 2;
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_c], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
-        }
-
-        constexpr size_t min_points_for_closed_curve = 4;
-        if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
-        {
-            std::array<float, 2> new_point {};
-
-            if (!curveData->pointList.empty())
-            {
-                uint32_t point_a = curveData->pointList.size()-2;
-                uint32_t point_c = 0;
-
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_c], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
-            }
-        }
-    }
-}
-
-void LinearCurve::interpolateWithCubicHint()
-{
-    constexpr size_t min_points = 4;
-    curveList.clear();
-    handleList.clear();
-
-    if (curveData && curveData->pointList.size() >= min_points)
-    {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
-
-        size_t n_segments = (curveData->pointList.size() / 3) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        for (size_t i=0; i<n_segments; i++)
-        {
-            uint32_t point_a = (i * 3) + 1;
-            uint32_t point_d = (i * 3) + 4;
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_d], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
-
-            if (curveData->areHandlesGenerated)
-            {
-                /*
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_a-1]);
-
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_c]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_d+1]);
-                */
-            }
-
-        }
-
-        constexpr size_t min_points_for_closed_curve = 6;
-        if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
-        {
-            std::array<float, 2> new_point {};
-
-            if (!curveData->pointList.empty())
-            {
-                uint32_t point_a = curveData->pointList.size()-2;
-                uint32_t point_d = 1;
-
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_d], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
-            }
-        }
-    }
-}
-
-void LinearCurve::AddPoint(std::array<float, 2> point)
-{
-    if (curveData)
-    {
-        curveData->pointList.push_back(point);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void LinearCurve::InsertPoint(std::array<float, 2> point, int32_t index)
+void LinearCurve::markPointsDirty(int32_t first_point, int32_t last_point)
 {
-    if (curveData)
-    {
-        curveData->pointList.insert(curveData->pointList.begin() + index, point);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
+    // segment i is made of the points i and i+1
+    const int32_t n_segments = static_cast<int32_t>(segmentCount());
+    int32_t first_segment = std::min(std::max(first_point - 1, 0), n_segments);
+    int32_t last_segment = std::min(last_point, n_segments - 1);
+    size_t n_dirty = (last_segment >= first_segment) ? (last_segment - first_segment + 1) : 0;
 
-void LinearCurve::DeletePoint(int32_t index)
-{
-    if (curveData)
-    {
-        curveData->pointList.erase(curveData->pointList.begin() + index);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void LinearCurve::InterpolatePoints()
-{
-    if (curveData->curveType == CURVE_TYPE::CUBIC)
-    {
-        interpolateWithCubicHint();
-    }
-    else if (curveData->curveType == CURVE_TYPE::QUADRATIC)
-    {
-        interpolateWithQuadraticHint();
-    }
-    else // CURVE_TYPE::LINEAR
-    {
-        interpolateWithLinearHint();
-    }
+    markSegmentsDirty(first_segment, n_dirty, n_dirty);
 }
 
 LinearCurve::LinearCurve(CurveData *curve_data)
 {
-    curveData = curve_data;
+    setCurveData(curve_data);
 }
 
 void LinearCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURVE_CONTROL curve_control)
 {
+    CURVE_TRACE_SCOPE("LinearCurve::UpdatePoint");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData && !curveData->pointList.empty())
     {
+        markPointsDirty(index, index); // only the point changes with linear data (other data is re-tessellated fully)
+
         // if the point selected to be updated is an anchor point then update the control points to move along
         // with the updated anchor point position
 
@@ -334,7 +69,7 @@ void LinearCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURV
 
         curveData->pointList[index] = position;
 
-        InterpolatePoints(); // update curve data
+        curveData->pointGrid.Update(curveData->pointList, (index-1), (index+1));
     }
     else
     {
@@ -344,22 +79,27 @@ void LinearCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURV
 
 void LinearCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor)
 {
+    CURVE_TRACE_SCOPE("LinearCurve::AddAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (CurveType() == CURVE_TYPE::LINEAR)
     {
         if (place_anchor == PLACE_ANCHOR::END) // add new points to end of the curve
         {
+            markSegmentsDirty(segmentCount(), 0, 1); // new segment after the last one
+
             // add new anchor point
             AddPoint(point); // new anchor point
         } else // add new points to beginning of the curve PLACE_ANCHOR::BEG
         {
+            markSegmentsDirty(0, 0, 1); // new segment before the first one
+
             // insert in front of the first point
             const int32_t index = 0;
 
             // add new anchor point
             InsertPoint(point, index); // anchor point
         }
-
-        InterpolatePoints();
     }
     else
     {
@@ -369,6 +109,9 @@ void LinearCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_ancho
 
 void LinearCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
 {
+    CURVE_TRACE_SCOPE("LinearCurve::InsertAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (CurveType() == CURVE_TYPE::LINEAR)
     {
         if (curveData && (index > 1)) // NEED UPDATE
@@ -397,7 +140,7 @@ void LinearCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
             std::array<float, 2> new_control_point_0 = {(point[0] + last_anchor_offset0[0]), (point[1] + last_anchor_offset0[1])};
             InsertPoint(new_control_point_0, (index+1)); // control point
 
-            InterpolatePoints();
+            markInterpolationDirty();
         }
         else
         {
@@ -412,12 +155,29 @@ void LinearCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
 
 void LinearCurve::RemoveAnchor(int32_t index)
 {
+    CURVE_TRACE_SCOPE("LinearCurve::RemoveAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (CurveType() == CURVE_TYPE::LINEAR)
     {
         if (curveData && (!curveData->pointList.empty()))
         {
+            const int32_t last_anchor = static_cast<int32_t>(curveData->pointList.size()) - 1;
+
+            if (index == 0)
+            {
+                markSegmentsDirty(0, 1, 0); // first segment is removed
+            }
+            else if (index == last_anchor)
+            {
+                markSegmentsDirty((index - 1), 1, 0); // last segment is removed
+            }
+            else
+            {
+                markSegmentsDirty((index - 1), 2, 1); // the 2 segments sharing the point are merged
+            }
+
             DeletePoint(index);
-            InterpolatePoints();
         }
         else
         {
@@ -430,110 +190,99 @@ void LinearCurve::RemoveAnchor(int32_t index)
     }
 }
 
-void LinearCurve::CloseLoop(bool close_loop)
+void LinearCurve::BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles)
 {
-    if(curveData)
+    CURVE_TRACE_SCOPE("LinearCurve::BuildFromAnchors");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (CurveType() == CURVE_TYPE::LINEAR)
+    {
+        if (handles.empty())
+        {
+            // build the whole point list in one pass and tessellate once instead of adding each anchor separately
+            curveData->pointList.assign(anchors.begin(), anchors.end());
+            curveData->pointGrid.Clear(); // rebuilt on the next query
+            markInterpolationDirty();
+        }
+        else
+        {
+            std::cerr << "linear curves have no handles!\n";
+        }
+    }
+    else
     {
-        curveData->isCloseLoop = close_loop;
-        InterpolatePoints();
+        std::cout << "Unable to build curve. Mismatch curve to work on!\n";
     }
 }
 
-std::pair<std::array<float, 2>, uint32_t> LinearCurve::IntersectionOnCurve(std::array<float, 2> position)
+CurveIntersection LinearCurve::NearestPointOnCurve(std::array<float, 2> position)
 {
-    std::array<float,2> position_on_curve = {std::numeric_limits<float>::min(), std::numeric_limits<float>::min()};
-    uint32_t index_insert_index = -1;
+    CURVE_TRACE_SCOPE("LinearCurve::NearestPointOnCurve");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    CurveIntersection nearest;
 
-    if (curveData && (curveData->pointList.size() >= 2))
+    if (!curveData)
     {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
+        return nearest;
+    }
 
-        float t = t_constrain_beg; // 0 <= t <= 1.0
+    updateInterpolation();
 
-        float step_size = 1.0f / (curveData->smoothFactor * 2.0f); // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
+    if (!segmentTree.IsBuilt(segmentBounds))
+    {
+        segmentTree.Build(segmentBounds);
+    }
 
-        size_t n_segments = (curveData->pointList.size() - 1);
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
+    const PointList & points = curveData->pointList;
+    const bool is_point_list_segment = (curveData->curveType == CURVE_TYPE::LINEAR);
+    float nearest_distance = std::numeric_limits<float>::max();
 
-        bool found_intersection = false;
+    // the segments of the linear curve type are read from the point list. the other hints generate segments that aren't
+    // in it, those are projected onto their cubic form in segmentControls
+    segmentTree.Nearest(position, [&](size_t segment)
+    {
+        float t = 0.0f;
+        std::array<float, 2> point_on_segment = {};
 
-        for (size_t i=0; i<n_segments; i++)
+        if (is_point_list_segment)
         {
-            uint32_t point_a = (i * 1) + 0; // anchor point
-            uint32_t point_b = (i * 1) + 1; // next anchor point
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], t);
-
-                // check point
-                std::array<float, 2> check_distance = {std::abs(new_point[0] - position[0]), std::abs(new_point[1] - position[1])};
-                float dst = std::sqrt((check_distance[0]*check_distance[0]) + (check_distance[1]*check_distance[1]));
-
-                constexpr float default_radius = 10.0f;
-                if (dst <= default_radius)
-                {
-                    position_on_curve = new_point;
-                    index_insert_index = point_b;
-                    found_intersection = true;
-                    break;
-                }
-
-                t += step_size;
-            }
-
-            if (found_intersection)
-            {
-                break;
-            }
-
-            t = t_constrain_beg;
+            const curve_layout::Segment<CURVE_TYPE::LINEAR> p = curve_layout::SegmentAt<CURVE_TYPE::LINEAR, CURVE_TYPE::LINEAR>(points, segment);
+            t = curve_kernel::ClosestLinear(p.points[0], p.points[1], position);
+            point_on_segment = p.Evaluate(t);
+        }
+        else
+        {
+            const SegmentControls & p = segmentControls[segment];
+            t = curve_kernel::ClosestCubic(p[0], p[1], p[2], p[3], position);
+            point_on_segment = curve_layout::Segment<CURVE_TYPE::CUBIC>{p}.Evaluate(t);
         }
-    }
-
-    return {position_on_curve, index_insert_index};
-}
-
-std::vector<std::array<float, 2>> LinearCurve::Data()
-{
-    return curveList;
-}
 
-const std::vector<std::array<float, 2>> & LinearCurve::HandleData()
-{
-    return handleList;
-}
+        float dx = point_on_segment[0] - position[0];
+        float dy = point_on_segment[1] - position[1];
+        float distance = (dx * dx) + (dy * dy);
 
-const std::vector<std::array<float, 2>> & LinearCurve::GetPointData()
-{
-    return curveData->pointList;
-}
+        if (distance < nearest_distance)
+        {
+            nearest_distance = distance;
+            nearest.found = true;
+            nearest.position = point_on_segment;
+            nearest.t = t;
+            nearest.segment = segment;
+        }
 
-void LinearCurve::ForceInterpolation()
-{
-    InterpolatePoints();
-}
+        return distance;
+    });
 
-CURVE_TYPE LinearCurve::CurveType()
-{
-    CURVE_TYPE curve_type = CURVE_TYPE::UNKNOWN;
-
-    if (curveData)
+    if (nearest.found)
     {
-        curve_type = curveData->curveType;
-    }
+        nearest.distance = std::sqrt(nearest_distance);
 
-    return curve_type;
-}
+        // anchors can't be inserted into the closing segment
+        nearest.insertIndex = curve_layout::InsertIndex(curveData->curveType, points, nearest.segment);
+    }
 
-CURVE_TYPE LinearCurve::WorkCurveType()
-{
-    return CURVE_TYPE::LINEAR;
+    return nearest;
 }
 
 std::unique_ptr<CurveData> LinearCurve::NewCurveData()
@@ -1,34 +1,20 @@
 #pragma once
 
-#include "Curve.h"
+#include "LayoutCurve.h"
 #include <vector>
 #include <array>
 #include <memory>
 
-class LinearCurve : public ICurve
+class LinearCurve final : public LayoutCurve<CURVE_TYPE::LINEAR>
 {
     private:
-        static std::array<float, 2> interpolate(const std::array<float, 2>  & a, const std::array<float, 2> & b, const float & parametric_t);
-
-        CurveData * curveData = nullptr; // curve data block used by this class to generate the curve data
-
-        std::vector<std::array<float, 2>> curveList; // data that holds the generated curve from CurveData
-        std::vector<std::array<float, 2>> handleList; // data that holds the generated curve handles from CurveData
 
         static constexpr float initialControlDistance = 50.0f; // initial distance from the 1st anchor point created
 
         static int32_t GetClosestAnchorPoint(const int32_t & index);
         static bool IsAnchorPoint(int32_t index);
 
-        void interpolateWithLinearHint(); // generate cubic cubic curve from linear
-        void interpolateWithQuadraticHint(); // generate cubic curve from quadratic
-        void interpolateWithCubicHint(); // generate a cubic curve
-
-    protected:
-        void AddPoint(std::array<float, 2> point) override; // // add points
-        void InsertPoint(std::array<float, 2> point, int32_t index) override; // insert points
-        void DeletePoint(int32_t index) override; // delete points
-        void InterpolatePoints() override; // generate curve from CurveData point list
+        void markPointsDirty(int32_t first_point, int32_t last_point); // record an edit of the given range of points before it is made
 
     public:
         LinearCurve() = default;
@@ -38,26 +24,18 @@ class LinearCurve : public ICurve
         void AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor) override; // add new point with control points of previous anchor (if exist)
         void InsertAnchor(std::array<float, 2> point, int32_t index) override;
         void RemoveAnchor(int32_t index) override; // remove anchor and control points from curve
-        void CloseLoop(bool close_loop) override; // close the curve - create a line from the last point to the first
-        std::pair<std::array<float, 2>, uint32_t> IntersectionOnCurve(std::array<float, 2> position) override; // get intersecting position of point on the curve and also the insertion index to insert a new point
-
-        std::vector<std::array<float, 2>> Data() override; // return generated curve data points
-        const std::vector<std::array<float, 2>> & HandleData() override; // return generated curve handle data points
-        const std::vector<std::array<float, 2>> & GetPointData() override;
-
-        void ForceInterpolation() override;
-        CURVE_TYPE CurveType() override;
-        CURVE_TYPE WorkCurveType() override;
+        void BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles = {}) override; // replace the curve with the anchors. lines have no handles so handles has to be empty
+        CurveIntersection NearestPointOnCurve(std::array<float, 2> position) override; // exact nearest point on the generated curve (for every curve type)
 
         LinearCurve & operator= (const std::unique_ptr<CurveData> & rhs)
         {
-            this->curveData = rhs.get();
+            this->setCurveData(rhs.get());
             return *this;
         }
 
         LinearCurve & operator= (std::unique_ptr<CurveData>&& rhs)
         {
-            this->curveData = rhs.get();
+            this->setCurveData(rhs.get());
             return *this;
         }
 
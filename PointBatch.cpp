@@ -0,0 +1,100 @@
+#include "PointBatch.h"
+
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+bool PointBatch::PointStyle::operator==(const PointStyle & rhs) const
+{
+    return (position == rhs.position) && (radius == rhs.radius) && (fillColor == rhs.fillColor) && (outlineColor == rhs.outlineColor);
+}
+
+PointBatch::PointBatch(size_t segments_per_circle, float outline_thickness)
+    : outlineThickness(outline_thickness)
+{
+    const size_t n_segments = std::max(segments_per_circle, size_t(3));
+    unitCircle.resize(n_segments);
+
+    for (size_t i=0; i<n_segments; i++)
+    {
+        float angle = (2.0f * std::numbers::pi_v<float> * static_cast<float>(i)) / static_cast<float>(n_segments);
+        unitCircle[i] = {std::cos(angle), std::sin(angle)};
+    }
+}
+
+void PointBatch::buildPoint(size_t index)
+{
+    const PointStyle & style = pointStyles[index];
+    const size_t n_segments = unitCircle.size();
+    const float outer_radius = style.radius + outlineThickness;
+
+    sf::Vertex * out = vertices.data() + (index * VerticesPerPoint());
+    const sf::Vector2f center(style.position[0], style.position[1]);
+
+    auto on_circle = [&](size_t segment, float radius)
+    {
+        const std::array<float, 2> & direction = unitCircle[segment % n_segments];
+        return sf::Vector2f((style.position[0] + (direction[0] * radius)), (style.position[1] + (direction[1] * radius)));
+    };
+
+    // disc
+    for (size_t i=0; i<n_segments; i++)
+    {
+        *out++ = sf::Vertex(center, style.fillColor);
+        *out++ = sf::Vertex(on_circle(i, style.radius), style.fillColor);
+        *out++ = sf::Vertex(on_circle(i+1, style.radius), style.fillColor);
+    }
+
+    // outline ring, a quad between the radius and the outer radius per segment
+    for (size_t i=0; i<n_segments; i++)
+    {
+        sf::Vector2f inner_0 = on_circle(i, style.radius);
+        sf::Vector2f inner_1 = on_circle(i+1, style.radius);
+        sf::Vector2f outer_0 = on_circle(i, outer_radius);
+        sf::Vector2f outer_1 = on_circle(i+1, outer_radius);
+
+        *out++ = sf::Vertex(inner_0, style.outlineColor);
+        *out++ = sf::Vertex(outer_0, style.outlineColor);
+        *out++ = sf::Vertex(outer_1, style.outlineColor);
+        *out++ = sf::Vertex(inner_0, style.outlineColor);
+        *out++ = sf::Vertex(outer_1, style.outlineColor);
+        *out++ = sf::Vertex(inner_1, style.outlineColor);
+    }
+}
+
+void PointBatch::SetPoint(size_t index, const PointStyle & style)
+{
+    if (index == pointStyles.size())
+    {
+        pointStyles.push_back(style);
+        vertices.resize(pointStyles.size() * VerticesPerPoint());
+        buildPoint(index);
+    }
+    else if ((index < pointStyles.size()) && (pointStyles[index] != style))
+    {
+        pointStyles[index] = style;
+        buildPoint(index);
+    }
+}
+
+void PointBatch::Resize(size_t n_points)
+{
+    if (n_points < pointStyles.size())
+    {
+        pointStyles.resize(n_points);
+        vertices.resize(n_points * VerticesPerPoint());
+    }
+}
+
+void PointBatch::SetOutlineThickness(float outline_thickness)
+{
+    if (outline_thickness != outlineThickness)
+    {
+        outlineThickness = outline_thickness;
+
+        for (size_t i=0; i<pointStyles.size(); i++)
+        {
+            buildPoint(i);
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Color.hpp>
+
+// builds the circles of many points (a filled disc and an outline ring each) into a single triangle list so they can
+// be drawn with one draw call instead of one sf::CircleShape per point. only the circles of points whose style
+// changed are regenerated. the geometry doesn't need a window or render target to be built
+class PointBatch
+{
+    public:
+        struct PointStyle
+        {
+            std::array<float, 2> position = {};
+            float radius = 0.0f;
+            sf::Color fillColor;
+            sf::Color outlineColor;
+
+            bool operator==(const PointStyle & rhs) const;
+            bool operator!=(const PointStyle & rhs) const { return !(*this == rhs); }
+        };
+
+    private:
+        std::vector<sf::Vertex> vertices; // triangles of every circle in point order (the disc and then the ring)
+        std::vector<PointStyle> pointStyles; // style every circle was last built with
+        std::vector<std::array<float, 2>> unitCircle; // cos/sin of every segment of a circle
+        float outlineThickness = 2.0f; // width of the ring outside of the radius (same as sf::Shape)
+
+        void buildPoint(size_t index); // regenerate the vertices of the circle at index from its style
+
+    public:
+        explicit PointBatch(size_t segments_per_circle = 30, float outline_thickness = 2.0f);
+
+        void SetPoint(size_t index, const PointStyle & style); // set the style of the circle at index (the batch grows if index is the next circle)
+        void Resize(size_t n_points); // keep the first n_points circles
+        void SetOutlineThickness(float outline_thickness);
+
+        size_t PointCount() const { return pointStyles.size(); }
+        size_t VerticesPerPoint() const { return unitCircle.size() * 9; } // 3 per disc triangle and 6 per ring quad
+        const std::vector<sf::Vertex> & Vertices() const { return vertices; } // draw as sf::PrimitiveType::Triangles
+};
@@ -0,0 +1,285 @@
+#include "PointGrid.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+int32_t PointGrid::cellCoordinate(float value) const
+{
+    constexpr float max_coordinate = static_cast<float>(std::numeric_limits<int32_t>::max() / 2);
+    return static_cast<int32_t>(std::clamp(std::floor(value / cellSize), -max_coordinate, max_coordinate));
+}
+
+uint64_t PointGrid::cellKey(int32_t cell_x, int32_t cell_y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32) | static_cast<uint32_t>(cell_y);
+}
+
+uint64_t PointGrid::pointKey(const std::array<float, 2> & point)
+{
+    int32_t cell_x = cellCoordinate(point[0]);
+    int32_t cell_y = cellCoordinate(point[1]);
+
+    cellMin = {std::min(cellMin[0], cell_x), std::min(cellMin[1], cell_y)};
+    cellMax = {std::max(cellMax[0], cell_x), std::max(cellMax[1], cell_y)};
+
+    return cellKey(cell_x, cell_y);
+}
+
+void PointGrid::addToCell(uint64_t key, uint32_t index)
+{
+    cells[key].push_back(index + indexBase);
+}
+
+void PointGrid::removeFromCell(uint64_t key, uint32_t index)
+{
+    auto cell = cells.find(key);
+    if (cell != cells.end())
+    {
+        std::vector<uint32_t> & indices = cell->second;
+        auto it = std::find(indices.begin(), indices.end(), (index + indexBase));
+
+        if (it != indices.end())
+        {
+            *it = indices.back();
+            indices.pop_back();
+        }
+
+        // an emptied cell is kept (until the grid is rebuilt) so a point dragged back and forth over a cell border
+        // doesn't free and allocate the cell every time
+    }
+}
+
+void PointGrid::shiftIndices(size_t first_index, size_t last_index, int32_t offset)
+{
+    // shifting point by point searches the cell of every point, once there are more points than cells a single pass
+    // over every cell is cheaper
+    if ((last_index - first_index) > cells.size())
+    {
+        for (auto & cell : cells)
+        {
+            for (uint32_t & stored_index : cell.second)
+            {
+                uint32_t index = stored_index - indexBase;
+                if ((index >= first_index) && (index < last_index))
+                {
+                    stored_index += static_cast<uint32_t>(offset);
+                }
+            }
+        }
+
+        return;
+    }
+
+    auto shift = [&](size_t i)
+    {
+        std::vector<uint32_t> & indices = cells[pointCells[i]];
+        std::replace(indices.begin(), indices.end(), (static_cast<uint32_t>(i) + indexBase), (static_cast<uint32_t>(i) + indexBase + static_cast<uint32_t>(offset)));
+    };
+
+    // go against the direction of the shift so a shifted index never matches one that still has to be shifted
+    if (offset > 0)
+    {
+        for (size_t i=last_index; i>first_index; i--)
+        {
+            shift(i-1);
+        }
+    }
+    else
+    {
+        for (size_t i=first_index; i<last_index; i++)
+        {
+            shift(i);
+        }
+    }
+}
+
+void PointGrid::Build(const PointList & points)
+{
+    cells.clear();
+    pointCells.resize(points.size());
+    indexBase = 0;
+    cellMin = {std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max()};
+    cellMax = {std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min()};
+
+    for (size_t i=0; i<points.size(); i++)
+    {
+        pointCells[i] = pointKey(points[i]);
+        addToCell(pointCells[i], static_cast<uint32_t>(i));
+    }
+
+    isBuilt = true;
+}
+
+void PointGrid::Clear()
+{
+    cells.clear();
+    pointCells.clear();
+    isBuilt = false;
+}
+
+void PointGrid::Insert(size_t index, const std::array<float, 2> & point)
+{
+    if (!isBuilt)
+    {
+        return;
+    }
+
+    // every point from index on moves up by 1. when that is the longer side, move every point up by lowering
+    // indexBase and move the points in front of index back down instead
+    if (index >= (pointCells.size() / 2))
+    {
+        shiftIndices(index, pointCells.size(), 1);
+    }
+    else
+    {
+        shiftIndices(0, index, -1);
+        indexBase--;
+    }
+
+    uint64_t key = pointKey(point);
+    pointCells.insert(pointCells.begin() + static_cast<std::ptrdiff_t>(index), key);
+    addToCell(key, static_cast<uint32_t>(index));
+}
+
+void PointGrid::Erase(size_t index)
+{
+    if (!isBuilt || (index >= pointCells.size()))
+    {
+        return;
+    }
+
+    removeFromCell(pointCells[index], static_cast<uint32_t>(index));
+
+    // same as above, every point after index moves down by 1
+    if (index >= (pointCells.size() / 2))
+    {
+        shiftIndices((index + 1), pointCells.size(), -1);
+    }
+    else
+    {
+        shiftIndices(0, index, 1);
+        indexBase++;
+    }
+
+    pointCells.erase(pointCells.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+void PointGrid::Update(const PointList & points, int32_t first_index, int32_t last_index)
+{
+    if (!IsBuiltFor(points))
+    {
+        return;
+    }
+
+    first_index = std::max(first_index, 0);
+    last_index = std::min(last_index, static_cast<int32_t>(points.size()) - 1);
+
+    for (int32_t i=first_index; i<=last_index; i++)
+    {
+        // most moves stay inside the same cell
+        uint64_t key = pointKey(points[i]);
+        if (key != pointCells[i])
+        {
+            removeFromCell(pointCells[i], static_cast<uint32_t>(i));
+            addToCell(key, static_cast<uint32_t>(i));
+            pointCells[i] = key;
+        }
+    }
+}
+
+void PointGrid::PointsInRadius(const PointList & points, const std::array<float, 2> & position, float radius, std::vector<uint32_t> & out) const
+{
+    out.clear();
+
+    const int32_t cell_x_beg = std::max(cellCoordinate(position[0] - radius), cellMin[0]);
+    const int32_t cell_x_end = std::min(cellCoordinate(position[0] + radius), cellMax[0]);
+    const int32_t cell_y_beg = std::max(cellCoordinate(position[1] - radius), cellMin[1]);
+    const int32_t cell_y_end = std::min(cellCoordinate(position[1] + radius), cellMax[1]);
+    const float radius_sqr = radius * radius;
+
+    for (int32_t cell_x=cell_x_beg; cell_x<=cell_x_end; cell_x++)
+    {
+        for (int32_t cell_y=cell_y_beg; cell_y<=cell_y_end; cell_y++)
+        {
+            auto cell = cells.find(cellKey(cell_x, cell_y));
+            if (cell == cells.end())
+            {
+                continue;
+            }
+
+            for (uint32_t stored_index : cell->second)
+            {
+                uint32_t index = stored_index - indexBase;
+                float x_distance = points[index][0] - position[0];
+                float y_distance = points[index][1] - position[1];
+
+                if (((x_distance * x_distance) + (y_distance * y_distance)) <= radius_sqr)
+                {
+                    out.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+int32_t PointGrid::NearestPoint(const PointList & points, const std::array<float, 2> & position, float max_distance) const
+{
+    int32_t nearest_index = -1;
+    float nearest_distance_sqr = max_distance * max_distance;
+
+    if (pointCells.empty())
+    {
+        return nearest_index;
+    }
+
+    const int32_t center_x = cellCoordinate(position[0]);
+    const int32_t center_y = cellCoordinate(position[1]);
+
+    // visit rings of cells around the cell of position. a point in ring n is at least (n - 1) * cellSize away, so the
+    // search stops once that is farther than the closest point found so far (or max_distance), or the ring is outside
+    // of every cell a point has been added to
+    const int32_t max_ring = std::max({center_x - cellMin[0], cellMax[0] - center_x, center_y - cellMin[1], cellMax[1] - center_y});
+
+    for (int32_t ring=0; ring<=max_ring; ring++)
+    {
+        float ring_distance = static_cast<float>(std::max(ring - 1, 0)) * cellSize;
+        if ((ring_distance * ring_distance) > nearest_distance_sqr)
+        {
+            break;
+        }
+
+        for (int32_t cell_x=(center_x - ring); cell_x<=(center_x + ring); cell_x++)
+        {
+            // only the border of the ring, the inside has been visited by the previous rings
+            const bool is_border_column = (cell_x == (center_x - ring)) || (cell_x == (center_x + ring));
+            const int32_t cell_y_step = is_border_column ? 1 : std::max(ring * 2, 1);
+
+            for (int32_t cell_y=(center_y - ring); cell_y<=(center_y + ring); cell_y+=cell_y_step)
+            {
+                auto cell = cells.find(cellKey(cell_x, cell_y));
+                if (cell == cells.end())
+                {
+                    continue;
+                }
+
+                for (uint32_t stored_index : cell->second)
+                {
+                    uint32_t index = stored_index - indexBase;
+                    float x_distance = points[index][0] - position[0];
+                    float y_distance = points[index][1] - position[1];
+                    float distance_sqr = (x_distance * x_distance) + (y_distance * y_distance);
+
+                    // the highest index wins a tie, it is drawn on top
+                    if ((distance_sqr < nearest_distance_sqr) || ((distance_sqr == nearest_distance_sqr) && (static_cast<int32_t>(index) > nearest_index)))
+                    {
+                        nearest_distance_sqr = distance_sqr;
+                        nearest_index = static_cast<int32_t>(index);
+                    }
+                }
+            }
+        }
+    }
+
+    return nearest_index;
+}
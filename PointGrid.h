@@ -0,0 +1,49 @@
+#pragma once
+
+#include "PointList.h"
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+// uniform grid over the points of a curve used for picking and hovering. points are hashed into square cells of
+// cellSize, so a query only looks at the few cells its radius covers instead of every point. moving a point only
+// re-bins that point. cells store point indices relative to indexBase, so inserting or erasing a point only renumbers
+// the points on the shorter side of it (none when appending or prepending)
+class PointGrid
+{
+    private:
+        std::unordered_map<uint64_t, std::vector<uint32_t>> cells; // indices (+ indexBase) of the points in every cell a point has been in since the last build (may be empty)
+        std::deque<uint64_t> pointCells; // cell of every point
+        uint32_t indexBase = 0; // subtracted from the indices in cells (wraps around)
+        std::array<int32_t, 2> cellMin = {0, 0}; // lowest cell coordinates a point has been added to (never shrinks)
+        std::array<int32_t, 2> cellMax = {-1, -1}; // highest cell coordinates a point has been added to (never shrinks)
+        float cellSize = 32.0f;
+        bool isBuilt = false;
+
+        int32_t cellCoordinate(float value) const;
+        static uint64_t cellKey(int32_t cell_x, int32_t cell_y);
+        uint64_t pointKey(const std::array<float, 2> & point);
+        void addToCell(uint64_t key, uint32_t index);
+        void removeFromCell(uint64_t key, uint32_t index);
+        void shiftIndices(size_t first_index, size_t last_index, int32_t offset); // add offset to the stored index of every point in [first_index, last_index)
+
+    public:
+        PointGrid() = default;
+        explicit PointGrid(float cell_size) : cellSize(cell_size) {}
+
+        void Build(const PointList & points); // rebuild the grid over all points
+        void Clear(); // drop the grid, it is rebuilt by the next Build
+        bool IsBuiltFor(const PointList & points) const { return isBuilt && (pointCells.size() == points.size()); }
+
+        // keep a built grid in sync with the point list (these do nothing if the grid isn't built)
+        void Insert(size_t index, const std::array<float, 2> & point); // point was inserted in front of index
+        void Erase(size_t index); // the point at index was erased
+        void Update(const PointList & points, int32_t first_index, int32_t last_index); // points in [first_index, last_index] may have moved (clamped to the list)
+
+        void PointsInRadius(const PointList & points, const std::array<float, 2> & position, float radius, std::vector<uint32_t> & out) const; // indices of every point within radius of position (unordered)
+        int32_t NearestPoint(const PointList & points, const std::array<float, 2> & position, float max_distance) const; // index of the closest point within max_distance of position (-1 if there is none)
+};
@@ -0,0 +1,164 @@
+#include "PointList.h"
+
+#include <utility>
+#include <algorithm>
+
+PointList::PointList(std::initializer_list<value_type> points)
+{
+    assign(points.begin(), points.end());
+}
+
+PointList::PointList(const PointList & rhs)
+{
+    assign(rhs.begin(), rhs.end());
+}
+
+PointList::PointList(PointList && rhs) noexcept
+{
+    *this = std::move(rhs);
+}
+
+PointList & PointList::operator=(const PointList & rhs)
+{
+    if (this != &rhs)
+    {
+        assign(rhs.begin(), rhs.end());
+    }
+
+    return *this;
+}
+
+PointList & PointList::operator=(PointList && rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        // moving the vector keeps its data pointer, so an owned buffer stays valid
+        storage = std::move(rhs.storage);
+        buffer = rhs.buffer;
+        bufferSize = rhs.bufferSize;
+        head = rhs.head;
+        count = rhs.count;
+        gapIndex = rhs.gapIndex;
+
+        rhs.storage.clear();
+        rhs.buffer = nullptr;
+        rhs.bufferSize = 0;
+        rhs.clear();
+    }
+
+    return *this;
+}
+
+void PointList::moveGap(size_t index)
+{
+    const size_t gap_size = gapSize();
+
+    if ((index == gapIndex) || (gap_size == 0))
+    {
+        // without a gap every position of it is the same
+        gapIndex = index;
+        return;
+    }
+
+    // the gap at the end and the gap at the front are the same space, switch to the closer one first
+    if ((gapIndex == count) && (index < (count / 2)))
+    {
+        head = wrap(head + bufferSize - gap_size);
+        gapIndex = 0;
+    }
+    else if ((gapIndex == 0) && (index > (count / 2)))
+    {
+        head = wrap(head + gap_size);
+        gapIndex = count;
+    }
+
+    // move the points between the gap and index to the other side of the gap
+    while (gapIndex > index)
+    {
+        gapIndex--;
+        buffer[wrap(head + gapIndex + gap_size)] = buffer[wrap(head + gapIndex)];
+    }
+
+    while (gapIndex < index)
+    {
+        buffer[wrap(head + gapIndex)] = buffer[wrap(head + gapIndex + gap_size)];
+        gapIndex++;
+    }
+}
+
+void PointList::grow(size_t min_capacity)
+{
+    constexpr size_t min_buffer_size = 16;
+    std::vector<value_type> new_buffer(std::max({min_capacity, (bufferSize * 2), min_buffer_size}));
+
+    for (size_t i=0; i<count; i++)
+    {
+        new_buffer[i] = (*this)[i];
+    }
+
+    storage.swap(new_buffer);
+    buffer = storage.data();
+    bufferSize = storage.size();
+    head = 0;
+    gapIndex = count;
+}
+
+void PointList::insert(size_t index, const value_type & point)
+{
+    if (gapSize() == 0)
+    {
+        grow(count + 1);
+    }
+
+    moveGap(index);
+
+    // the point takes the first slot of the gap
+    buffer[wrap(head + gapIndex)] = point;
+    gapIndex++;
+    count++;
+}
+
+void PointList::erase(size_t index, size_t n_points)
+{
+    // the erased points become the start of the gap
+    moveGap(index);
+    count -= n_points;
+}
+
+void PointList::clear()
+{
+    head = 0;
+    count = 0;
+    gapIndex = 0;
+}
+
+void PointList::reserve(size_t n_points)
+{
+    if (n_points > bufferSize)
+    {
+        grow(n_points);
+    }
+}
+
+void PointList::Borrow(value_type * points, size_t n_points)
+{
+    storage = {};
+    buffer = points;
+    bufferSize = n_points;
+    head = 0;
+    count = n_points;
+    gapIndex = n_points;
+}
+
+void PointList::MakeOwned()
+{
+    if (IsBorrowed())
+    {
+        grow(count);
+    }
+}
+
+bool PointList::operator==(const PointList & rhs) const
+{
+    return (count == rhs.count) && std::equal(begin(), end(), rhs.begin());
+}
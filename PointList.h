@@ -0,0 +1,125 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <initializer_list>
+
+// point storage of CurveData. a circular gap buffer: the unused space of the buffer is kept as a single gap that is
+// moved to where points are inserted or erased, so edits next to each other (like the 3 points of a cubic anchor)
+// only move the gap once. since the buffer is circular, a gap at the end is also a gap at the front which makes both
+// appending and prepending amortized O(1). moving the gap is O(distance) to the last edit.
+// the buffer is normally owned by the list, but it can also borrow points stored somewhere else (the points of a memory
+// mapped curve file): a borrowed buffer is written in place and copied into an owned one the first time it has to grow
+class PointList
+{
+    public:
+        using value_type = std::array<float, 2>;
+
+        template<typename List, typename Value>
+        class Iterator
+        {
+            private:
+                List * list = nullptr;
+                size_t index = 0;
+
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = PointList::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = Value*;
+                using reference = Value&;
+
+                Iterator() = default;
+                Iterator(List * list, size_t index) : list(list), index(index) {}
+
+                reference operator*() const { return (*list)[index]; }
+                pointer operator->() const { return &(*list)[index]; }
+                reference operator[](difference_type n) const { return (*list)[index + n]; }
+
+                Iterator & operator++() { index++; return *this; }
+                Iterator & operator--() { index--; return *this; }
+                Iterator operator++(int) { Iterator it = *this; index++; return it; }
+                Iterator operator--(int) { Iterator it = *this; index--; return it; }
+                Iterator & operator+=(difference_type n) { index += n; return *this; }
+                Iterator & operator-=(difference_type n) { index -= n; return *this; }
+                Iterator operator+(difference_type n) const { return {list, index + n}; }
+                Iterator operator-(difference_type n) const { return {list, index - n}; }
+                difference_type operator-(const Iterator & rhs) const { return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index); }
+
+                bool operator==(const Iterator & rhs) const { return index == rhs.index; }
+                bool operator!=(const Iterator & rhs) const { return index != rhs.index; }
+                bool operator<(const Iterator & rhs) const { return index < rhs.index; }
+        };
+
+        using iterator = Iterator<PointList, value_type>;
+        using const_iterator = Iterator<const PointList, const value_type>;
+
+    private:
+        std::vector<value_type> storage; // owned buffer (empty while the points are borrowed)
+        value_type * buffer = nullptr; // points and the gap, storage.data() or the borrowed points
+        size_t bufferSize = 0; // capacity of buffer
+        size_t head = 0; // buffer index of the first point when the gap is behind it
+        size_t count = 0; // number of points
+        size_t gapIndex = 0; // index of the point the gap is in front of (count if the gap is at the end)
+
+        size_t gapSize() const { return bufferSize - count; }
+        size_t wrap(size_t buffer_index) const { return (buffer_index >= bufferSize) ? (buffer_index - bufferSize) : buffer_index; }
+        size_t bufferIndex(size_t index) const { return wrap(head + index + ((index >= gapIndex) ? gapSize() : 0)); }
+
+        void moveGap(size_t index); // move the gap in front of the point at index
+        void grow(size_t min_capacity); // reallocate the buffer with at least min_capacity points
+
+    public:
+        PointList() = default;
+        PointList(std::initializer_list<value_type> points);
+        PointList(const PointList & rhs); // a copy always owns its points
+        PointList(PointList && rhs) noexcept;
+        PointList & operator=(const PointList & rhs);
+        PointList & operator=(PointList && rhs) noexcept;
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        size_t capacity() const { return bufferSize; }
+
+        value_type & operator[](size_t index) { return buffer[bufferIndex(index)]; }
+        const value_type & operator[](size_t index) const { return buffer[bufferIndex(index)]; }
+        value_type & front() { return (*this)[0]; }
+        const value_type & front() const { return (*this)[0]; }
+        value_type & back() { return (*this)[count-1]; }
+        const value_type & back() const { return (*this)[count-1]; }
+
+        iterator begin() { return {this, 0}; }
+        iterator end() { return {this, count}; }
+        const_iterator begin() const { return {this, 0}; }
+        const_iterator end() const { return {this, count}; }
+
+        void insert(size_t index, const value_type & point); // insert point in front of the point at index
+        void erase(size_t index, size_t n_points = 1); // erase n_points starting at index
+        void push_back(const value_type & point) { insert(count, point); }
+        void push_front(const value_type & point) { insert(0, point); }
+        void clear();
+        void reserve(size_t n_points);
+
+        // use n_points points at points as the list without copying them. they must stay valid (and writable) until the
+        // list grows, is assigned or is destroyed, or until MakeOwned
+        void Borrow(value_type * points, size_t n_points);
+        bool IsBorrowed() const { return (buffer != nullptr) && storage.empty(); }
+        void MakeOwned(); // copy borrowed points into an owned buffer
+
+        template<typename InputIterator>
+        void assign(InputIterator first, InputIterator last)
+        {
+            clear();
+            reserve(static_cast<size_t>(std::distance(first, last)));
+
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+        }
+
+        bool operator==(const PointList & rhs) const;
+        bool operator!=(const PointList & rhs) const { return !(*this == rhs); }
+};
@@ -0,0 +1,117 @@
+#include "ProfilerOverlay.h"
+
+#include <cstdio>
+#include <algorithm>
+
+void ProfilerOverlay::SetFont(const sf::Font & font)
+{
+    for (sf::Text & line : lines)
+    {
+        line.setFont(font);
+        line.setCharacterSize(textSize);
+        line.setFillColor(sf::Color::White);
+    }
+
+    for (size_t stage=0; stage<FrameProfiler::stageCount; stage++)
+    {
+        lines[stage + 1].setFillColor(stageColors[stage]);
+    }
+
+    hasFont = true;
+}
+
+void ProfilerOverlay::Draw(const FrameProfiler & profiler, sf::RenderWindow & window, float x, float y)
+{
+    // the overlay is in window pixels whatever view the curves are drawn with
+    const sf::View window_view = window.getView();
+    window.setView(window.getDefaultView());
+
+    const float pixels_per_ms = graphHeight / graphScaleMs;
+    const float bottom = y + graphHeight;
+    const size_t n_frames = profiler.FrameCount();
+
+    graphVertices.clear();
+
+    auto add_quad = [&](float left, float top, float right, float quad_bottom, sf::Color color)
+    {
+        graphVertices.emplace_back(sf::Vector2f(left, top), color);
+        graphVertices.emplace_back(sf::Vector2f(right, top), color);
+        graphVertices.emplace_back(sf::Vector2f(right, quad_bottom), color);
+        graphVertices.emplace_back(sf::Vector2f(left, top), color);
+        graphVertices.emplace_back(sf::Vector2f(right, quad_bottom), color);
+        graphVertices.emplace_back(sf::Vector2f(left, quad_bottom), color);
+    };
+
+    add_quad(x, y, x + graphWidth, bottom, backgroundColor);
+
+    // newest frame on the right, every bar stacks the stages from the bottom and the rest of the frame (time outside
+    // of any stage) is left empty
+    const float bar_width = graphWidth / static_cast<float>(FrameProfiler::frameCapacity);
+
+    for (size_t age=0; age<n_frames; age++)
+    {
+        const FrameProfiler::FrameTimes frame = profiler.Frame(age);
+        const float right = x + graphWidth - (static_cast<float>(age) * bar_width);
+        float stage_bottom = bottom;
+
+        for (size_t stage=0; stage<FrameProfiler::stageCount; stage++)
+        {
+            const float stage_top = std::max(y, stage_bottom - (frame.stageMs[stage] * pixels_per_ms));
+            if (stage_top < stage_bottom)
+            {
+                add_quad(right - bar_width, stage_top, right, stage_bottom, stageColors[stage]);
+            }
+
+            stage_bottom = stage_top;
+        }
+    }
+
+    const float budget_y = std::max(y, bottom - (budgetMs * pixels_per_ms));
+    add_quad(x, budget_y, x + graphWidth, budget_y + 1.0f, budgetColor);
+
+    window.draw(graphVertices.data(), graphVertices.size(), sf::PrimitiveType::Triangles);
+
+    if (hasFont)
+    {
+        const FrameProfiler::FrameTimes average = profiler.Average();
+        char line_str[96];
+
+        std::snprintf(line_str, sizeof(line_str), "frame %.2f ms (avg of %zu)", average.frameMs, n_frames);
+        lines[0].setString(line_str);
+
+        for (size_t stage=0; stage<FrameProfiler::stageCount; stage++)
+        {
+            std::snprintf(line_str, sizeof(line_str), "%s %.3f ms", FrameProfiler::StageName(static_cast<PROFILE_STAGE>(stage)), average.stageMs[stage]);
+            lines[stage + 1].setString(line_str);
+        }
+
+        // allocations per frame and the category most of them come from
+        size_t n_lines = FrameProfiler::stageCount + 1;
+        if (allocation_counter::IsCompiledIn())
+        {
+            size_t top_category = 0;
+            for (size_t category=1; category<allocation_counter::categoryCount; category++)
+            {
+                if (average.categoryAllocations[category] > average.categoryAllocations[top_category])
+                {
+                    top_category = category;
+                }
+            }
+
+            std::snprintf(line_str, sizeof(line_str), "allocations %llu (%llu bytes), top %s", static_cast<unsigned long long>(average.allocations),
+                          static_cast<unsigned long long>(average.allocatedBytes), allocation_counter::CategoryName(static_cast<ALLOCATION_CATEGORY>(top_category)));
+            lines[n_lines++].setString(line_str);
+        }
+
+        float line_y = bottom + 2.0f;
+        for (size_t i=0; i<n_lines; i++)
+        {
+            sf::Text & line = lines[i];
+            line.setPosition(x, line_y);
+            window.draw(line);
+            line_y += static_cast<float>(textSize) + 2.0f;
+        }
+    }
+
+    window.setView(window_view);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "FrameProfiler.h"
+
+#include <array>
+#include <vector>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/RenderWindow.hpp>
+
+// draws the frames of a FrameProfiler: a graph of the frame times (one bar per frame, split into its stages) and the
+// average time of every stage as text
+class ProfilerOverlay
+{
+    private:
+        std::array<sf::Color, FrameProfiler::stageCount> stageColors = {sf::Color(239, 156, 30, 255), sf::Color(59, 165, 92, 255), sf::Color(30, 156, 239, 255), sf::Color(175, 95, 215, 255), sf::Color(215, 95, 115, 255)};
+        sf::Color backgroundColor = sf::Color(0, 0, 0, 170);
+        sf::Color budgetColor = sf::Color(255, 255, 255, 120);
+
+        std::vector<sf::Vertex> graphVertices; // background quad, bars and the budget line (reused every frame)
+        std::array<sf::Text, FrameProfiler::stageCount + 2> lines; // frame time, the stages and the allocations (only drawn when allocation counting is compiled in)
+        bool hasFont = false;
+
+        float graphWidth = 240.0f; // one pixel per frame in the ring buffer
+        float graphHeight = 100.0f;
+        float graphScaleMs = 33.3f; // frame time at the top of the graph
+        float budgetMs = 1000.0f / 60.0f; // frame time of the frame rate limit, drawn as a line
+        uint32_t textSize = 14;
+
+    public:
+        ProfilerOverlay() = default;
+
+        void SetFont(const sf::Font & font);
+        void Draw(const FrameProfiler & profiler, sf::RenderWindow & window, float x, float y); // draw with the top left corner at x, y (in window pixels)
+};
@@ -1,28 +1,16 @@
 #include "QuadraticCurve.h"
+#include "CurveKernel.h"
+#include "CurveLayout.h"
+#include "CurveSegments.h"
+#include "CurveArcLength.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
 
 #include <iostream>
 
-std::array<float, 2> QuadraticCurve::interpolate(const std::array<float, 2>  & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const float & parametric_t)
-{
-    // lerp p0(a), p1(b) which will result in q0
-    float x0 = std::lerp(a[0], b[0], parametric_t);
-    float y0 = std::lerp(a[1], b[1], parametric_t);
-
-    // lerp p1(b), p2(c) which will result in q1
-    float x1 = std::lerp(b[0], c[0], parametric_t);
-    float y1 = std::lerp(b[1], c[1], parametric_t);
-
-    // lerp the results of pq0(q0) and pq1(q1) which results in pq
-    float xpq = std::lerp(x0, x1, parametric_t);
-    float ypq = std::lerp(y0, y1, parametric_t);
-
-    // point result on cubic curve
-    return {xpq, ypq};
-}
-
 int32_t QuadraticCurve::GetClosestAnchorPoint(const int32_t & index)
 {
     // check if selected point is an anchor point.
@@ -96,173 +84,15 @@ bool QuadraticCurve::IsAnchorPoint(int32_t index)
     return (sel_idx == 0);
 }
 
-void QuadraticCurve::interpolateWithCubicHint()
-{
-    constexpr size_t min_points = 4;
-    curveList.clear();
-    handleList.clear();
-
-    if (curveData && curveData->pointList.size() >= min_points)
-    {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
-
-        size_t n_segments = (curveData->pointList.size() / 3) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        for (size_t i=0; i<n_segments; i++)
-        {
-            uint32_t point_a = (i * 3) + 1;
-            uint32_t point_b = (i * 3) + 2;
-            uint32_t point_c = (i * 3) + 3;
-            uint32_t point_d = (i * 3) + 4;
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_d], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
-
-            if (curveData->areHandlesGenerated)
-            {
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-
-                handleList.emplace_back(curveData->pointList[point_d]);
-                handleList.emplace_back(curveData->pointList[point_d+1]);
-            }
-
-        }
-
-        constexpr size_t min_points_for_closed_curve = 5;
-        if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
-        {
-            std::array<float, 2> new_point {};
-
-            if (!curveData->pointList.empty())
-            {
-                uint32_t point_a = curveData->pointList.size()-2;
-                uint32_t point_b = curveData->pointList.size()-1;
-                uint32_t point_c = 1;
-
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
-            }
-        }
-    }
-    else if ((curveData && curveData->pointList.size() >= (min_points-1)) && curveData->areHandlesGenerated)
-    {
-        // draw handles if there are at least 3 points
-        uint32_t point_a = 1;
-        uint32_t point_b = 2;
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_b]);
-    }
-    else
-    {
-        std::cerr << "no curve data available or not enough data points!\n";
-    }
-}
-
-void QuadraticCurve::interpolateWithQuadraticHint()
+void QuadraticCurve::markPointsDirty(int32_t first_point, int32_t last_point)
 {
-    constexpr size_t min_points = 4;
-    curveList.clear();
-    handleList.clear();
-
-    if (curveData && curveData->pointList.size() >= min_points)
-    {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
+    // segment i is made of the points (i*2) to (i*2)+2 and its handles also use the point (i*2)+3
+    const int32_t n_segments = static_cast<int32_t>(segmentCount());
+    int32_t first_segment = std::min((std::max(first_point - 3, 0) + 1) / 2, n_segments);
+    int32_t last_segment = std::min(last_point / 2, n_segments - 1);
+    size_t n_dirty = (last_segment >= first_segment) ? (last_segment - first_segment + 1) : 0;
 
-        size_t n_segments = (curveData->pointList.size() / 2) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
-
-        for (size_t i=0; i<n_segments; i++)
-        {
-            uint32_t point_a = (i * 2) + 0;
-            uint32_t point_b = (i * 2) + 1;
-            uint32_t point_c = (i * 2) + 2;
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
-
-            if (curveData->areHandlesGenerated)
-            {
-                handleList.emplace_back(curveData->pointList[point_a]);
-                handleList.emplace_back(curveData->pointList[point_b]);
-
-                handleList.emplace_back(curveData->pointList[point_c]);
-                handleList.emplace_back(curveData->pointList[point_c+1]);
-            }
-
-        }
-
-        constexpr size_t min_points_for_closed_curve = 4;
-        if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
-        {
-            std::array<float, 2> new_point {};
-
-            if (!curveData->pointList.empty())
-            {
-                uint32_t point_a = curveData->pointList.size()-2;
-                uint32_t point_b = curveData->pointList.size()-1;
-                uint32_t point_c = 0;
-
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
-            }
-        }
-    }
-    else if ((curveData && curveData->pointList.size() >= (min_points-2)) && curveData->areHandlesGenerated)
-    {
-        // draw handles if there are at least 3 points
-        uint32_t point_a = 0;
-        uint32_t point_b = 1;
-
-        handleList.push_back(curveData->pointList[point_a]);
-        handleList.push_back(curveData->pointList[point_b]);
-    }
-    else
-    {
-        std::cerr << "no curve data available or not enough data points!\n";
-    }
+    markSegmentsDirty(first_segment, n_dirty, n_dirty);
 }
 
 void QuadraticCurve::interpolateWithLinearHint()
@@ -273,17 +103,15 @@ void QuadraticCurve::interpolateWithLinearHint()
 
     if (curveData && curveData->pointList.size() >= min_points)
     {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
-
-        float t = t_constrain_beg; // 0 <= t <= 1.0
-
-        float step_size = 1.0f / curveData->smoothFactor; // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
+        const uint32_t n_steps = curve_kernel::StepCount(curveData->smoothFactor); // the larger smoothFactor is the smoother the line
+        const size_t n_samples = n_steps + 1; // number of points generated per segment
 
         size_t n_segments = curveData->pointList.size()- 1;
         n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
 
+        curveList.reserve((n_segments + 1) * n_samples); // + 1 for the segment closing the loop
+        handleList.reserve(n_segments * 8);
+
         if (!curveUpscaleData)
         {
             curveUpscaleData = std::make_unique<CurveData>(CURVE_TYPE::QUADRATIC);
@@ -368,17 +196,7 @@ void QuadraticCurve::interpolateWithLinearHint()
 
             }
 
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], control_point_b, curveData->pointList[point_c], t);
-                curveList.push_back(new_point);
-                t += step_size;
-            }
-
-            t = t_constrain_beg;
+            appendSegment({{curveData->pointList[point_a], control_point_b, curveData->pointList[point_c]}}, n_steps);
 
             if (curveData->areHandlesGenerated)
             {
@@ -410,8 +228,6 @@ void QuadraticCurve::interpolateWithLinearHint()
         constexpr size_t min_points_for_closed_curve = 4;
         if (curveData->isCloseLoop && (curveData->pointList.size() > min_points_for_closed_curve))
         {
-            std::array<float, 2> new_point {};
-
             if (!curveData->pointList.empty())
             {
                 uint32_t point_a = curveData->pointList.size()-2;
@@ -420,13 +236,7 @@ void QuadraticCurve::interpolateWithLinearHint()
 
                 std::array<float, 2> control_point_b {(curveData->pointList[point_b][0] - curveData->pointList[point_a][0]), (curveData->pointList[point_b][1] - curveData->pointList[point_a][1])};
 
-                while (t <= (t_constrain_end + epsilon))
-                {
-                    t = std::min(t, t_constrain_end);
-                    new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], t);
-                    curveList.push_back(new_point);
-                    t += step_size;
-                }
+                appendSegment({{curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c]}}, n_steps);
             }
         }
     }
@@ -448,67 +258,20 @@ void QuadraticCurve::interpolateWithLinearHint()
     }
 }
 
-void QuadraticCurve::AddPoint(std::array<float, 2> point)
-{
-    if (curveData)
-    {
-        curveData->pointList.push_back(point);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void QuadraticCurve::InsertPoint(std::array<float, 2> point, int32_t index)
-{
-    if (curveData)
-    {
-        curveData->pointList.insert(curveData->pointList.begin() + index, point);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void QuadraticCurve::DeletePoint(int32_t index)
-{
-    if (curveData)
-    {
-        curveData->pointList.erase(curveData->pointList.begin() + index);
-    }
-    else
-    {
-        std::cerr << "no curve data available!\n";
-    }
-}
-
-void QuadraticCurve::InterpolatePoints()
-{
-    if (curveData->curveType == CURVE_TYPE::CUBIC)
-    {
-        interpolateWithCubicHint();
-    }
-    else if (curveData->curveType == CURVE_TYPE::QUADRATIC)
-    {
-        interpolateWithQuadraticHint();
-    }
-    else // CURVE_TYPE::LINEAR
-    {
-        interpolateWithLinearHint();
-    }
-}
-
 QuadraticCurve::QuadraticCurve(CurveData *curve_data)
 {
-    curveData = curve_data;
+    setCurveData(curve_data);
 }
 
 void QuadraticCurve::UpdatePoint(int32_t index, std::array<float, 2> position, CURVE_CONTROL curve_control)
 {
+    CURVE_TRACE_SCOPE("QuadraticCurve::UpdatePoint");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData && !curveData->pointList.empty())
     {
+        markPointsDirty(index, (index+1)); // the point and the control point of an anchor can change
+
         // if the point selected to be updated is an anchor point then update the control points to move along
         // with the updated anchor point position
         if (curveData->curveType == CURVE_TYPE::QUADRATIC)
@@ -570,8 +333,7 @@ void QuadraticCurve::UpdatePoint(int32_t index, std::array<float, 2> position, C
             }
         }
 
-
-        InterpolatePoints(); // update curve data
+        curveData->pointGrid.Update(curveData->pointList, (index-1), (index+1));
     }
     else
     {
@@ -581,6 +343,9 @@ void QuadraticCurve::UpdatePoint(int32_t index, std::array<float, 2> position, C
 
 void QuadraticCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor)
 {
+    CURVE_TRACE_SCOPE("QuadraticCurve::AddAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData->pointList.empty() || (curveData->pointList.size() < 4))
     {
         if (curveData->pointList.empty())
@@ -603,11 +368,15 @@ void QuadraticCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_an
             std::array<float, 2> new_control_point1 = {point[0] + initialControlDistance, point[1]}; // put control point to the left of the anchor point
             AddPoint(new_control_point1); // control point
         }
+
+        markInterpolationDirty();
     }
     else
     {
         if (place_anchor == PLACE_ANCHOR::END) // add new points to end of the curve
         {
+            markSegmentsDirty(segmentCount(), 0, 1); // new segment after the last one
+
             // find the differences of the last anchor points, and it's control points, so it can be added to the new created segment points
             // get last control and anchor points
             std::array<float, 2> last_anchor_point = curveData->pointList[curveData->pointList.size()-2];
@@ -632,6 +401,8 @@ void QuadraticCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_an
         }
         else // add new points to beginning of the curve PLACE_ANCHOR::BEG
         {
+            markSegmentsDirty(0, 0, 1); // new segment before the first one
+
             // find the differences of the last anchor points, and it's control points, so it can be added to the new created segment points
             // get last control and anchor points
             const int32_t index = 0;
@@ -658,12 +429,13 @@ void QuadraticCurve::AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_an
             //InsertPoint(new_control_point_0, index); // control point
         }
     }
-
-    InterpolatePoints();
 }
 
 void QuadraticCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
 {
+    CURVE_TRACE_SCOPE("QuadraticCurve::InsertAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData && (index > 1))
     {
         // find the differences of the last anchor points, and it's control points, so it can be added to the new created segment points
@@ -690,7 +462,7 @@ void QuadraticCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
         std::array<float, 2> new_control_point_0 = {(point[0] + last_anchor_offset0[0]), (point[1] + last_anchor_offset0[1])};
         InsertPoint(new_control_point_0, (index+1)); // control point
 
-        InterpolatePoints();
+        markInterpolationDirty();
     }
     else
     {
@@ -700,18 +472,29 @@ void QuadraticCurve::InsertAnchor(std::array<float, 2> point, int32_t index)
 
 void QuadraticCurve::RemoveAnchor(int32_t index)
 {
+    CURVE_TRACE_SCOPE("QuadraticCurve::RemoveAnchor");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
     if (curveData && (curveData->pointList.empty() || (curveData->pointList.size() >= 3)))
     {
         index = GetClosestAnchorPoint(index);
 
         // remove 3 points --> the 2 control points and anchor point
         int32_t remove_index = (index-1);
+
+        // with 2 points per segment every point after the removed ones switches between anchor and control point, so
+        // every segment from the one whose handles reach the removed control point to the end is re-tessellated. the
+        // segments before it are kept
+        const size_t n_points_new = (curveData->pointList.size() >= 3) ? (curveData->pointList.size() - 3) : 0;
+        const size_t n_segments_prev = segmentCount();
+        const size_t n_segments_new = (n_points_new >= 4) ? ((n_points_new / 2) - 1) : 0;
+        const size_t first_segment = std::min(static_cast<size_t>((std::max(remove_index - 3, 0) + 1) / 2), n_segments_new);
+        markSegmentsDirty(first_segment, (n_segments_prev - first_segment), (n_segments_new - first_segment));
+
         for (size_t i=0; i<3; i++)
         {
             DeletePoint(remove_index);
         }
-
-        InterpolatePoints();
     }
     else
     {
@@ -719,87 +502,114 @@ void QuadraticCurve::RemoveAnchor(int32_t index)
     }
 }
 
-void QuadraticCurve::CloseLoop(bool close_loop)
+void QuadraticCurve::BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles)
 {
-    if(curveData)
+    CURVE_TRACE_SCOPE("QuadraticCurve::BuildFromAnchors");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (curveData && (handles.empty() || (handles.size() == anchors.size())))
+    {
+        // build the whole point list in one pass and tessellate once instead of adding each anchor separately
+        curveData->pointList.clear();
+        curveData->pointGrid.Clear(); // rebuilt on the next query
+        curveData->pointList.reserve(anchors.size() * 2);
+
+        for (size_t i=0; i<anchors.size(); i++)
+        {
+            const std::array<float, 2> & point = anchors[i];
+
+            curveData->pointList.push_back(point); // anchor point
+
+            if (handles.empty())
+            {
+                // same control point AddAnchor generates, every anchor copies the offset of the first one
+                curveData->pointList.push_back({point[0] + initialControlDistance, point[1]}); // control point
+            }
+            else
+            {
+                curveData->pointList.push_back(handles[i]); // control point
+            }
+        }
+
+        markInterpolationDirty();
+    }
+    else
     {
-        curveData->isCloseLoop = close_loop;
-        InterpolatePoints();
+        std::cerr << "no curve data available or the handle count does not match the anchors (1 handle per anchor)!\n";
     }
 }
 
-std::pair<std::array<float, 2>, uint32_t> QuadraticCurve::IntersectionOnCurve(std::array<float, 2> position)
+CurveIntersection QuadraticCurve::NearestPointOnCurve(std::array<float, 2> position)
 {
-    std::array<float,2> position_on_curve = {std::numeric_limits<float>::min(), std::numeric_limits<float>::min()};
-    uint32_t index_insert_index = -1;
+    CURVE_TRACE_SCOPE("QuadraticCurve::NearestPointOnCurve");
+    CURVE_ALLOCATION_SCOPE(QUERY);
 
-    if (curveData && (curveData->pointList.size() > 5))
+    CurveIntersection nearest;
+
+    if (!curveData)
     {
-        constexpr float t_constrain_beg = 0.0f;
-        constexpr float t_constrain_end = 1.0f;
+        return nearest;
+    }
 
-        float t = t_constrain_beg; // 0 <= t <= 1.0
+    updateInterpolation();
 
-        float step_size = 1.0f / (curveData->smoothFactor * 2.0f); // the larger s is the smoother the line
-        constexpr float epsilon = 0.0001f; // for step size values that may not exactly reach 1.0f
+    if (!segmentTree.IsBuilt(segmentBounds))
+    {
+        segmentTree.Build(segmentBounds);
+    }
 
-        size_t n_segments = (curveData->pointList.size() / 2) - 1;
-        n_segments = std::clamp(n_segments, size_t(0), std::numeric_limits<size_t>::max());
+    const PointList & points = curveData->pointList;
+    const bool is_point_list_segment = (curveData->curveType == CURVE_TYPE::QUADRATIC);
+    float nearest_distance = std::numeric_limits<float>::max();
 
-        bool found_intersection = false;
+    // the segments of the quadratic curve type are read from the point list. the other hints generate segments that aren't
+    // in it, those are projected onto their cubic form in segmentControls
+    segmentTree.Nearest(position, [&](size_t segment)
+    {
+        float t = 0.0f;
+        std::array<float, 2> point_on_segment = {};
 
-        for (size_t i=0; i<n_segments; i++)
+        if (is_point_list_segment)
         {
-            uint32_t point_a = (i * 2) + 1; // anchor point
-            uint32_t point_b = (i * 2) + 2; // control point
-            uint32_t point_c = (i * 2) + 3; // anchor point
-
-            std::array<float, 2> new_point {};
-
-            while (t <= (t_constrain_end + epsilon))
-            {
-                t = std::min(t, t_constrain_end);
-                new_point = interpolate(curveData->pointList[point_a], curveData->pointList[point_b], curveData->pointList[point_c], t);
+            const curve_layout::Segment<CURVE_TYPE::QUADRATIC> p = curve_layout::SegmentAt<CURVE_TYPE::QUADRATIC, CURVE_TYPE::QUADRATIC>(points, segment);
+            t = curve_kernel::ClosestQuadratic(p.points[0], p.points[1], p.points[2], position);
+            point_on_segment = p.Evaluate(t);
+        }
+        else
+        {
+            const SegmentControls & p = segmentControls[segment];
+            t = curve_kernel::ClosestCubic(p[0], p[1], p[2], p[3], position);
+            point_on_segment = curve_layout::Segment<CURVE_TYPE::CUBIC>{p}.Evaluate(t);
+        }
 
-                // check point
-                std::array<float, 2> check_distance = {std::abs(new_point[0] - position[0]), std::abs(new_point[1] - position[1])};
-                float dst = std::sqrt((check_distance[0]*check_distance[0]) + (check_distance[1]*check_distance[1]));
+        float dx = point_on_segment[0] - position[0];
+        float dy = point_on_segment[1] - position[1];
+        float distance = (dx * dx) + (dy * dy);
 
-                constexpr float default_radius = 10.0f;
-                if (dst <= default_radius)
-                {
-                    position_on_curve = new_point;
-                    found_intersection = true;
-                    index_insert_index = point_b;
-                    break;
-                }
+        if (distance < nearest_distance)
+        {
+            nearest_distance = distance;
+            nearest.found = true;
+            nearest.position = point_on_segment;
+            nearest.t = t;
+            nearest.segment = segment;
+        }
 
-                t += step_size;
-            }
+        return distance;
+    });
 
-            if (found_intersection)
-            {
-                break;
-            }
+    if (nearest.found)
+    {
+        nearest.distance = std::sqrt(nearest_distance);
 
-            t = t_constrain_beg;
-        }
+        // anchors can't be inserted into the closing segment
+        nearest.insertIndex = curve_layout::InsertIndex(curveData->curveType, points, nearest.segment);
     }
 
-    return {position_on_curve, index_insert_index};
-}
-
-std::vector<std::array<float, 2>> QuadraticCurve::Data()
-{
-    return curveList;
-}
-
-const std::vector<std::array<float, 2>> & QuadraticCurve::HandleData()
-{
-    return handleList;
+    return nearest;
 }
 
-const std::vector<std::array<float, 2>> & QuadraticCurve::GetPointData()
+const PointList & QuadraticCurve::GetPointData()
 {
     if (curveUpscaleData)
     {
@@ -810,28 +620,6 @@ const std::vector<std::array<float, 2>> & QuadraticCurve::GetPointData()
     return curveData->pointList;
 }
 
-void QuadraticCurve::ForceInterpolation()
-{
-    InterpolatePoints();
-}
-
-CURVE_TYPE QuadraticCurve::CurveType()
-{
-    CURVE_TYPE curve_type = CURVE_TYPE::UNKNOWN;
-
-    if (curveData)
-    {
-        curve_type = curveData->curveType;
-    }
-
-    return curve_type;
-}
-
-CURVE_TYPE QuadraticCurve::WorkCurveType()
-{
-    return CURVE_TYPE::QUADRATIC;
-}
-
 std::unique_ptr<CurveData> QuadraticCurve::NewCurveData()
 {
     auto curve_data = std::make_unique<CurveData>(CURVE_TYPE::QUADRATIC);
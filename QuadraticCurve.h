@@ -1,35 +1,22 @@
 #pragma once
 
-#include "Curve.h"
+#include "LayoutCurve.h"
 #include <vector>
 #include <array>
 #include <memory>
 
-class QuadraticCurve : public ICurve
+class QuadraticCurve final : public LayoutCurve<CURVE_TYPE::QUADRATIC>
 {
     private:
-        static std::array<float, 2> interpolate(const std::array<float, 2>  & a, const std::array<float, 2> & b, const std::array<float, 2> & c, const float & parametric_t);
-
-        CurveData * curveData = nullptr; // curve data block used by this class to generate the curve data
         std::unique_ptr<CurveData> curveUpscaleData = nullptr; // curve data block used by this class to generate the curve data
 
-        std::vector<std::array<float, 2>> curveList; // data that holds the generated curve from CurveData
-        std::vector<std::array<float, 2>> handleList; // data that holds the generated curve handles from CurveData
-
         static constexpr float initialControlDistance = 50.0f; // initial distance from the 1st anchor point created
 
         int32_t GetClosestAnchorPoint(const int32_t & index);
         bool IsAnchorPoint(int32_t index);
 
-        void interpolateWithCubicHint(); // generate a cubic curve
-        void interpolateWithQuadraticHint(); // generate cubic curve from quadratic
-        void interpolateWithLinearHint(); // generate cubic cubic curve from linear
-
-    protected:
-        void AddPoint(std::array<float, 2> point) override; // // add points
-        void InsertPoint(std::array<float, 2> point, int32_t index) override; // insert points
-        void DeletePoint(int32_t index) override; // delete points
-        void InterpolatePoints() override; // generate curve from CurveData point list
+        void markPointsDirty(int32_t first_point, int32_t last_point); // record an edit of the given range of points before it is made
+        void interpolateWithLinearHint() override; // generate cubic cubic curve from linear
 
     public:
         QuadraticCurve() = default;
@@ -39,26 +26,19 @@ class QuadraticCurve : public ICurve
         void AddAnchor(std::array<float, 2> point, PLACE_ANCHOR place_anchor) override; // add new point with control points of previous anchor (if exist)
         void InsertAnchor(std::array<float, 2> point, int32_t index) override;
         void RemoveAnchor(int32_t index) override; // remove anchor and control points from curve
-        void CloseLoop(bool close_loop) override; // close the curve - create a line from the last point to the first
-        std::pair<std::array<float, 2>, uint32_t> IntersectionOnCurve(std::array<float, 2> position) override; // get intersecting position of point on the curve and also the insertion index to insert a new point
-
-        std::vector<std::array<float, 2>> Data() override; // return generated curve data points
-        const std::vector<std::array<float, 2>> & HandleData() override; // return generated curve handle data points
-        const std::vector<std::array<float, 2>> & GetPointData() override;
-
-        void ForceInterpolation() override;
-        CURVE_TYPE CurveType() override;
-        CURVE_TYPE WorkCurveType() override;
+        void BuildFromAnchors(std::span<const std::array<float, 2>> anchors, std::span<const std::array<float, 2>> handles = {}) override; // replace the curve with the anchors. handles holds the control point following each anchor, generated like AddAnchor if empty
+        CurveIntersection NearestPointOnCurve(std::array<float, 2> position) override; // exact nearest point on the generated curve (for every curve type)
+        const PointList & GetPointData() override;
 
         QuadraticCurve & operator= (const std::unique_ptr<CurveData> & rhs)
         {
-            this->curveData = rhs.get();
+            this->setCurveData(rhs.get());
             return *this;
         }
 
         QuadraticCurve & operator= (std::unique_ptr<CurveData>&& rhs)
         {
-            this->curveData = rhs.get();
+            this->setCurveData(rhs.get());
             return *this;
         }
 
@@ -0,0 +1,403 @@
+#include "SegmentedCurve.h"
+#include "CurveSegments.h"
+#include "CurveArcLength.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <limits>
+
+#include <iostream>
+#include <atomic>
+
+void SegmentedCurve::markSegmentsDirty(size_t first_segment, size_t old_count, size_t new_count)
+{
+    // called before the point list is edited, so the pending range and this edit use the same segment numbering
+
+    // edits made through another curve class aren't known here, the whole curve is re-tessellated after those
+    if ((trackedGeneration != curveData->generation) || ((first_segment + old_count) > segmentCount()))
+    {
+        isInterpolationPending = true;
+    }
+
+    if (isInterpolationPending)
+    {
+        areSegmentsDirty = false;
+    }
+    else if (areSegmentsDirty && (first_segment <= (dirtySegmentFirst + dirtySegmentNewCount)) && ((first_segment + old_count) >= dirtySegmentFirst))
+    {
+        // merge with the overlapping (or adjacent) pending range
+        const size_t first = std::min(dirtySegmentFirst, first_segment);
+        const size_t last = std::max((dirtySegmentFirst + dirtySegmentNewCount), (first_segment + old_count));
+
+        dirtySegmentOldCount = (last - first) + dirtySegmentOldCount - dirtySegmentNewCount;
+        dirtySegmentNewCount = (last - first) + new_count - old_count;
+        dirtySegmentFirst = first;
+    }
+    else
+    {
+        // a pending range apart from this edit is re-tessellated now instead of merging it with everything in between
+        if (areSegmentsDirty)
+        {
+            retessellateSegments(dirtySegmentFirst, dirtySegmentOldCount, dirtySegmentNewCount);
+        }
+
+        dirtySegmentFirst = first_segment;
+        dirtySegmentOldCount = old_count;
+        dirtySegmentNewCount = new_count;
+        areSegmentsDirty = true;
+    }
+
+    trackedGeneration = ++curveData->generation;
+}
+
+void SegmentedCurve::markInterpolationDirty()
+{
+    isInterpolationPending = true;
+    trackedGeneration = ++curveData->generation;
+}
+
+void SegmentedCurve::updateInterpolation()
+{
+    if (!curveData)
+    {
+        return;
+    }
+
+    if (isInterpolationPending || (trackedGeneration != curveData->generation))
+    {
+        InterpolatePoints();
+    }
+    else if (areSegmentsDirty)
+    {
+        retessellateSegments(dirtySegmentFirst, dirtySegmentOldCount, dirtySegmentNewCount);
+    }
+
+    isInterpolationPending = false;
+    areSegmentsDirty = false;
+    trackedGeneration = curveData->generation;
+}
+
+void SegmentedCurve::updateStorageArrays()
+{
+    if (!areStorageArraysValid)
+    {
+        CURVE_TRACE_SCOPE("SegmentedCurve::updateStorageArrays");
+        CURVE_ALLOCATION_SCOPE(INTERPOLATION);
+
+        sampleArrays.Assign(curveList);
+        segmentBlocks.Assign(segmentControls);
+        areStorageArraysValid = true;
+    }
+}
+
+void SegmentedCurve::AddPoint(std::array<float, 2> point)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::AddPoint");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (curveData)
+    {
+        curveData->pointList.push_back(point);
+        curveData->pointGrid.Insert((curveData->pointList.size() - 1), point);
+    }
+    else
+    {
+        std::cerr << "no curve data available!\n";
+    }
+}
+
+void SegmentedCurve::InsertPoint(std::array<float, 2> point, int32_t index)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::InsertPoint");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (curveData)
+    {
+        curveData->pointList.insert(index, point);
+        curveData->pointGrid.Insert(index, point);
+    }
+    else
+    {
+        std::cerr << "no curve data available!\n";
+    }
+}
+
+void SegmentedCurve::DeletePoint(int32_t index)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::DeletePoint");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if (curveData)
+    {
+        curveData->pointList.erase(index);
+        curveData->pointGrid.Erase(index);
+    }
+    else
+    {
+        std::cerr << "no curve data available!\n";
+    }
+}
+
+void SegmentedCurve::CloseLoop(bool close_loop)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::CloseLoop");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    if(curveData)
+    {
+        curveData->isCloseLoop = close_loop;
+        markSegmentsDirty(segmentCount(), 0, 0); // only the closing segment changes
+    }
+}
+
+std::pair<std::array<float, 2>, uint32_t> SegmentedCurve::IntersectionOnCurve(std::array<float, 2> position)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::IntersectionOnCurve");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    std::array<float,2> position_on_curve = {std::numeric_limits<float>::min(), std::numeric_limits<float>::min()};
+    uint32_t index_insert_index = noInsertIndex;
+
+    CurveIntersection nearest = NearestPointOnCurve(position);
+
+    constexpr float default_radius = 10.0f;
+    if (nearest.found && (nearest.distance <= default_radius))
+    {
+        position_on_curve = nearest.position;
+        index_insert_index = nearest.insertIndex;
+    }
+
+    return {position_on_curve, index_insert_index};
+}
+
+float SegmentedCurve::Length()
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::Length");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (!curveData)
+    {
+        return 0.0f;
+    }
+
+    updateInterpolation();
+    return static_cast<float>(arcLengthTable.Length(segmentControls));
+}
+
+CurveLocation SegmentedCurve::TAtDistance(float distance)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::TAtDistance");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (!curveData)
+    {
+        return {};
+    }
+
+    updateInterpolation();
+    return arcLengthTable.Locate(segmentControls, distance);
+}
+
+void SegmentedCurve::SampleAtDistances(std::span<const float> distances, const PathSamples & out)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::SampleAtDistances");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (curveData)
+    {
+        updateInterpolation();
+    }
+
+    arcLengthTable.SampleAtDistances(segmentControls, distances, out);
+}
+
+void SegmentedCurve::SampleAtParameters(std::span<const float> parameters, const PathSamples & out)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::SampleAtParameters");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (curveData)
+    {
+        updateInterpolation();
+    }
+
+    curve_arc_length::SampleAtParameters(segmentControls, parameters, out);
+}
+
+const std::vector<std::array<float, 2>> & SegmentedCurve::Data()
+{
+    updateInterpolation();
+    return curveList;
+}
+
+const PointArrays & SegmentedCurve::DataArrays()
+{
+    updateInterpolation();
+    updateStorageArrays();
+    return sampleArrays;
+}
+
+const SegmentBlocks & SegmentedCurve::SegmentControlBlocks()
+{
+    updateInterpolation();
+    updateStorageArrays();
+    return segmentBlocks;
+}
+
+const std::vector<std::array<float, 2>> & SegmentedCurve::HandleData()
+{
+    updateInterpolation();
+    return handleList;
+}
+
+bool SegmentedCurve::EditsSince(uint64_t generation, std::vector<SampleEdit> & edits)
+{
+    updateInterpolation();
+    return editLog.Since(generation, edits);
+}
+
+void SegmentedCurve::CopyData(size_t first_sample, size_t n_samples, float * out, size_t stride)
+{
+    updateInterpolation();
+    curve_segments::CopyStrided(curveList, first_sample, n_samples, out, stride);
+}
+
+void SegmentedCurve::CopyHandleData(size_t first_handle, size_t n_handles, float * out, size_t stride)
+{
+    curve_segments::CopyStrided(HandleData(), first_handle, n_handles, out, stride);
+}
+
+const PointList & SegmentedCurve::GetPointData()
+{
+    return curveData->pointList;
+}
+
+void SegmentedCurve::PointsInRadius(std::array<float, 2> position, float radius, std::vector<uint32_t> & out)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::PointsInRadius");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    out.clear();
+
+    if (curveData)
+    {
+        if (!curveData->pointGrid.IsBuiltFor(curveData->pointList))
+        {
+            curveData->pointGrid.Build(curveData->pointList);
+        }
+
+        curveData->pointGrid.PointsInRadius(curveData->pointList, position, radius, out);
+    }
+}
+
+int32_t SegmentedCurve::NearestPoint(std::array<float, 2> position, float max_distance)
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::NearestPoint");
+    CURVE_ALLOCATION_SCOPE(QUERY);
+
+    if (!curveData)
+    {
+        return -1;
+    }
+
+    if (!curveData->pointGrid.IsBuiltFor(curveData->pointList))
+    {
+        curveData->pointGrid.Build(curveData->pointList);
+    }
+
+    return curveData->pointGrid.NearestPoint(curveData->pointList, position, max_distance);
+}
+
+void SegmentedCurve::ForceInterpolation()
+{
+    CURVE_TRACE_SCOPE("SegmentedCurve::ForceInterpolation");
+    CURVE_ALLOCATION_SCOPE(CURVE_EDIT);
+
+    markInterpolationDirty();
+}
+
+TessellationStats SegmentedCurve::GetTessellationStats()
+{
+    updateInterpolation();
+    return tessellationStats;
+}
+
+const std::vector<CurveBounds> & SegmentedCurve::SegmentBounds()
+{
+    updateInterpolation();
+    return segmentBounds;
+}
+
+const std::vector<size_t> & SegmentedCurve::SegmentOffsets()
+{
+    updateInterpolation();
+    return segmentOffsets;
+}
+
+const CurveBvh & SegmentedCurve::SegmentTree()
+{
+    updateInterpolation();
+
+    if (!segmentTree.IsBuilt(segmentBounds))
+    {
+        segmentTree.Build(segmentBounds);
+    }
+
+    return segmentTree;
+}
+
+CurveBounds SegmentedCurve::Bounds()
+{
+    updateInterpolation();
+
+    if (!isCurveBoundsValid)
+    {
+        curveBounds = {};
+        for (const CurveBounds & segment_bounds : segmentBounds)
+        {
+            curveBounds.Expand(segment_bounds);
+        }
+
+        isCurveBoundsValid = true;
+    }
+
+    return curveBounds;
+}
+
+uint64_t SegmentedCurve::Generation()
+{
+    return curveData ? curveData->generation : 0;
+}
+
+bool SegmentedCurve::HasChangedSince(uint64_t generation)
+{
+    return (Generation() != generation);
+}
+
+uint64_t SegmentedCurve::DataEpoch()
+{
+    return dataEpoch;
+}
+
+void SegmentedCurve::setCurveData(CurveData * curve_data)
+{
+    // the generation of the new block can be equal to or lower than the one of the old block, the epoch tells
+    // anything caching the generated data (DrawCurve) that it has to be rebuilt
+    static std::atomic<uint64_t> next_data_epoch = 1;
+
+    curveData = curve_data;
+    dataEpoch = next_data_epoch.fetch_add(1, std::memory_order_relaxed);
+    isInterpolationPending = true;
+}
+
+CURVE_TYPE SegmentedCurve::CurveType()
+{
+    CURVE_TYPE curve_type = CURVE_TYPE::UNKNOWN;
+
+    if (curveData)
+    {
+        curve_type = curveData->curveType;
+    }
+
+    return curve_type;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Curve.h"
+#include "CurveBvh.h"
+#include "CurveArcLength.h"
+#include "CurveStorage.h"
+#include "CurveSegments.h"
+#include <vector>
+#include <array>
+
+// generated data and queries shared by the curve classes. the curve is generated segment by segment into curveList,
+// edits mark the segments they touch and the dirty range is re-tessellated on the next read. a curve class supplies how
+// its point list is split into segments (segmentCount) and how they are tessellated (InterpolatePoints for the whole
+// curve, retessellateSegments for a range of them)
+class SegmentedCurve : public ICurve
+{
+    protected:
+        CurveData * curveData = nullptr; // curve data block used by this class to generate the curve data
+
+        std::vector<std::array<float, 2>> curveList; // data that holds the generated curve from CurveData
+        std::vector<std::array<float, 2>> handleList; // data that holds the generated curve handles from CurveData
+        TessellationStats tessellationStats; // vertex counts of the last interpolation
+
+        std::vector<size_t> segmentOffsets; // start of every generated segment in curveList followed by the end of the open segments (a closing segment fills the rest)
+        std::vector<CurveBounds> segmentBounds; // bounds of every generated segment (same order as segmentOffsets, a closing segment is last)
+        std::vector<CurveBounds> boundsScratch; // reused buffer the bounds of edited segments are generated into before being spliced into segmentBounds
+        std::vector<SegmentControls> segmentControls; // every generated segment as a cubic (same order as segmentBounds), measured by arcLengthTable
+        std::vector<SegmentControls> controlsScratch; // reused buffer the controls of edited segments are generated into before being spliced into segmentControls
+        ArcLengthTable arcLengthTable; // arc length of segmentControls, measured on the first Length/TAtDistance after an edit
+        PointArrays sampleArrays; // curveList as separate x and y arrays (updated on every edit for SAMPLE_LAYOUT::SOA, converted when read otherwise)
+        SegmentBlocks segmentBlocks; // segmentControls packed in blocks of 8 segments (updated like sampleArrays)
+        bool areStorageArraysValid = false; // sampleArrays and segmentBlocks match curveList and segmentControls
+        CurveBounds curveBounds; // bounds of the whole curve
+        bool isCurveBoundsValid = false; // curveBounds matches segmentBounds
+        curve_segments::EditLog editLog; // edits made to curveList and handleList since they were last fully regenerated
+        CurveBvh segmentTree; // hierarchy over segmentBounds used to find the nearest point on the curve
+        std::vector<size_t> segmentScratchOffsets; // start of every segment in segmentScratch
+        std::vector<std::array<float, 2>> segmentScratch; // reused buffer edited segments are re-tessellated into before being spliced into curveList
+        std::vector<std::array<float, 2>> handleScratch; // reused buffer edited segment handles are generated into before being spliced into handleList
+        bool isSegmentDataValid = false; // curveList/handleList were generated segment by segment from the point list and can be updated per segment
+        uint32_t segmentStepCount = 0; // step count the segment data was generated with
+        TESSELLATION_MODE segmentTessellationMode = TESSELLATION_MODE::UNIFORM; // tessellation mode the segment data was generated with
+
+        bool isInterpolationPending = false; // the whole curve is re-tessellated on the next read
+        bool areSegmentsDirty = false; // the dirty segment range is re-tessellated on the next read
+        size_t dirtySegmentFirst = 0; // first segment of the dirty range
+        size_t dirtySegmentOldCount = 0; // number of generated segments the dirty range replaces
+        size_t dirtySegmentNewCount = 0; // number of point list segments the dirty range covers
+        uint64_t trackedGeneration = 0; // curveData generation described by the generated data and the pending edits
+        uint64_t dataEpoch = 0; // DataEpoch() of curveData, handed out by a counter shared by every curve
+
+        virtual size_t segmentCount() const = 0; // number of open segments in the point list
+        virtual void retessellateSegments(size_t first_segment, size_t old_count, size_t new_count) = 0; // replace old_count generated segments with new_count segments re-tessellated from the point list
+        void markSegmentsDirty(size_t first_segment, size_t old_count, size_t new_count); // record an edit of the point list segments before it is made, merged with the edits since the last interpolation
+        void markInterpolationDirty(); // record an edit that needs the whole curve re-tessellated
+        void updateInterpolation(); // run the interpolation pending from the recorded edits (if any)
+        void updateStorageArrays(); // convert curveList and segmentControls to sampleArrays and segmentBlocks if they don't match
+        void setCurveData(CurveData * curve_data); // generate the curve from curve_data on the next read (the curve gets a new data epoch)
+
+        void AddPoint(std::array<float, 2> point) override; // // add points
+        void InsertPoint(std::array<float, 2> point, int32_t index) override; // insert points
+        void DeletePoint(int32_t index) override; // delete points
+
+    public:
+        void CloseLoop(bool close_loop) override; // close the curve - create a line from the last point to the first
+        std::pair<std::array<float, 2>, uint32_t> IntersectionOnCurve(std::array<float, 2> position) override; // get intersecting position of point on the curve and also the insertion index to insert a new point
+        float Length() override; // arc length of the generated curve
+        CurveLocation TAtDistance(float distance) override; // segment, parameter and position at distance along the generated curve (O(log n) after the first call following an edit)
+        void SampleAtDistances(std::span<const float> distances, const PathSamples & out) override; // position and unit tangent at every distance along the generated curve, written to out
+        void SampleAtParameters(std::span<const float> parameters, const PathSamples & out) override; // position and unit tangent at parameters 0..1 over the generated curve (every segment covers an equal share)
+
+        const std::vector<std::array<float, 2>> & Data() override; // return generated curve data points
+        const std::vector<std::array<float, 2>> & HandleData() override; // return generated curve handle data points
+        const PointArrays & DataArrays() override; // Data() as separate x and y arrays
+        const SegmentBlocks & SegmentControlBlocks() override; // every generated segment as a cubic packed in blocks of 8 segments (in the order of SegmentBounds())
+        bool EditsSince(uint64_t generation, std::vector<SampleEdit> & edits) override; // edits to Data() and HandleData() made after generation (false if they aren't all known)
+        void CopyData(size_t first_sample, size_t n_samples, float * out, size_t stride) override; // write samples of Data() to out, stride bytes apart
+        void CopyHandleData(size_t first_handle, size_t n_handles, float * out, size_t stride) override; // write points of HandleData() to out, stride bytes apart
+        const PointList & GetPointData() override;
+        void PointsInRadius(std::array<float, 2> position, float radius, std::vector<uint32_t> & out) override; // indices of every point within radius of position
+        int32_t NearestPoint(std::array<float, 2> position, float max_distance) override; // index of the closest point within max_distance of position (-1 if there is none)
+
+        void ForceInterpolation() override;
+        TessellationStats GetTessellationStats() override; // vertex counts of the generated curve compared to uniform sampling
+        const std::vector<CurveBounds> & SegmentBounds() override; // bounds of every generated segment (in the order they are in Data())
+        const std::vector<size_t> & SegmentOffsets() override; // start of every generated segment in Data() (followed by the end of the open segments)
+        const CurveBvh & SegmentTree() override; // hierarchy over SegmentBounds() (built if it isn't)
+        CurveBounds Bounds() override; // bounds of the whole generated curve
+        uint64_t Generation() override; // generation of the curve data, changes on every edit
+        bool HasChangedSince(uint64_t generation) override; // true if the curve was edited since the given generation
+        uint64_t DataEpoch() override; // changes every time the curve is given a curve data block (generations of different epochs can't be compared)
+        CURVE_TYPE CurveType() override;
+};
@@ -0,0 +1,773 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <filesystem>
+#include <sstream>
+
+#include "Curve.h"
+#include "CubicCurve.h"
+#include "QuadraticCurve.h"
+#include "LinearCurve.h"
+#include "BezierCurve.h"
+#include "CurveEffect.h"
+#include "CurveKernel.h"
+#include "CurveTrace.h"
+#include "AllocationCounter.h"
+#include "FrameProfiler.h"
+#include "CurveFile.h"
+#include "CurveSvg.h"
+#include "CurveStorage.h"
+#include "Bezier.h"
+
+// headless benchmark of the curve classes. every operation is repeated until it has run for at least minRunTime (and
+// at least once) and the results are written as json, one entry per curve type, curve size and operation
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchResult
+    {
+        std::string curve;
+        std::string operation;
+        size_t anchors = 0;
+        size_t samples = 0; // samples the curve is tessellated into
+        size_t iterations = 0;
+        double meanNs = 0.0;
+        double minNs = 0.0;
+        size_t bytes = 0; // input bytes per iteration of operations that report a throughput
+    };
+
+    volatile size_t resultSink = 0; // results of the timed calls are written here so they aren't optimized out
+
+    struct BenchSettings
+    {
+        size_t maxAnchors = 1000000;
+        double minRunTime = 0.25; // seconds each operation is repeated for
+        size_t maxIterations = 1000;
+        size_t dragSteps = 60; // UpdatePoint calls of a single drag (one per frame)
+        size_t queries = 256; // IntersectionOnCurve calls per iteration
+        size_t pathQueries = 1000000; // distances per SampleAtDistances/SampleAtParameters batch
+        size_t scanQueries = 16; // queries per iteration of the hit tests that scan the whole curve
+        bool runNoise = true;
+        bool checkAllocations = false; // run the steady state allocation check instead of the benchmark
+        std::string outputPath; // stdout if empty
+        std::string tracePath; // trace events of the whole run are written here (if tracing is compiled in)
+    };
+
+    // anchors along a wave so segments aren't degenerate and the curve doesn't overlap itself much
+    std::vector<std::array<float, 2>> makeAnchors(size_t n_anchors)
+    {
+        std::vector<std::array<float, 2>> anchors(n_anchors);
+
+        for (size_t i=0; i<n_anchors; i++)
+        {
+            const auto x = static_cast<float>(i);
+            anchors[i] = {x * 20.0f, 400.0f + (200.0f * std::sin(x * 0.35f))};
+        }
+
+        return anchors;
+    }
+
+    // build the curve through the anchors. the segments of a BezierCurve cycle through the degrees 1 to 7 with their
+    // control points alternating above and below the line between the anchors
+    template<typename CurveClass>
+    void buildCurve(CurveClass & curve, const std::vector<std::array<float, 2>> & anchors)
+    {
+        curve.BuildFromAnchors(anchors);
+    }
+
+    void buildCurve(BezierCurve & curve, const std::vector<std::array<float, 2>> & anchors)
+    {
+        std::vector<std::array<float, 2>> points;
+        std::vector<uint8_t> degrees;
+
+        for (size_t i=0; i<anchors.size(); i++)
+        {
+            if (i > 0)
+            {
+                const std::array<float, 2> & a = anchors[i - 1];
+                const std::array<float, 2> & b = anchors[i];
+                const size_t degree = 1 + ((i - 1) % 7);
+
+                for (size_t k=1; k<degree; k++)
+                {
+                    const float w = static_cast<float>(k) / static_cast<float>(degree);
+                    points.push_back({a[0] + (w * (b[0] - a[0])), a[1] + (w * (b[1] - a[1])) + (((k % 2) == 0) ? 30.0f : -30.0f)});
+                }
+
+                degrees.push_back(static_cast<uint8_t>(degree));
+            }
+
+            points.push_back(anchors[i]);
+        }
+
+        curve.BuildFromSegments(points, degrees);
+    }
+
+    // svg path data through the anchors, cycling through lines, quadratics and cubics in absolute and relative form
+    std::string makePathData(const std::vector<std::array<float, 2>> & anchors)
+    {
+        std::string path_data;
+        path_data.reserve(anchors.size() * 48);
+        char segment_str[128];
+
+        for (size_t i=0; i<anchors.size(); i++)
+        {
+            const std::array<float, 2> & p = anchors[i];
+            const std::array<float, 2> & prev = anchors[(i > 0) ? (i - 1) : 0];
+            const float dx = p[0] - prev[0];
+            const float dy = p[1] - prev[1];
+
+            switch ((i == 0) ? 6 : (i % 6))
+            {
+                case 0: std::snprintf(segment_str, sizeof(segment_str), "L%.3f,%.3f", p[0], p[1]); break;
+                case 1: std::snprintf(segment_str, sizeof(segment_str), " l%.3f %.3f", dx, dy); break;
+                case 2: std::snprintf(segment_str, sizeof(segment_str), " Q%.3f %.3f %.3f %.3f", prev[0] + (dx * 0.5f), prev[1] - 30.0f, p[0], p[1]); break;
+                case 3: std::snprintf(segment_str, sizeof(segment_str), " q%.3f,%.3f %.3f,%.3f", dx * 0.5f, 30.0f, dx, dy); break;
+                case 4: std::snprintf(segment_str, sizeof(segment_str), " C%.3f %.3f %.3f %.3f %.3f %.3f", prev[0] + (dx / 3.0f), prev[1] + 20.0f, p[0] - (dx / 3.0f), p[1] - 20.0f, p[0], p[1]); break;
+                case 5: std::snprintf(segment_str, sizeof(segment_str), " c%.3f %.3f %.3f %.3f %.3f %.3f", dx / 3.0f, -20.0f, dx * (2.0f / 3.0f), dy + 20.0f, dx, dy); break;
+                default: std::snprintf(segment_str, sizeof(segment_str), "M%.3f %.3f", p[0], p[1]); break;
+            }
+
+            path_data += segment_str;
+        }
+
+        return path_data;
+    }
+
+    // time fn until it has run for min_run_time. setup runs before every call and isn't timed
+    template<typename Setup, typename Fn>
+    void measure(const BenchSettings & settings, BenchResult & result, Setup && setup, Fn && fn)
+    {
+        double total_ns = 0.0;
+        double min_ns = std::numeric_limits<double>::max();
+        size_t iterations = 0;
+
+        while ((iterations == 0) || ((total_ns < (settings.minRunTime * 1e9)) && (iterations < settings.maxIterations)))
+        {
+            setup();
+
+            auto begin = Clock::now();
+            fn();
+            auto end = Clock::now();
+
+            const double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+            total_ns += ns;
+            min_ns = std::min(min_ns, ns);
+            iterations++;
+        }
+
+        result.iterations = iterations;
+        result.meanNs = total_ns / static_cast<double>(iterations);
+        result.minNs = min_ns;
+    }
+
+    template<typename CurveClass>
+    void benchCurve(const char * curve_name, size_t n_anchors, const BenchSettings & settings, std::vector<BenchResult> & results)
+    {
+        const std::vector<std::array<float, 2>> anchors = makeAnchors(n_anchors);
+        auto curve_data = CurveClass::NewCurveData();
+        CurveClass curve (curve_data.get());
+
+        auto add_result = [&](const char * operation) -> BenchResult &
+        {
+            BenchResult & result = results.emplace_back();
+            result.curve = curve_name;
+            result.operation = operation;
+            result.anchors = n_anchors;
+            return result;
+        };
+
+        auto no_setup = [](){};
+
+        // construction: bulk build and tessellate the whole curve
+        {
+            BenchResult & result = add_result("construction");
+            measure(settings, result, [&](){ curve_data = CurveClass::NewCurveData(); curve = curve_data; }, [&]()
+            {
+                buildCurve(curve, anchors);
+                curve.Data();
+            });
+
+            result.samples = curve.Data().size();
+        }
+
+        const size_t n_samples = curve.Data().size();
+
+        // InterpolatePoints: full re-tessellation of an unchanged curve
+        {
+            BenchResult & result = add_result("interpolate_points");
+            result.samples = n_samples;
+            measure(settings, result, [&](){ curve.ForceInterpolation(); }, [&](){ curve.Data(); });
+        }
+
+        // UpdatePoint: drag a point in the middle of the curve, reading the curve back after every step like a frame would
+        {
+            BenchResult & result = add_result("update_point_drag");
+            result.samples = n_samples;
+
+            const auto index = static_cast<int32_t>(curve.GetPointData().size() / 2);
+            const std::array<float, 2> start = curve.GetPointData()[index];
+
+            measure(settings, result, no_setup, [&]()
+            {
+                for (size_t i=0; i<settings.dragSteps; i++)
+                {
+                    const auto step = static_cast<float>(i);
+                    curve.UpdatePoint(index, {start[0] + step, start[1] + (step * 0.5f)}, CURVE_CONTROL::ALIGNMENT);
+                    curve.Data();
+                }
+            });
+
+            result.meanNs /= static_cast<double>(settings.dragSteps);
+            result.minNs /= static_cast<double>(settings.dragSteps);
+        }
+
+        // IntersectionOnCurve: queries close to random anchors
+        {
+            BenchResult & result = add_result("intersection_on_curve");
+            result.samples = curve.Data().size();
+
+            std::mt19937 rand_gen(1234);
+            std::uniform_int_distribution<size_t> anchor_dist(0, n_anchors - 1);
+            std::uniform_real_distribution<float> offset_dist(-8.0f, 8.0f);
+            std::vector<std::array<float, 2>> queries(settings.queries);
+
+            for (auto & query : queries)
+            {
+                const std::array<float, 2> & anchor = anchors[anchor_dist(rand_gen)];
+                query = {anchor[0] + offset_dist(rand_gen), anchor[1] + offset_dist(rand_gen)};
+            }
+
+            curve.IntersectionOnCurve(queries.front()); // the segment tree is built on the first query
+
+            measure(settings, result, no_setup, [&]()
+            {
+                for (const auto & query : queries)
+                {
+                    resultSink = resultSink + curve.IntersectionOnCurve(query).second;
+                }
+            });
+
+            result.meanNs /= static_cast<double>(queries.size());
+            result.minNs /= static_cast<double>(queries.size());
+        }
+
+        // arc length: measuring the whole curve after a full interpolation, then queries at random distances along it
+        {
+            BenchResult & measure_result = add_result("arc_length_measure");
+            measure_result.samples = n_samples;
+            measure(settings, measure_result, [&](){ curve.ForceInterpolation(); curve.Data(); }, [&](){ resultSink = static_cast<size_t>(curve.Length()); });
+
+            BenchResult & query_result = add_result("t_at_distance");
+            query_result.samples = n_samples;
+
+            const float length = curve.Length();
+            std::mt19937 rand_gen(1234);
+            std::uniform_real_distribution<float> distance_dist(0.0f, length);
+            std::vector<float> distances(settings.queries);
+
+            for (float & distance : distances)
+            {
+                distance = distance_dist(rand_gen);
+            }
+
+            measure(settings, query_result, no_setup, [&]()
+            {
+                for (const float distance : distances)
+                {
+                    resultSink = resultSink + curve.TAtDistance(distance).segment;
+                }
+            });
+
+            query_result.meanNs /= static_cast<double>(distances.size());
+            query_result.minNs /= static_cast<double>(distances.size());
+        }
+
+        // batch path following: positions and tangents of pathQueries objects at random distances (and parameters)
+        // along the curve, time per batch
+        {
+            const float length = curve.Length();
+            std::mt19937 rand_gen(1234);
+            std::uniform_real_distribution<float> distance_dist(0.0f, length);
+
+            std::vector<float> distances(settings.pathQueries);
+            std::vector<float> parameters(settings.pathQueries);
+            for (size_t i=0; i<distances.size(); i++)
+            {
+                distances[i] = distance_dist(rand_gen);
+                parameters[i] = (length > 0.0f) ? (distances[i] / length) : 0.0f;
+            }
+
+            std::vector<float> samples(distances.size() * 4); // x, y, tangent x and tangent y after each other
+            const PathSamples out = {samples.data(), samples.data() + distances.size(), samples.data() + (distances.size() * 2), samples.data() + (distances.size() * 3)};
+
+            BenchResult & distance_result = add_result("sample_at_distances");
+            distance_result.samples = distances.size();
+            measure(settings, distance_result, no_setup, [&](){ curve.SampleAtDistances(distances, out); });
+
+            std::sort(distances.begin(), distances.end());
+            BenchResult & sorted_result = add_result("sample_at_sorted_distances");
+            sorted_result.samples = distances.size();
+            measure(settings, sorted_result, no_setup, [&](){ curve.SampleAtDistances(distances, out); });
+
+            BenchResult & parameter_result = add_result("sample_at_parameters");
+            parameter_result.samples = parameters.size();
+            measure(settings, parameter_result, no_setup, [&](){ curve.SampleAtParameters(parameters, out); });
+        }
+
+        // storage layouts: the same work on interleaved points and on the structure of arrays copies. every segment
+        // (as a cubic) tessellated into a preallocated buffer, the nearest sample to a query by a full scan and the
+        // segments whose control points are near a query, time per tessellation and per query
+        {
+            const SegmentBlocks & blocks = curve.SegmentControlBlocks();
+            std::vector<SegmentControls> controls (blocks.size());
+            for (size_t i=0; i<blocks.size(); i++)
+            {
+                controls[i] = blocks[i];
+            }
+
+            const uint32_t n_steps = curve_kernel::StepCount(curve_data->smoothFactor);
+            const size_t n_tessellated = controls.size() * (n_steps + 1);
+
+            std::vector<std::array<float, 2>> interleaved (n_tessellated);
+            PointArrays arrays;
+            arrays.Resize(n_tessellated);
+
+            BenchResult & interleaved_result = add_result("tessellate_interleaved");
+            interleaved_result.samples = n_tessellated;
+            measure(settings, interleaved_result, no_setup, [&]()
+            {
+                for (size_t i=0; i<controls.size(); i++)
+                {
+                    const SegmentControls & c = controls[i];
+                    curve_kernel::EvaluateCubic(c[0], c[1], c[2], c[3], n_steps, interleaved.data() + (i * (n_steps + 1)));
+                }
+            });
+
+            BenchResult & arrays_result = add_result("tessellate_soa");
+            arrays_result.samples = n_tessellated;
+            measure(settings, arrays_result, no_setup, [&]()
+            {
+                for (size_t i=0; i<controls.size(); i++)
+                {
+                    const SegmentControls & c = controls[i];
+                    curve_kernel::EvaluateCubicSoa(c[0], c[1], c[2], c[3], n_steps, arrays.X() + (i * (n_steps + 1)), arrays.Y() + (i * (n_steps + 1)));
+                }
+            });
+
+            // the same segments through the scalar bezier core in every scalar type it is instantiated for. they are
+            // sampled relative to their first point, the range of FixedPoint doesn't reach far along the curve
+            auto add_scalar_result = [&]<typename Scalar>(const char * operation, Scalar)
+            {
+                std::vector<Bezier<3, Scalar>> segments (controls.size());
+                for (size_t i=0; i<controls.size(); i++)
+                {
+                    Bezier<3, float> local {controls[i]};
+                    for (std::array<float, 2> & point : local.points)
+                    {
+                        point = {point[0] - controls[i][0][0], point[1] - controls[i][0][1]};
+                    }
+
+                    segments[i] = local.template Cast<Scalar>();
+                }
+
+                std::vector<bezier::Point<Scalar>> samples (n_tessellated);
+
+                BenchResult & result = add_result(operation);
+                result.samples = n_tessellated;
+                measure(settings, result, no_setup, [&]()
+                {
+                    for (size_t i=0; i<segments.size(); i++)
+                    {
+                        bezier::Sample(segments[i], n_steps, samples.data() + (i * (n_steps + 1)));
+                    }
+
+                    resultSink = resultSink + static_cast<size_t>(static_cast<float>(samples.back()[0]));
+                });
+            };
+
+            add_scalar_result("bezier_sample_float", 0.0f);
+            add_scalar_result("bezier_sample_double", 0.0);
+            add_scalar_result("bezier_sample_fixed", FixedPoint());
+
+            std::mt19937 rand_gen(1234);
+            std::uniform_int_distribution<size_t> anchor_dist(0, n_anchors - 1);
+            std::uniform_real_distribution<float> offset_dist(-8.0f, 8.0f);
+            std::vector<std::array<float, 2>> queries(settings.scanQueries);
+
+            for (auto & query : queries)
+            {
+                const std::array<float, 2> & anchor = anchors[anchor_dist(rand_gen)];
+                query = {anchor[0] + offset_dist(rand_gen), anchor[1] + offset_dist(rand_gen)};
+            }
+
+            const std::vector<std::array<float, 2>> & samples = curve.Data();
+            const PointArrays & sample_arrays = curve.DataArrays();
+            std::vector<uint32_t> near_segments;
+            constexpr float hit_radius = 10.0f;
+
+            auto add_query_result = [&](const char * operation, auto && query_fn)
+            {
+                BenchResult & result = add_result(operation);
+                result.samples = samples.size();
+                measure(settings, result, no_setup, [&]()
+                {
+                    for (const auto & query : queries)
+                    {
+                        query_fn(query);
+                    }
+                });
+
+                result.meanNs /= static_cast<double>(queries.size());
+                result.minNs /= static_cast<double>(queries.size());
+            };
+
+            add_query_result("hit_test_samples_interleaved", [&](const std::array<float, 2> & query){ resultSink = resultSink + static_cast<size_t>(curve_storage::FindNearestSample(samples, query).index); });
+            add_query_result("hit_test_samples_soa", [&](const std::array<float, 2> & query){ resultSink = resultSink + static_cast<size_t>(curve_storage::FindNearestSample(sample_arrays, query).index); });
+            add_query_result("hit_test_segments_interleaved", [&](const std::array<float, 2> & query){ curve_storage::SegmentsNearPoint(controls, query, hit_radius, near_segments); resultSink = resultSink + near_segments.size(); });
+            add_query_result("hit_test_segments_blocks", [&](const std::array<float, 2> & query){ curve_storage::SegmentsNearPoint(blocks, query, hit_radius, near_segments); resultSink = resultSink + near_segments.size(); });
+        }
+
+        // the drag of update_point_drag with the structure of arrays copies updated on every step
+        {
+            BenchResult & result = add_result("update_point_drag_soa");
+            result.samples = n_samples;
+
+            curve_data->sampleLayout = SAMPLE_LAYOUT::SOA;
+            curve.ForceInterpolation();
+            curve.DataArrays();
+
+            const auto index = static_cast<int32_t>(curve.GetPointData().size() / 2);
+            const std::array<float, 2> start = curve.GetPointData()[index];
+
+            measure(settings, result, no_setup, [&]()
+            {
+                for (size_t i=0; i<settings.dragSteps; i++)
+                {
+                    const auto step = static_cast<float>(i);
+                    curve.UpdatePoint(index, {start[0] + step, start[1] + (step * 0.5f)}, CURVE_CONTROL::ALIGNMENT);
+                    resultSink = curve.DataArrays().size();
+                }
+            });
+
+            result.meanNs /= static_cast<double>(settings.dragSteps);
+            result.minNs /= static_cast<double>(settings.dragSteps);
+
+            curve_data->sampleLayout = SAMPLE_LAYOUT::INTERLEAVED;
+        }
+
+        // CurveFile: write the curve and open it again (the opened curve borrows the mapped points). the file format and
+        // the svg importer have no curve type for mixed degrees
+        if (curve.CurveType() != CURVE_TYPE::BEZIER)
+        {
+            const std::string file_path = (std::filesystem::temp_directory_path() / "curve_bench_curve.bin").string();
+            const CurveData * file_curves[] = {curve_data.get()};
+
+            BenchResult & write_result = add_result("file_write");
+            write_result.samples = n_samples;
+            measure(settings, write_result, no_setup, [&](){ resultSink = CurveFile::Write(file_path, file_curves); });
+
+            BenchResult & open_result = add_result("file_open");
+            open_result.samples = n_samples;
+
+            CurveFile curve_file;
+            measure(settings, open_result, no_setup, [&]()
+            {
+                curve_file.Open(file_path);
+                resultSink = curve_file.Curve(0)->pointList.size();
+            });
+
+            curve_file.Close();
+            std::filesystem::remove(file_path);
+        }
+
+        // svg import: the curve as path data, streamed through the parser and bulk built (throughput in mb_per_s)
+        if (curve.CurveType() != CURVE_TYPE::BEZIER)
+        {
+            BenchResult & result = add_result("svg_import");
+            const std::string path_data = makePathData(anchors);
+            result.bytes = path_data.size();
+
+            std::istringstream input (path_data);
+            std::vector<std::unique_ptr<CurveData>> imported;
+
+            measure(settings, result, [&](){ input.clear(); input.seekg(0); imported.clear(); }, [&]()
+            {
+                curve_svg::ImportPath(input, curve.CurveType(), imported);
+            });
+
+            result.samples = imported.empty() ? 0 : imported.front()->pointList.size();
+        }
+
+        // Noise: effect applied to the generated curve
+        if (settings.runNoise)
+        {
+            BenchResult & result = add_result("noise");
+            std::vector<std::array<float, 2>> curve_samples = curve.Data();
+            result.samples = curve_samples.size();
+
+            BenchSettings noise_settings = settings;
+            noise_settings.maxIterations = 3; // Noise sleeps to make up a seed, a few calls are enough
+
+            measure(noise_settings, result, no_setup, [&](){ resultSink = curve_effect::Noise(curve_samples).size(); });
+        }
+    }
+
+#if CURVE_TRACE_ENABLED
+    // cost of a trace scope while recording (the trace is dropped afterwards)
+    void benchTraceScope(const BenchSettings & settings, std::vector<BenchResult> & results)
+    {
+        constexpr size_t n_scopes = 100000;
+
+        BenchResult & result = results.emplace_back();
+        result.curve = "none";
+        result.operation = "trace_scope";
+
+        measure(settings, result, [](){ curve_trace::Start(); }, [&]()
+        {
+            for (size_t i=0; i<n_scopes; i++)
+            {
+                CURVE_TRACE_SCOPE("curve_bench::trace_scope");
+                resultSink = i;
+            }
+        });
+        curve_trace::Stop();
+
+        result.meanNs /= static_cast<double>(n_scopes);
+        result.minNs /= static_cast<double>(n_scopes);
+    }
+#endif
+
+    // the work of an editor frame on a curve that doesn't change size: drag a point along a path and back, read the
+    // curve (in both layouts) and its edits back, run the hover/picking queries and apply the noise effect into a
+    // reused buffer. after a first pass has grown every buffer a second pass over the same path shouldn't allocate at all
+    template<typename CurveClass>
+    bool checkSteadyStateAllocations(const char * curve_name, size_t n_anchors, const BenchSettings & settings)
+    {
+        const std::vector<std::array<float, 2>> anchors = makeAnchors(n_anchors);
+        auto curve_data = CurveClass::NewCurveData();
+        CurveClass curve (curve_data.get());
+        curve_data->sampleLayout = SAMPLE_LAYOUT::SOA;
+        buildCurve(curve, anchors);
+        curve.Data();
+
+        const auto index = static_cast<int32_t>(curve.GetPointData().size() / 2);
+        const std::array<float, 2> start = curve.GetPointData()[index];
+
+        FrameProfiler profiler;
+        profiler.SetEnabled(true);
+
+        std::vector<SampleEdit> edits;
+        std::vector<uint32_t> points_in_radius;
+        std::vector<std::array<float, 2>> noise_data;
+        uint64_t generation = curve.Generation();
+
+        auto run_frames = [&]()
+        {
+            for (size_t i=0; i<(settings.dragSteps * 2); i++)
+            {
+                profiler.BeginFrame();
+
+                const auto step = static_cast<float>((i < settings.dragSteps) ? i : ((settings.dragSteps * 2) - 1 - i));
+                const std::array<float, 2> position = {start[0] + step, start[1] + (step * 0.5f)};
+
+                curve.UpdatePoint(index, position, CURVE_CONTROL::ALIGNMENT);
+                resultSink = curve.Data().size() + curve.DataArrays().size() + curve.SegmentControlBlocks().size();
+                curve.EditsSince(generation, edits);
+                generation = curve.Generation();
+
+                resultSink = resultSink + curve.IntersectionOnCurve(position).second;
+                resultSink = resultSink + curve.NearestPointOnCurve(position).segment;
+                curve.PointsInRadius(position, 20.0f, points_in_radius);
+                resultSink = resultSink + static_cast<size_t>(curve.NearestPoint(position, 20.0f));
+
+                profiler.EndFrame();
+            }
+
+            if (settings.runNoise)
+            {
+                curve_effect::Noise(curve.Data(), noise_data);
+            }
+        };
+
+        run_frames(); // warm up
+
+        const allocation_counter::AllocationStats before = allocation_counter::Snapshot();
+        run_frames();
+        const allocation_counter::AllocationStats steady = allocation_counter::Snapshot() - before;
+
+        std::cerr << "curve_bench: " << curve_name << " " << n_anchors << " anchors, " << steady.allocations << " steady state allocations (" << steady.bytes << " bytes)";
+        for (size_t category=0; category<allocation_counter::categoryCount; category++)
+        {
+            if (steady.categoryAllocations[category] > 0)
+            {
+                std::cerr << ", " << allocation_counter::CategoryName(static_cast<ALLOCATION_CATEGORY>(category)) << " " << steady.categoryAllocations[category];
+            }
+        }
+        std::cerr << "\n";
+
+        return steady.allocations == 0;
+    }
+
+    const char * isaName(KERNEL_ISA isa)
+    {
+        switch (isa)
+        {
+            case KERNEL_ISA::SSE2:
+                return "sse2";
+
+            case KERNEL_ISA::AVX2:
+                return "avx2";
+
+            case KERNEL_ISA::AVX512:
+                return "avx512";
+
+            default:
+                return "scalar";
+        }
+    }
+
+    void writeJson(std::ostream & os, const std::vector<BenchResult> & results)
+    {
+        os << "{\n  \"benchmark\": \"curve_bench\",\n  \"kernel_isa\": \"" << isaName(curve_kernel::ActiveIsa()) << "\",\n  \"results\": [\n";
+
+        for (size_t i=0; i<results.size(); i++)
+        {
+            const BenchResult & result = results[i];
+            os << "    {\"curve\": \"" << result.curve << "\", \"operation\": \"" << result.operation << "\", \"anchors\": " << result.anchors
+               << ", \"samples\": " << result.samples << ", \"iterations\": " << result.iterations
+               << ", \"mean_ns\": " << result.meanNs << ", \"min_ns\": " << result.minNs;
+
+            if (result.bytes > 0)
+            {
+                os << ", \"bytes\": " << result.bytes << ", \"mb_per_s\": " << (static_cast<double>(result.bytes) * 1e3 / result.meanNs);
+            }
+
+            os << "}" << (((i + 1) < results.size()) ? ",\n" : "\n");
+        }
+
+        os << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char*argv[])
+{
+    BenchSettings settings;
+
+    for (int i=1; i<argc; i++)
+    {
+        const bool has_value = (i + 1) < argc;
+
+        if ((std::strcmp(argv[i], "--max-anchors") == 0) && has_value)
+        {
+            settings.maxAnchors = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if ((std::strcmp(argv[i], "--min-time") == 0) && has_value)
+        {
+            settings.minRunTime = std::strtod(argv[++i], nullptr);
+        }
+        else if ((std::strcmp(argv[i], "--output") == 0) && has_value)
+        {
+            settings.outputPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--no-noise") == 0)
+        {
+            settings.runNoise = false;
+        }
+        else if ((std::strcmp(argv[i], "--trace") == 0) && has_value)
+        {
+            settings.tracePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--check-allocations") == 0)
+        {
+            settings.checkAllocations = true;
+        }
+        else
+        {
+            std::cerr << "usage: curve_bench [--max-anchors n] [--min-time seconds] [--output file.json] [--no-noise] [--trace trace.json] [--check-allocations]\n";
+            return 1;
+        }
+    }
+
+    // exits with 1 if any curve allocates in the steady state
+    if (settings.checkAllocations)
+    {
+        if (!allocation_counter::IsCompiledIn())
+        {
+            std::cerr << "curve_bench: allocation counting is compiled out (configure with -DBASIC_CURVES_COUNT_ALLOCATIONS=ON)\n";
+            return 1;
+        }
+
+        bool is_steady = true;
+        for (size_t n_anchors=10; n_anchors<=std::min<size_t>(settings.maxAnchors, 10000); n_anchors*=10)
+        {
+            is_steady &= checkSteadyStateAllocations<LinearCurve>("linear", n_anchors, settings);
+            is_steady &= checkSteadyStateAllocations<QuadraticCurve>("quadratic", n_anchors, settings);
+            is_steady &= checkSteadyStateAllocations<CubicCurve>("cubic", n_anchors, settings);
+            is_steady &= checkSteadyStateAllocations<BezierCurve>("bezier", n_anchors, settings);
+        }
+
+        std::cerr << "curve_bench: " << (is_steady ? "no steady state allocations" : "steady state allocations found") << "\n";
+        return is_steady ? 0 : 1;
+    }
+
+    std::vector<BenchResult> results;
+
+#if CURVE_TRACE_ENABLED
+    benchTraceScope(settings, results);
+
+    if (!settings.tracePath.empty())
+    {
+        curve_trace::Start();
+    }
+#else
+    if (!settings.tracePath.empty())
+    {
+        std::cerr << "curve_bench: tracing is compiled out (configure with -DBASIC_CURVES_TRACE=ON)\n";
+    }
+#endif
+
+    for (size_t n_anchors=10; n_anchors<=settings.maxAnchors; n_anchors*=10)
+    {
+        std::cerr << "curve_bench: " << n_anchors << " anchors\n";
+
+        benchCurve<LinearCurve>("linear", n_anchors, settings, results);
+        benchCurve<QuadraticCurve>("quadratic", n_anchors, settings, results);
+        benchCurve<CubicCurve>("cubic", n_anchors, settings, results);
+        benchCurve<BezierCurve>("bezier", n_anchors, settings, results);
+    }
+
+#if CURVE_TRACE_ENABLED
+    if (!settings.tracePath.empty())
+    {
+        curve_trace::Stop();
+        std::cerr << "curve_bench: writing " << curve_trace::EventCount() << " trace events to " << settings.tracePath << "\n";
+        curve_trace::WriteJson(settings.tracePath);
+    }
+#endif
+
+    if (settings.outputPath.empty())
+    {
+        writeJson(std::cout, results);
+    }
+    else
+    {
+        std::ofstream output (settings.outputPath);
+        writeJson(output, results);
+    }
+
+    return 0;
+}
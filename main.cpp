@@ -323,7 +323,7 @@ int main(int argc, char*argv[])
             }
             else
             {
-                std::vector<std::array<float,2>> curve_data = cubic_curve.Data();
+                const std::vector<std::array<float,2>> & curve_data = cubic_curve.Data();
                 std::vector<sf::Vertex> mvlist;
 
                 for (const auto & p : curve_data)
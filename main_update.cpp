@@ -17,6 +17,10 @@
 #include "LinearCurve.h"
 #include "DrawCurve.h"
 #include "CurveEffect.h"
+#include "FrameProfiler.h"
+#include "ProfilerOverlay.h"
+#include "CurveTrace.h"
+#include "CurveFile.h"
 
 sf::Vertex linear_curve(sf::Vertex p0, sf::Vertex p1, float t);
 sf::Vertex quadratic_curve(sf::Vertex p0, sf::Vertex p1, sf::Vertex p2, float t);
@@ -102,6 +106,13 @@ int main(int argc, char*argv[])
     bool alt_key_down = false;
     bool ignore_click = true; // ignore 1st click to avoid adding velocity when mouse is not moving
 
+    // camera the curves are drawn with. the mouse wheel zooms around the cursor and the right mouse button pans
+
+    sf::View curve_view = window.getDefaultView();
+    sf::Vector2i pan_mouse_position; // window position of the cursor when panning last moved the view
+    bool is_panning = false;
+    bool is_culling_enabled = true;
+
     // graphic shapes
 
     sf::ConvexShape fill_shape;
@@ -132,6 +143,11 @@ int main(int argc, char*argv[])
 
     //
 
+    // F5 saves the curve to curve.bcurves and F9 loads it back. a loaded curve borrows its points from the mapped file,
+    // so the file is declared before the curve data and outlives it
+    const std::string curve_file_path = "curve.bcurves";
+    std::unique_ptr<CurveFile> curve_file;
+
     auto curve_data_cubic = CubicCurve::NewCurveData();
     auto curve_data_linear = LinearCurve::NewCurveData();
     auto curve_data_quadratic = QuadraticCurve::NewCurveData();
@@ -148,8 +164,43 @@ int main(int argc, char*argv[])
     //ICurve * active_curve = &cubic_curve;
     ICurve * active_curve = &linear_curve;
 
+    // profiler mode (P key) times the stages of every frame, O writes the recorded frames to a csv file
+
+    FrameProfiler profiler;
+    ProfilerOverlay profiler_overlay;
+    uint32_t n_profile_dumps = 0;
+
+#if CURVE_TRACE_ENABLED
+    uint32_t n_traces = 0; // R starts/stops recording trace events and writes them to trace_<n>.json
+
+    auto stop_trace = [&]()
+    {
+        curve_trace::Stop();
+        std::string trace_path = "trace_" + std::to_string(n_traces++) + ".json";
+
+        if (curve_trace::WriteJson(trace_path))
+        {
+            std::cout << "wrote " << curve_trace::EventCount() << " trace events to " << trace_path << "\n";
+        }
+        else
+        {
+            std::cerr << "unable to write " << trace_path << "\n";
+        }
+    };
+#endif
+
+    if (show_text)
+    {
+        profiler_overlay.SetFont(font);
+    }
+
+    std::vector<sf::Vertex> fill_buffer; // reused by the old curve drawers every frame
+
     while (window.isOpen())
     {
+        profiler.BeginFrame();
+        auto events_timer = profiler.Scope(PROFILE_STAGE::EVENTS);
+
         sf::Event event {};
         while (window.pollEvent(event))
         {
@@ -158,6 +209,17 @@ int main(int argc, char*argv[])
                 window.close();
             }
 
+            if (event.type == sf::Event::MouseWheelScrolled)
+            {
+                // keep the point under the cursor in place while zooming
+                constexpr float zoom_step = 1.1f;
+                const sf::Vector2i cursor (event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+                const sf::Vector2f cursor_before = window.mapPixelToCoords(cursor, curve_view);
+
+                curve_view.zoom((event.mouseWheelScroll.delta > 0.0f) ? (1.0f / zoom_step) : zoom_step);
+                curve_view.move(cursor_before - window.mapPixelToCoords(cursor, curve_view));
+            }
+
             if (event.type == sf::Event::KeyPressed)
             {
                 if ((event.key.code == sf::Keyboard::LControl) || (event.key.code == sf::Keyboard::RControl))
@@ -241,6 +303,29 @@ int main(int argc, char*argv[])
                     active_curve->ForceInterpolation();
                 }
 
+                if (event.key.code == sf::Keyboard::T)
+                {
+                    // cycle through tessellation modes [uniform, forward difference, adaptive, arc length]
+                    if (curve_data_linear->tessellationMode == TESSELLATION_MODE::UNIFORM)
+                    {
+                        curve_data_linear->tessellationMode = TESSELLATION_MODE::FORWARD_DIFFERENCE;
+                    }
+                    else if (curve_data_linear->tessellationMode == TESSELLATION_MODE::FORWARD_DIFFERENCE)
+                    {
+                        curve_data_linear->tessellationMode = TESSELLATION_MODE::ADAPTIVE;
+                    }
+                    else if (curve_data_linear->tessellationMode == TESSELLATION_MODE::ADAPTIVE)
+                    {
+                        curve_data_linear->tessellationMode = TESSELLATION_MODE::ARC_LENGTH;
+                    }
+                    else // TESSELLATION_MODE::ARC_LENGTH
+                    {
+                        curve_data_linear->tessellationMode = TESSELLATION_MODE::UNIFORM;
+                    }
+
+                    active_curve->ForceInterpolation();
+                }
+
                 if (event.key.code == sf::Keyboard::B)
                 {
                     if (primitive_type == sf::PrimitiveType::LineStrip)
@@ -271,6 +356,97 @@ int main(int argc, char*argv[])
 
                 if (event.key.code == sf::Keyboard::P)
                 {
+                    profiler.SetEnabled(!profiler.IsEnabled());
+                }
+
+                if (event.key.code == sf::Keyboard::O)
+                {
+                    std::string profile_path = "profile_" + std::to_string(n_profile_dumps++) + ".csv";
+
+                    if (profiler.WriteCsv(profile_path))
+                    {
+                        std::cout << "wrote " << profiler.FrameCount() << " frames to " << profile_path << "\n";
+                    }
+                    else
+                    {
+                        std::cerr << "unable to write " << profile_path << "\n";
+                    }
+                }
+
+                if (event.key.code == sf::Keyboard::L)
+                {
+                    is_culling_enabled ^= true;
+                    draw_cubic_curve.SetCulling(is_culling_enabled);
+                    d_linear_curve.SetCulling(is_culling_enabled);
+                }
+
+                if (event.key.code == sf::Keyboard::R)
+                {
+#if CURVE_TRACE_ENABLED
+                    if (!curve_trace::IsRecording())
+                    {
+                        curve_trace::Start();
+                        std::cout << "recording trace events\n";
+                    }
+                    else
+                    {
+                        stop_trace();
+                    }
+#else
+                    std::cerr << "tracing is compiled out (configure with -DBASIC_CURVES_TRACE=ON)\n";
+#endif
+                }
+
+                if (event.key.code == sf::Keyboard::F5)
+                {
+                    // a loaded curve still borrows its points from the file about to be replaced, which windows
+                    // doesn't allow while it is mapped. take a copy of the points and unmap the file first
+                    if (curve_file)
+                    {
+                        curve_data_linear->pointList.MakeOwned();
+                        curve_file.reset();
+                    }
+
+                    const CurveData * saved_curves[] = {curve_data_linear.get()};
+                    std::string error;
+
+                    if (CurveFile::Write(curve_file_path, saved_curves, &error))
+                    {
+                        std::cout << "wrote " << curve_data_linear->pointList.size() << " points to " << curve_file_path << "\n";
+                    }
+                    else
+                    {
+                        std::cerr << "unable to write " << curve_file_path << ": " << error << "\n";
+                    }
+                }
+
+                if (event.key.code == sf::Keyboard::F9)
+                {
+                    auto loaded_file = std::make_unique<CurveFile>();
+                    std::string error;
+
+                    if (loaded_file->Open(curve_file_path, &error) && (loaded_file->CurveCount() > 0))
+                    {
+                        // drop the old data before the file it may borrow from
+                        curve_data_linear = loaded_file->Curve(0);
+                        cubic_curve = curve_data_linear;
+                        linear_curve = curve_data_linear;
+                        quadratic_curve = curve_data_linear;
+                        curve_file = std::move(loaded_file);
+
+                        is_close_loop = curve_data_linear->isCloseLoop;
+                        control_point = -1;
+                        std::cout << "loaded " << curve_data_linear->pointList.size() << " points from " << curve_file_path << "\n";
+                    }
+                    else
+                    {
+                        std::cerr << "unable to load " << curve_file_path << ": " << (error.empty() ? "no curves" : error) << "\n";
+                    }
+                }
+
+                if (event.key.code == sf::Keyboard::Home)
+                {
+                    curve_view = window.getDefaultView();
                 }
 
                 if (event.key.code == sf::Keyboard::Escape)
@@ -280,13 +456,35 @@ int main(int argc, char*argv[])
             }
         }
 
+        if (sf::Mouse::isButtonPressed(sf::Mouse::Right))
+        {
+            const sf::Vector2i pan_mouse_position_now = sf::Mouse::getPosition(window);
+
+            if (is_panning)
+            {
+                curve_view.move(window.mapPixelToCoords(pan_mouse_position, curve_view) - window.mapPixelToCoords(pan_mouse_position_now, curve_view));
+            }
+
+            pan_mouse_position = pan_mouse_position_now;
+            is_panning = true;
+        }
+        else
+        {
+            is_panning = false;
+        }
+
+        // position of the cursor on the curves (in the coordinates of the view)
+        const sf::Vector2f curve_mouse = window.mapPixelToCoords(sf::Mouse::getPosition(window), curve_view);
+        const auto curve_mouse_x = static_cast<int32_t>(curve_mouse.x);
+        const auto curve_mouse_y = static_cast<int32_t>(curve_mouse.y);
+
         if (sf::Mouse::isButtonPressed(sf::Mouse::Left))
         {
             p_mouse_x = mouse_x;
             p_mouse_y = mouse_y;
 
-            mouse_x = sf::Mouse::getPosition(window).x;
-            mouse_y = sf::Mouse::getPosition(window).y;
+            mouse_x = curve_mouse_x;
+            mouse_y = curve_mouse_y;
 
             if (ignore_click) // ignore the 1st click to avoid getting a false dt value
             {
@@ -295,38 +493,19 @@ int main(int argc, char*argv[])
                 ignore_click = false;
                 bool found_vertex = false;
 
-                // do a simple linear search to see which point has been selected and set the control point if found
-                //for (size_t i=0; i<line_draw_shape.size(); i++)
-                //for (size_t i=0; i<curve_data_cubic->pointList.size(); i++)
-                for (size_t i=0; i<active_curve->GetPointData().size(); i++)
-                {
-                    //float mouse_object_position_x_relative = std::abs(static_cast<float>(mouse_x) - line_draw_shape[i].position.x);
-                    //float mouse_object_position_y_relative = std::abs(static_cast<float>(mouse_y) - line_draw_shape[i].position.y);
-                    //float mouse_object_position_x_relative = std::abs(static_cast<float>(mouse_x) - curve_data_cubic->pointList[i][0]);
-                    //float mouse_object_position_y_relative = std::abs(static_cast<float>(mouse_y) - curve_data_cubic->pointList[i][1]);
-                    float mouse_object_position_x_relative = std::abs(static_cast<float>(mouse_x) - active_curve->GetPointData()[i][0]);
-                    float mouse_object_position_y_relative = std::abs(static_cast<float>(mouse_y) - active_curve->GetPointData()[i][1]);
-
-                    if ((mouse_object_position_x_relative < circle_draw_shape.getRadius()) && (mouse_object_position_y_relative < circle_draw_shape.getRadius()))
-                    {
-                        l_mouse_x = mouse_x;
-                        l_mouse_y = mouse_y;
+                // find the closest point under the cursor with the curve's point grid and set the control point if found
+                int32_t selected_point = active_curve->NearestPoint({static_cast<float>(mouse_x), static_cast<float>(mouse_y)}, circle_draw_shape.getRadius());
 
-                        //last_selected_position = line_draw_shape[i].position;
-                        //last_selected_position = sf::Vector2f(curve_data_cubic->pointList[i][0], curve_data_cubic->pointList[i][1]);
-                        last_selected_position = sf::Vector2f(active_curve->GetPointData()[i][0], active_curve->GetPointData()[i][1]);
+                if (selected_point >= 0)
+                {
+                    l_mouse_x = mouse_x;
+                    l_mouse_y = mouse_y;
 
-                        //line_draw_shape[control_point].color = sf::Color::Black; // set last control point color back to white
-                        control_point = static_cast<int32_t>(i);
-                        //line_draw_shape[control_point].color = sf::Color(215, 95, 115, 255); // set selected control point color to Blue
+                    last_selected_position = sf::Vector2f(active_curve->GetPointData()[selected_point][0], active_curve->GetPointData()[selected_point][1]);
+                    control_point = selected_point;
 
-                        has_been_selected = true;
-                        found_vertex = true;
-                    }
-                    else
-                    {
-                        //line_draw_shape[i].color = sf::Color::Black;
-                    }
+                    has_been_selected = true;
+                    found_vertex = true;
                 }
 
                 if (control_key_down && alt_key_down && !found_vertex)
@@ -339,8 +518,12 @@ int main(int argc, char*argv[])
                     // add point to an intersecting point on the curve. work/curve types need to match to do an insertion.
                     if (curve_type == active_curve->WorkCurveType())
                     {
-                        std::pair<std::array<float, 2>, int32_t> position_index = active_curve->IntersectionOnCurve({static_cast<float>(mouse_x), static_cast<float>(mouse_y)});
-                        active_curve->InsertAnchor(position_index.first, position_index.second);
+                        std::pair<std::array<float, 2>, uint32_t> position_index = active_curve->IntersectionOnCurve({static_cast<float>(mouse_x), static_cast<float>(mouse_y)});
+
+                        if (position_index.second != noInsertIndex)
+                        {
+                            active_curve->InsertAnchor(position_index.first, static_cast<int32_t>(position_index.second));
+                        }
                     }
                 }
                 else if (control_key_down && !found_vertex)
@@ -406,13 +589,27 @@ int main(int argc, char*argv[])
             last_selected_position = {0.0, 0.0f};
         }
 
+        events_timer.Stop();
+
+        // tessellate the edits of this frame here (Data() interpolates lazily) so it isn't timed as part of drawing
+
+        {
+            auto interpolation_timer = profiler.Scope(PROFILE_STAGE::INTERPOLATION);
+            active_curve->Data();
+        }
+
         // draw
 
+        auto geometry_timer = profiler.Scope(PROFILE_STAGE::GEOMETRY);
+
         txt_line_mode_message_render.setString("");
 
         window.clear();
 
-        std::vector<sf::Vertex> fill_buffer;
+        draw_cubic_curve.SetView(curve_view);
+        d_linear_curve.SetView(curve_view);
+
+        fill_buffer.clear();
         if (curve_type == CURVE_TYPE::CUBIC)
         {
 #if USE_OLD_CURVES
@@ -422,13 +619,13 @@ int main(int argc, char*argv[])
                 txt_line_mode_message_render.setPosition((WINDOW_WIDTH - (txt_line_mode_message_render.getLocalBounds().width + 2)) / 2, WINDOW_HEIGHT-30);
             }
 #else
-            draw_cubic_curve.HoverAnimation(&cubic_curve, sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
+            draw_cubic_curve.HoverAnimation(&cubic_curve, curve_mouse_x, curve_mouse_y);
             draw_cubic_curve.SelectedPoint(control_point);
             draw_cubic_curve.RenderCurve(&cubic_curve, window, primitive_type);
 
             if (control_key_down && shift_key_down)
             {
-                draw_cubic_curve.DrawIntersectionPoint(&cubic_curve, sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y, window);
+                draw_cubic_curve.DrawIntersectionPoint(&cubic_curve, curve_mouse_x, curve_mouse_y, window);
             }
 
             draw_cubic_curve.DrawPoints(&cubic_curve, !hide_points, window);
@@ -444,13 +641,13 @@ int main(int argc, char*argv[])
             }
 #else
 
-            d_linear_curve.HoverAnimation(&quadratic_curve, sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
+            d_linear_curve.HoverAnimation(&quadratic_curve, curve_mouse_x, curve_mouse_y);
             d_linear_curve.SelectedPoint(control_point);
             d_linear_curve.RenderCurve(&quadratic_curve, window, primitive_type);
 
             if (control_key_down && shift_key_down)
             {
-                d_linear_curve.DrawIntersectionPoint(&quadratic_curve, sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y, window);
+                d_linear_curve.DrawIntersectionPoint(&quadratic_curve, curve_mouse_x, curve_mouse_y, window);
             }
 
             d_linear_curve.DrawPoints(&quadratic_curve, !hide_points, window);
@@ -466,89 +663,38 @@ int main(int argc, char*argv[])
                 txt_line_mode_message_render.setPosition((WINDOW_WIDTH - (txt_line_mode_message_render.getLocalBounds().width + 2)) / 2, WINDOW_HEIGHT-30);
             }
 #else
-            d_linear_curve.HoverAnimation(&linear_curve, sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
+            d_linear_curve.HoverAnimation(&linear_curve, curve_mouse_x, curve_mouse_y);
             d_linear_curve.SelectedPoint(control_point);
             d_linear_curve.RenderCurve(&linear_curve, window, primitive_type);
 
             if (control_key_down && shift_key_down)
             {
-                d_linear_curve.DrawIntersectionPoint(&linear_curve, sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y, window);
+                d_linear_curve.DrawIntersectionPoint(&linear_curve, curve_mouse_x, curve_mouse_y, window);
             }
 
             d_linear_curve.DrawPoints(&linear_curve, !hide_points, window);
 #endif
         }
 
-        if (show_text)
+        geometry_timer.Stop();
+        auto overlay_timer = profiler.Scope(PROFILE_STAGE::OVERLAY);
+
+        if (curve_data_linear->tessellationMode == TESSELLATION_MODE::ADAPTIVE)
         {
-            window.draw(txt_control_line_render);
-            window.draw(txt_line_mode_message_render);
+            TessellationStats tessellation_stats = active_curve->GetTessellationStats();
+            txt_line_mode_message_render.setString("Adaptive: " + std::to_string(tessellation_stats.vertexCount) + " vertices (" + std::to_string(tessellation_stats.VerticesSaved()) + " saved)");
+            txt_line_mode_message_render.setPosition((WINDOW_WIDTH - (txt_line_mode_message_render.getLocalBounds().width + 2)) / 2, WINDOW_HEIGHT-30);
         }
-
-        if (!hide_points)
+        else if (curve_data_linear->tessellationMode == TESSELLATION_MODE::ARC_LENGTH)
         {
-            int32_t mouse_hover_x = sf::Mouse::getPosition(window).x;
-            int32_t mouse_hover_y = sf::Mouse::getPosition(window).y;
-            int32_t k=0;
-            //for (const auto & v : line_draw_shape)
-            /*
-            for (const auto & v : curve_data_cubic->pointList)
-            {
-                //float mouse_object_position_x_relative = std::abs(static_cast<float>(mouse_hover_x) - v.position.x);
-                //float mouse_object_position_y_relative = std::abs(static_cast<float>(mouse_hover_y) - v.position.y);
-                float mouse_object_position_x_relative = std::abs(static_cast<float>(mouse_hover_x) - v[0]);
-                float mouse_object_position_y_relative = std::abs(static_cast<float>(mouse_hover_y) - v[1]);
-                bool hover_color = false;
-/*
-                if ((mouse_object_position_x_relative <= point_radius_size) &&
-                    (mouse_object_position_y_relative <= point_radius_size))
-                {
-                    hover_anim[k] += hover_anim[k] + 0.1f;
-                    hover_color = true;
-                }
-                else
-                {
-                    hover_anim[k] -= ((5.0f - hover_anim[k]) + 0.1f);
-                }
-
-                hover_anim[k] = std::clamp(hover_anim[k], 0.0f, 5.0f);
-
-                circle_draw_shape.setOutlineThickness(2.0f);
-                circle_draw_shape.setOutlineColor(sf::Color::White);
-
-                //circle_draw_shape.setRadius(point_radius_size + hover_anim[k]);
-
-                //circle_draw_shape.setPosition(v.position - sf::Vector2(circle_draw_shape.getRadius(), circle_draw_shape.getRadius()));
-                circle_draw_shape.setPosition(sf::Vector2f(v[0], v[1])- sf::Vector2(circle_draw_shape.getRadius(), circle_draw_shape.getRadius()));
-
-                //auto p_color = v.color;
-                auto p_color = sf::Color::Black;
-                if (hover_color)
-                {
-                    if(control_point == k)
-                    {
-                        circle_draw_shape.setFillColor(sf::Color(30, 156, 239, 255));
-                        //circle_draw_shape.setOutlineColor(v.color);
-                        circle_draw_shape.setOutlineColor(sf::Color::White);
-                    }
-                    else
-                    {
-                        circle_draw_shape.setFillColor(sf::Color(30, 156, 239, 255));
-                    }
-                }
-                else
-                {
-                    //circle_draw_shape.setFillColor(v.color);
-                    circle_draw_shape.setFillColor(sf::Color::White);
-                }
-
-                window.draw(circle_draw_shape);
-                circle_draw_shape.setFillColor(p_color);
-                circle_draw_shape.setOutlineColor(sf::Color::White);
+            txt_line_mode_message_render.setString("Arc length: " + std::to_string(static_cast<int32_t>(active_curve->Length())) + " px");
+            txt_line_mode_message_render.setPosition((WINDOW_WIDTH - (txt_line_mode_message_render.getLocalBounds().width + 2)) / 2, WINDOW_HEIGHT-30);
+        }
 
-                k++;
-            }
-            */
+        if (show_text)
+        {
+            window.draw(txt_control_line_render);
+            window.draw(txt_line_mode_message_render);
         }
 
         if (show_fill)
@@ -567,10 +713,30 @@ int main(int argc, char*argv[])
              */
         }
 
+        if (profiler.IsEnabled())
+        {
+            profiler_overlay.Draw(profiler, window, static_cast<float>(WINDOW_WIDTH) - 250.0f, 30.0f);
+        }
+
+        overlay_timer.Stop();
+
         n_frames++;
-        window.display();
+
+        {
+            auto display_timer = profiler.Scope(PROFILE_STAGE::DISPLAY);
+            window.display();
+        }
+
+        profiler.EndFrame();
     }
 
+#if CURVE_TRACE_ENABLED
+    if (curve_trace::IsRecording())
+    {
+        stop_trace(); // keep the events recorded up to closing the window
+    }
+#endif
+
     return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <iostream>
+
+// pass/fail state of a headless test. every failed check prints its message after the name of the test, main returns
+// ExitCode() (1 if anything failed)
+class TestCheck
+{
+    private:
+        const char * testName;
+        bool isFailed = false;
+
+    public:
+        explicit TestCheck(const char * test_name) : testName (test_name) {}
+
+        bool operator()(bool condition, const std::string & message) // fail with message if condition is false, returns condition
+        {
+            if (!condition)
+            {
+                Fail() << message << "\n";
+            }
+
+            return condition;
+        }
+
+        std::ostream & Fail() // fail, the message written to the returned stream follows the name of the test
+        {
+            isFailed = true;
+            return std::cerr << testName << ": ";
+        }
+
+        bool IsFailed() const { return isFailed; }
+        int ExitCode() const { return isFailed ? 1 : 0; }
+};
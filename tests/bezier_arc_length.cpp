@@ -0,0 +1,93 @@
+#include <array>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#include "Curve.h"
+#include "BezierCurve.h"
+#include "TestCheck.h"
+
+// the arc length of a BezierCurve has to be the length of its segments at their own degree, not of their reduced
+// cubics (which can be far off above degree 3). the reference is a fine polyline of the segments evaluated in double
+
+namespace
+{
+    TestCheck check ("bezier_arc_length");
+
+    constexpr size_t polylineSteps = 1 << 16;
+    constexpr double maxRelativeError = 1e-3;
+
+    std::array<double, 2> evaluate(std::span<const std::array<float, 2>> points, double t)
+    {
+        std::array<std::array<double, 2>, bezier::maxDegree + 1> level = {};
+        for (size_t i=0; i<points.size(); i++)
+        {
+            level[i] = {points[i][0], points[i][1]};
+        }
+
+        for (size_t n=points.size()-1; n>0; n--)
+        {
+            for (size_t i=0; i<n; i++)
+            {
+                level[i] = {level[i][0] + (t * (level[i + 1][0] - level[i][0])), level[i][1] + (t * (level[i + 1][1] - level[i][1]))};
+            }
+        }
+
+        return level[0];
+    }
+
+    void checkDegree(uint8_t degree)
+    {
+        // two segments zigzagging across their chord, far from any cubic
+        std::vector<std::array<float, 2>> points;
+        for (size_t i=0; i<=(2 * static_cast<size_t>(degree)); i++)
+        {
+            points.push_back({static_cast<float>(i) * 30.0f, ((i % 2) == 0) ? 0.0f : 200.0f});
+        }
+        const std::vector<uint8_t> degrees = {degree, degree};
+
+        auto curve_data = BezierCurve::NewCurveData();
+        BezierCurve curve (curve_data.get());
+        curve.BuildFromSegments(points, degrees);
+
+        double reference = 0.0;
+        for (size_t segment=0; segment<degrees.size(); segment++)
+        {
+            const std::span<const std::array<float, 2>> segment_points(points.data() + (segment * degree), degree + 1);
+            std::array<double, 2> previous = evaluate(segment_points, 0.0);
+
+            for (size_t i=1; i<=polylineSteps; i++)
+            {
+                const std::array<double, 2> point = evaluate(segment_points, static_cast<double>(i) / static_cast<double>(polylineSteps));
+                reference += std::hypot(point[0] - previous[0], point[1] - previous[1]);
+                previous = point;
+            }
+        }
+
+        const double length = curve.Length();
+        const double error = std::abs(length - reference) / reference;
+
+        // a point halfway along the curve from both distance queries
+        const float distance = static_cast<float>(length * 0.5);
+        const CurveLocation location = curve.TAtDistance(distance);
+        float x = 0.0f;
+        float y = 0.0f;
+        curve.SampleAtDistances(std::span<const float>(&distance, 1), {&x, &y});
+        const double sample_offset = std::hypot(location.position[0] - x, location.position[1] - y);
+
+        if ((error > maxRelativeError) || (sample_offset > 1e-2))
+        {
+            check.Fail() << "degree " << static_cast<int>(degree) << " length " << length << " (polyline " << reference << "), TAtDistance and SampleAtDistances " << sample_offset << " apart\n";
+        }
+    }
+}
+
+int main()
+{
+    for (uint8_t degree=1; degree<=bezier::maxDegree; degree++)
+    {
+        checkDegree(degree);
+    }
+
+    return check.ExitCode();
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Curve.h"
+#include "CurveBvh.h"
+#include "CurveKernel.h"
+#include "CurveStorage.h"
+#include "CubicCurve.h"
+#include "QuadraticCurve.h"
+#include "LinearCurve.h"
+#include "TestCheck.h"
+
+// the nearest segment found through the segment tree has to be the one a scan of every segment finds: on random boxes
+// with CurveBvh directly (built, refit after moving some of them and after their number changed), and on random curves
+// with NearestPointOnCurve after edits that keep and that change the number of segments
+
+namespace
+{
+    TestCheck check ("curve_bvh");
+
+    using Point = std::array<float, 2>;
+
+    constexpr float maxCoordinate = 2000.0f;
+    constexpr size_t queryCount = 200;
+    constexpr float maxDistanceError = 1e-2f; // the closest point kernels converge to about this (in curve units)
+
+    // a segment of the tree test: a point somewhere inside of its bounds
+    struct BoxSegment
+    {
+        CurveBounds bounds;
+        Point point;
+    };
+
+    BoxSegment randomSegment(std::mt19937 & random)
+    {
+        std::uniform_real_distribution<float> coordinate (0.0f, maxCoordinate);
+        std::uniform_real_distribution<float> size (0.0f, 80.0f);
+        std::uniform_real_distribution<float> share (0.0f, 1.0f);
+
+        BoxSegment segment;
+        segment.bounds.min = {coordinate(random), coordinate(random)};
+        segment.bounds.max = {segment.bounds.min[0] + size(random), segment.bounds.min[1] + size(random)};
+        segment.point = {segment.bounds.min[0] + (share(random) * (segment.bounds.max[0] - segment.bounds.min[0])), segment.bounds.min[1] + (share(random) * (segment.bounds.max[1] - segment.bounds.min[1]))};
+        return segment;
+    }
+
+    float distanceSqr(const Point & a, const Point & b)
+    {
+        return ((a[0] - b[0]) * (a[0] - b[0])) + ((a[1] - b[1]) * (a[1] - b[1]));
+    }
+
+    void checkTreeQueries(const CurveBvh & tree, const std::vector<BoxSegment> & segments, std::mt19937 & random, const char * state)
+    {
+        std::uniform_real_distribution<float> coordinate (-200.0f, maxCoordinate + 200.0f);
+
+        for (size_t i=0; i<queryCount; i++)
+        {
+            const Point query = {coordinate(random), coordinate(random)};
+
+            float tree_distance = std::numeric_limits<float>::max();
+            tree.Nearest(query, [&](size_t segment)
+            {
+                const float distance = distanceSqr(segments[segment].point, query);
+                tree_distance = std::min(tree_distance, distance);
+                return distance;
+            });
+
+            float scan_distance = std::numeric_limits<float>::max();
+            for (const BoxSegment & segment : segments)
+            {
+                scan_distance = std::min(scan_distance, distanceSqr(segment.point, query));
+            }
+
+            if (tree_distance != scan_distance)
+            {
+                check.Fail() << state << ": the tree found a segment at " << std::sqrt(tree_distance) << ", the scan at " << std::sqrt(scan_distance) << "\n";
+                return;
+            }
+        }
+    }
+
+    void checkTree(std::mt19937 & random)
+    {
+        std::vector<BoxSegment> segments;
+        for (size_t i=0; i<300; i++)
+        {
+            segments.push_back(randomSegment(random));
+        }
+
+        auto segment_bounds = [&]()
+        {
+            std::vector<CurveBounds> bounds;
+            for (const BoxSegment & segment : segments)
+            {
+                bounds.push_back(segment.bounds);
+            }
+
+            return bounds;
+        };
+
+        CurveBvh tree;
+        tree.Build(segment_bounds());
+        checkTreeQueries(tree, segments, random, "built tree");
+
+        // move a range of segments and refit only the nodes above them
+        for (size_t i=100; i<140; i++)
+        {
+            segments[i] = randomSegment(random);
+        }
+
+        tree.Refit(segment_bounds(), 100, 40);
+        checkTreeQueries(tree, segments, random, "refit tree");
+
+        // a refit after the number of segments changed clears the tree, it has to be built again before a query
+        segments.push_back(randomSegment(random));
+        const std::vector<CurveBounds> grown_bounds = segment_bounds();
+        tree.Refit(grown_bounds, (segments.size() - 1), 1);
+
+        check(!tree.IsBuilt(grown_bounds) && (tree.LeafCount() == 0), "a refit with another number of segments didn't clear the tree");
+
+        bool is_visited = false;
+        tree.Nearest({0.0f, 0.0f}, [&](size_t) { is_visited = true; return 0.0f; });
+        check(!is_visited, "a cleared tree still visits segments");
+
+        tree.Build(grown_bounds);
+        checkTreeQueries(tree, segments, random, "rebuilt tree");
+    }
+
+    // distance from query to the closest point of every generated segment (as the cubics of SegmentControlBlocks)
+    float scanCurve(ICurve & curve, const Point & query)
+    {
+        const SegmentBlocks & blocks = curve.SegmentControlBlocks();
+        float distance = std::numeric_limits<float>::max();
+
+        for (size_t i=0; i<blocks.size(); i++)
+        {
+            const SegmentControls p = blocks[i];
+            const float t = curve_kernel::ClosestCubic(p[0], p[1], p[2], p[3], query);
+            const float s = 1.0f - t;
+            const Point point = {(s * s * s * p[0][0]) + (3.0f * s * s * t * p[1][0]) + (3.0f * s * t * t * p[2][0]) + (t * t * t * p[3][0]), (s * s * s * p[0][1]) + (3.0f * s * s * t * p[1][1]) + (3.0f * s * t * t * p[2][1]) + (t * t * t * p[3][1])};
+
+            distance = std::min(distance, std::sqrt(distanceSqr(point, query)));
+        }
+
+        return distance;
+    }
+
+    void checkCurveQueries(ICurve & curve, std::mt19937 & random, const std::string & state)
+    {
+        std::uniform_real_distribution<float> coordinate (-200.0f, maxCoordinate + 200.0f);
+
+        for (size_t i=0; i<queryCount; i++)
+        {
+            const Point query = {coordinate(random), coordinate(random)};
+            const CurveIntersection nearest = curve.NearestPointOnCurve(query);
+            const float scan_distance = scanCurve(curve, query);
+
+            if (!nearest.found || (std::abs(nearest.distance - scan_distance) > maxDistanceError))
+            {
+                check.Fail() << state << ": NearestPointOnCurve found a point at " << nearest.distance << ", the scan at " << scan_distance << "\n";
+                return;
+            }
+        }
+    }
+
+    template<typename CurveClass>
+    void checkCurve(const char * curve_name, std::mt19937 & random)
+    {
+        std::uniform_real_distribution<float> coordinate (0.0f, maxCoordinate);
+
+        std::vector<Point> anchors (60);
+        for (Point & anchor : anchors)
+        {
+            anchor = {coordinate(random), coordinate(random)};
+        }
+
+        auto curve_data = CurveClass::NewCurveData();
+        CurveClass curve (curve_data.get());
+        curve.BuildFromAnchors(anchors);
+        checkCurveQueries(curve, random, std::string(curve_name) + " built");
+
+        // same number of segments, the tree is refit
+        const auto index = static_cast<int32_t>(curve.GetPointData().size() / 2);
+        curve.UpdatePoint(index, {coordinate(random), coordinate(random)}, CURVE_CONTROL::FREE);
+        checkCurveQueries(curve, random, std::string(curve_name) + " after moving a point");
+
+        // one more segment, the tree is cleared and built again
+        curve.AddAnchor({coordinate(random), coordinate(random)}, PLACE_ANCHOR::END);
+        checkCurveQueries(curve, random, std::string(curve_name) + " after adding an anchor");
+
+        curve.CloseLoop(true);
+        checkCurveQueries(curve, random, std::string(curve_name) + " after closing the loop");
+    }
+}
+
+int main()
+{
+    std::mt19937 random (2024);
+
+    checkTree(random);
+    checkCurve<LinearCurve>("linear", random);
+    checkCurve<QuadraticCurve>("quadratic", random);
+    checkCurve<CubicCurve>("cubic", random);
+
+    return check.ExitCode();
+}
@@ -0,0 +1,89 @@
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "Curve.h"
+#include "CubicCurve.h"
+#include "CurveFile.h"
+#include "TestCheck.h"
+
+// writes a curve, opens it and saves the opened curve (which borrows its points from the mapping of the file) back to
+// the same file, like saving again after loading in the editor. the borrowed points have to stay readable and the new
+// file has to hold the same curve
+
+namespace
+{
+    TestCheck check ("curve_file");
+
+    bool isSamePoints(const PointList & a, const PointList & b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (size_t i=0; i<a.size(); i++)
+        {
+            if (a[i] != b[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main()
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "curve_file_test.bcurves";
+
+    auto curve_data = CubicCurve::NewCurveData();
+    curve_data->id = 7;
+    curve_data->isCloseLoop = true;
+    curve_data->smoothFactor = 12.0f;
+    CubicCurve curve (curve_data.get());
+    const std::vector<std::array<float, 2>> anchors = {{0.0f, 0.0f}, {100.0f, 50.0f}, {200.0f, 0.0f}};
+    curve.BuildFromAnchors(anchors);
+
+    const CurveData * written[] = {curve_data.get()};
+    check(CurveFile::Write(path.string(), written), "the first write failed");
+
+    CurveFile file;
+    std::string error;
+    check(file.Open(path.string(), &error), error.c_str());
+    if (check.IsFailed())
+    {
+        return 1;
+    }
+
+    std::unique_ptr<CurveData> loaded = file.Curve(0);
+    check(isSamePoints(loaded->pointList, curve_data->pointList), "the opened curve has other points");
+    check((loaded->id == 7) && loaded->isCloseLoop && (loaded->smoothFactor == 12.0f) && (loaded->curveType == CURVE_TYPE::CUBIC), "the opened curve has other settings");
+
+    // save the borrowed curve over the file it was opened from, then read the borrowed points again (windows can't
+    // replace a mapped file, there the points are copied and the file is closed first)
+#ifdef _WIN32
+    loaded->pointList.MakeOwned();
+    file.Close();
+#endif
+    const CurveData * resaved[] = {loaded.get()};
+    check(CurveFile::Write(path.string(), resaved, &error), ("writing over the opened file failed: " + error).c_str());
+    check(isSamePoints(loaded->pointList, curve_data->pointList), "the borrowed points changed when their file was written");
+
+    CurveFile reopened;
+    check(reopened.Open(path.string(), &error), error.c_str());
+    if (reopened.IsOpen())
+    {
+        check((reopened.CurveCount() == 1) && isSamePoints(reopened.Curve(0)->pointList, curve_data->pointList), "the saved file has another curve");
+    }
+
+    check(!std::filesystem::exists(path.string() + ".tmp"), "the temporary file was left behind");
+
+    file.Close();
+    reopened.Close();
+    std::filesystem::remove(path);
+
+    return check.ExitCode();
+}
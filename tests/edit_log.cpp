@@ -0,0 +1,70 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Curve.h"
+#include "CubicCurve.h"
+#include "QuadraticCurve.h"
+#include "LinearCurve.h"
+#include "BezierCurve.h"
+#include "TestCheck.h"
+
+// a copy of Data() made right after a full interpolation has to be patchable with the edits that follow it, and a copy
+// older than the interpolation must not be. a curve given another curve data block gets a new data epoch, even when the
+// generation of the block is the same as the one it replaces
+
+namespace
+{
+    TestCheck check ("edit_log");
+
+    template<typename CurveClass>
+    void checkCurve(const char * curve_name)
+    {
+        std::vector<std::array<float, 2>> anchors;
+        for (size_t i=0; i<8; i++)
+        {
+            anchors.push_back({static_cast<float>(i) * 40.0f, ((i % 2) == 0) ? 0.0f : 60.0f});
+        }
+
+        auto curve_data = CurveClass::NewCurveData();
+        CurveClass curve (curve_data.get());
+        const uint64_t generation_before = curve.Generation();
+
+        curve.BuildFromAnchors(anchors);
+        curve.Data();
+        const uint64_t generation = curve.Generation();
+
+        const auto index = static_cast<int32_t>(curve.GetPointData().size() / 2);
+        curve.UpdatePoint(index, {curve.GetPointData()[index][0] + 5.0f, curve.GetPointData()[index][1]}, CURVE_CONTROL::FREE);
+        curve.Data();
+
+        std::vector<SampleEdit> edits;
+        const bool is_known = curve.EditsSince(generation, edits);
+        const bool is_old_known = curve.EditsSince(generation_before, edits);
+        curve.EditsSince(generation, edits);
+
+        if (!is_known || edits.empty() || is_old_known)
+        {
+            check.Fail() << curve_name << " edits since the build " << (is_known ? "known" : "unknown") << " (" << edits.size() << "), edits before it " << (is_old_known ? "known" : "unknown") << "\n";
+            return;
+        }
+
+        // a block loaded in place of the current one (same generation) is only told apart by the data epoch
+        const uint64_t data_epoch = curve.DataEpoch();
+        auto loaded_data = CurveClass::NewCurveData();
+        loaded_data->generation = curve_data->generation;
+        curve = loaded_data;
+
+        check(curve.DataEpoch() != data_epoch, std::string(curve_name) + " data epoch unchanged after replacing the curve data");
+    }
+}
+
+int main()
+{
+    checkCurve<LinearCurve>("linear");
+    checkCurve<QuadraticCurve>("quadratic");
+    checkCurve<CubicCurve>("cubic");
+    checkCurve<BezierCurve>("bezier");
+
+    return check.ExitCode();
+}
@@ -0,0 +1,75 @@
+#include <array>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Curve.h"
+#include "CurveKernel.h"
+#include "TestCheck.h"
+
+// the forward differenced samples of random segments have to stay as close to the evaluated ones as the float adds
+// between two re-seeds allow (one rounding of the largest coordinate per add), however many steps the segment has
+
+namespace
+{
+    TestCheck check ("forward_difference");
+
+    constexpr float maxCoordinate = 2000.0f;
+    constexpr double maxError = static_cast<double>(curve_kernel::forwardDifferenceReseed) * maxCoordinate * FLT_EPSILON;
+    constexpr size_t segmentCount = 50;
+
+    double maxDistance(const std::vector<std::array<float, 2>> & a, const std::vector<std::array<float, 2>> & b)
+    {
+        double distance = 0.0;
+        for (size_t i=0; i<a.size(); i++)
+        {
+            distance = std::max(distance, std::hypot(static_cast<double>(a[i][0]) - b[i][0], static_cast<double>(a[i][1]) - b[i][1]));
+        }
+
+        return distance;
+    }
+
+    void checkSteps(uint32_t n_steps, std::mt19937 & random)
+    {
+        std::uniform_real_distribution<float> coordinate (0.0f, maxCoordinate);
+        std::vector<std::array<float, 2>> evaluated (static_cast<size_t>(n_steps) + 1);
+        std::vector<std::array<float, 2>> differenced (static_cast<size_t>(n_steps) + 1);
+        double quadratic_error = 0.0;
+        double cubic_error = 0.0;
+
+        for (size_t i=0; i<segmentCount; i++)
+        {
+            const std::array<float, 2> a = {coordinate(random), coordinate(random)};
+            const std::array<float, 2> b = {coordinate(random), coordinate(random)};
+            const std::array<float, 2> c = {coordinate(random), coordinate(random)};
+            const std::array<float, 2> d = {coordinate(random), coordinate(random)};
+
+            curve_kernel::EvaluateQuadratic(a, b, c, n_steps, evaluated.data());
+            curve_kernel::ForwardDifferenceQuadratic(a, b, c, n_steps, differenced.data());
+            quadratic_error = std::max(quadratic_error, maxDistance(evaluated, differenced));
+
+            curve_kernel::EvaluateCubic(a, b, c, d, n_steps, evaluated.data());
+            curve_kernel::ForwardDifferenceCubic(a, b, c, d, n_steps, differenced.data());
+            cubic_error = std::max(cubic_error, maxDistance(evaluated, differenced));
+        }
+
+        if ((quadratic_error > maxError) || (cubic_error > maxError))
+        {
+            check.Fail() << n_steps << " steps drift " << quadratic_error << " (quadratic) and " << cubic_error << " (cubic) from the evaluated samples, at most " << maxError << "\n";
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937 random (42);
+
+    for (uint32_t n_steps : {uint32_t(curve_kernel::forwardDifferenceReseed + 1), uint32_t(4096), curve_kernel::maxStepCount})
+    {
+        checkSteps(n_steps, random);
+    }
+
+    return check.ExitCode();
+}
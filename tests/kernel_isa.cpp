@@ -0,0 +1,169 @@
+#include <array>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Curve.h"
+#include "CurveKernel.h"
+#include "TestCheck.h"
+
+// forces every instruction set the cpu has and compares the evaluate kernels and SampleBatch bit for bit with the
+// scalar path, on random segments and with sample counts that leave every possible tail after the full simd lanes
+
+namespace
+{
+    TestCheck check ("kernel_isa");
+
+    using Point = std::array<float, 2>;
+
+    const char * isaName(KERNEL_ISA isa)
+    {
+        switch (isa)
+        {
+            case KERNEL_ISA::SCALAR: return "scalar";
+            case KERNEL_ISA::SSE2: return "sse2";
+            case KERNEL_ISA::AVX2: return "avx2";
+            case KERNEL_ISA::AVX512: return "avx512";
+        }
+
+        return "unknown";
+    }
+
+    // every step count up to a few lanes of avx-512 past the first block, then a few long segments
+    std::vector<uint32_t> stepCounts()
+    {
+        std::vector<uint32_t> n_steps;
+        for (uint32_t i=1; i<=70; i++)
+        {
+            n_steps.push_back(i);
+        }
+
+        n_steps.insert(n_steps.end(), {127, 128, 255, 1000, 4097});
+        return n_steps;
+    }
+
+    bool isSameBits(const std::vector<float> & a, const std::vector<float> & b)
+    {
+        return (a.size() == b.size()) && (std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0);
+    }
+
+    // x and y of the samples of every evaluate function with the active instruction set, one after the other
+    std::vector<float> evaluateAll(const std::array<Point, 4> & points, uint32_t n_steps)
+    {
+        const size_t n_samples = static_cast<size_t>(n_steps) + 1;
+        std::vector<float> x (n_samples);
+        std::vector<float> y (n_samples);
+        std::vector<Point> interleaved (n_samples);
+        std::vector<float> result;
+
+        auto append = [&]()
+        {
+            result.insert(result.end(), x.begin(), x.end());
+            result.insert(result.end(), y.begin(), y.end());
+
+            for (const Point & point : interleaved)
+            {
+                result.insert(result.end(), point.begin(), point.end());
+            }
+        };
+
+        curve_kernel::EvaluateLinearSoa(points[0], points[3], n_steps, x.data(), y.data());
+        curve_kernel::EvaluateLinear(points[0], points[3], n_steps, interleaved.data());
+        append();
+
+        curve_kernel::EvaluateQuadraticSoa(points[0], points[1], points[3], n_steps, x.data(), y.data());
+        curve_kernel::EvaluateQuadratic(points[0], points[1], points[3], n_steps, interleaved.data());
+        append();
+
+        curve_kernel::EvaluateCubicSoa(points[0], points[1], points[2], points[3], n_steps, x.data(), y.data());
+        curve_kernel::EvaluateCubic(points[0], points[1], points[2], points[3], n_steps, interleaved.data());
+        append();
+
+        return result;
+    }
+
+    // positions and tangents of n_queries random queries on batch with the active instruction set
+    std::vector<float> sampleAll(const curve_kernel::BezierBatch & batch, const std::vector<uint32_t> & segments, const std::vector<float> & t, size_t n_queries)
+    {
+        std::vector<float> result (n_queries * 4);
+        const PathSamples out = {result.data(), result.data() + n_queries, result.data() + (2 * n_queries), result.data() + (3 * n_queries)};
+
+        curve_kernel::SampleBatch(batch, segments.data(), t.data(), n_queries, out, 0);
+        return result;
+    }
+
+    void checkIsa(KERNEL_ISA isa, std::mt19937 & random)
+    {
+        std::uniform_real_distribution<float> coordinate (-1000.0f, 1000.0f);
+        std::uniform_real_distribution<float> parameter (0.0f, 1.0f);
+
+        for (uint32_t n_steps : stepCounts())
+        {
+            const std::array<Point, 4> points = {{{coordinate(random), coordinate(random)}, {coordinate(random), coordinate(random)}, {coordinate(random), coordinate(random)}, {coordinate(random), coordinate(random)}}};
+
+            curve_kernel::ForceIsa(KERNEL_ISA::SCALAR);
+            const std::vector<float> scalar = evaluateAll(points, n_steps);
+            curve_kernel::ForceIsa(isa);
+            const std::vector<float> simd = evaluateAll(points, n_steps);
+
+            check(isSameBits(scalar, simd), std::string(isaName(isa)) + " evaluate kernels differ from scalar with " + std::to_string(n_steps) + " steps");
+        }
+
+        for (size_t degree : {size_t(1), size_t(2), size_t(3), size_t(5), bezier::maxDegree})
+        {
+            curve_kernel::BezierBatch batch;
+            batch.degree = degree;
+            batch.count = 37;
+            batch.x.resize((degree + 1) * batch.count);
+            batch.y.resize((degree + 1) * batch.count);
+
+            for (size_t i=0; i<batch.x.size(); i++)
+            {
+                batch.x[i] = coordinate(random);
+                batch.y[i] = coordinate(random);
+            }
+
+            // every tail length after the 8 query lanes, with the end points of the segments among the queries
+            for (size_t n_queries=1; n_queries<=40; n_queries++)
+            {
+                std::vector<uint32_t> segments (n_queries);
+                std::vector<float> t (n_queries);
+
+                for (size_t i=0; i<n_queries; i++)
+                {
+                    segments[i] = static_cast<uint32_t>(random() % batch.count);
+                    t[i] = ((i % 7) == 0) ? static_cast<float>(i % 2) : parameter(random);
+                }
+
+                curve_kernel::ForceIsa(KERNEL_ISA::SCALAR);
+                const std::vector<float> scalar = sampleAll(batch, segments, t, n_queries);
+                curve_kernel::ForceIsa(isa);
+                const std::vector<float> simd = sampleAll(batch, segments, t, n_queries);
+
+                check(isSameBits(scalar, simd), std::string(isaName(isa)) + " SampleBatch differs from scalar at degree " + std::to_string(degree) + " with " + std::to_string(n_queries) + " queries");
+            }
+        }
+    }
+}
+
+int main()
+{
+    const KERNEL_ISA detected_isa = curve_kernel::ActiveIsa();
+    std::mt19937 random (1234);
+
+    for (KERNEL_ISA isa : {KERNEL_ISA::SSE2, KERNEL_ISA::AVX2, KERNEL_ISA::AVX512})
+    {
+        // ForceIsa clamps to what the cpu supports, an instruction set it doesn't have would only test another one again
+        curve_kernel::ForceIsa(isa);
+        if (curve_kernel::ActiveIsa() != isa)
+        {
+            continue;
+        }
+
+        checkIsa(isa, random);
+    }
+
+    curve_kernel::ForceIsa(detected_isa);
+    return check.ExitCode();
+}
@@ -0,0 +1,99 @@
+#include <cmath>
+#include <vector>
+
+#include "PointBatch.h"
+#include "TestCheck.h"
+
+// builds point circles without a window and checks their geometry, that restyling one point leaves the others alone
+// and how the batch resizes
+
+namespace
+{
+    TestCheck check ("point_batch_geometry");
+
+    bool isSameVertex(const sf::Vertex & a, const sf::Vertex & b)
+    {
+        return (a.position.x == b.position.x) && (a.position.y == b.position.y) && (a.color == b.color);
+    }
+
+    float distance(const sf::Vector2f & point, const std::array<float, 2> & center)
+    {
+        return std::hypot(point.x - center[0], point.y - center[1]);
+    }
+
+    PointBatch::PointStyle makeStyle(size_t index)
+    {
+        return {{static_cast<float>(index) * 30.0f, 10.0f}, 5.0f, sf::Color(200, 200, 200), sf::Color(20, 20, 20)};
+    }
+}
+
+int main()
+{
+    constexpr size_t segments = 12;
+    constexpr float outline_thickness = 2.0f;
+    PointBatch batch (segments, outline_thickness);
+
+    check(batch.VerticesPerPoint() == (segments * 9), "a circle isn't 3 vertices per disc triangle and 6 per ring quad");
+
+    for (size_t i=0; i<3; i++)
+    {
+        batch.SetPoint(i, makeStyle(i));
+    }
+
+    check(batch.PointCount() == 3, "SetPoint with the next index doesn't add a circle");
+    check(batch.Vertices().size() == (3 * batch.VerticesPerPoint()), "the vertices don't match the circles");
+
+    // disc triangles fan out from the center on the radius, the ring lies between the radius and the outline
+    const PointBatch::PointStyle style = makeStyle(1);
+    const sf::Vertex * circle = batch.Vertices().data() + batch.VerticesPerPoint();
+    for (size_t i=0; i<segments; i++)
+    {
+        check(distance(circle[(i * 3) + 0].position, style.position) < 1e-4f, "a disc triangle doesn't start at the center");
+        check(std::abs(distance(circle[(i * 3) + 1].position, style.position) - style.radius) < 1e-4f, "a disc triangle isn't on the radius");
+        check(circle[i * 3].color == style.fillColor, "the disc doesn't have the fill color");
+    }
+    for (size_t i=(segments * 3); i<batch.VerticesPerPoint(); i++)
+    {
+        const float ring_distance = distance(circle[i].position, style.position);
+        check((ring_distance > (style.radius - 1e-4f)) && (ring_distance < (style.radius + outline_thickness + 1e-4f)), "a ring vertex is outside of the outline");
+        check(circle[i].color == style.outlineColor, "the ring doesn't have the outline color");
+    }
+
+    // restyling the middle point only changes its own vertices
+    const std::vector<sf::Vertex> before = batch.Vertices();
+    PointBatch::PointStyle hovered = makeStyle(1);
+    hovered.radius = 8.0f;
+    hovered.fillColor = sf::Color(255, 0, 0);
+    batch.SetPoint(1, hovered);
+
+    const size_t per_point = batch.VerticesPerPoint();
+    bool is_other_unchanged = true;
+    bool is_restyled = false;
+    for (size_t i=0; i<before.size(); i++)
+    {
+        const bool is_same = isSameVertex(before[i], batch.Vertices()[i]);
+        if ((i / per_point) == 1)
+        {
+            is_restyled |= !is_same;
+        }
+        else
+        {
+            is_other_unchanged &= is_same;
+        }
+    }
+    check(is_restyled, "restyling a point didn't change its circle");
+    check(is_other_unchanged, "restyling a point changed the other circles");
+
+    // a gap in the indices is ignored, Resize only shrinks
+    batch.SetPoint(5, makeStyle(5));
+    check(batch.PointCount() == 3, "SetPoint past the next index added a circle");
+
+    batch.Resize(2);
+    check((batch.PointCount() == 2) && (batch.Vertices().size() == (2 * per_point)), "Resize didn't drop the last circle");
+    check(isSameVertex(batch.Vertices()[0], before[0]), "Resize changed the circles it kept");
+
+    batch.Resize(4);
+    check((batch.PointCount() == 2) && (batch.Vertices().size() == (2 * per_point)), "Resize grew the batch");
+
+    return check.ExitCode();
+}
@@ -0,0 +1,166 @@
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Curve.h"
+#include "CubicCurve.h"
+#include "QuadraticCurve.h"
+#include "LinearCurve.h"
+#include "CurveSvg.h"
+#include "TestCheck.h"
+
+// imports closed svg subpaths whose last segment ends at the start and checks the generated curve still has all of
+// their geometry. the parser has to read relative commands, implicitly repeated coordinates, exponents and numbers
+// glued together by their sign like the absolute and separated forms of the same path, also when the data is split
+// into chunks in the middle of a number
+
+namespace
+{
+    TestCheck check ("svg_import");
+
+    template<typename CurveClass>
+    void checkLens(const char * curve_name, CURVE_TYPE curve_type)
+    {
+        // two arcs from (0, 0) to (10, 0) and back, one above and one below the x axis
+        std::vector<std::unique_ptr<CurveData>> curves;
+        check(curve_svg::ImportPath("M0 0 C0 10 10 10 10 0 C10 -10 0 -10 0 0 Z", curve_type, curves), std::string(curve_name) + " lens didn't import");
+        if (curves.size() != 1)
+        {
+            check(false, std::string(curve_name) + " lens isn't one curve");
+            return;
+        }
+
+        CurveClass curve (curves[0].get());
+        float min_y = 0.0f;
+        float max_y = 0.0f;
+        for (const std::array<float, 2> & sample : curve.Data())
+        {
+            min_y = std::min(min_y, sample[1]);
+            max_y = std::max(max_y, sample[1]);
+        }
+
+        const std::array<float, 2> & last = curve.Data().back();
+        check((max_y > 5.0f) && (min_y < -5.0f), std::string(curve_name) + " lens lost one of its arcs");
+        check((std::abs(last[0]) < 1e-3f) && (std::abs(last[1]) < 1e-3f), std::string(curve_name) + " lens doesn't end at its start");
+    }
+
+    // anchors, handles and closing of every subpath of path_data fed in the given chunks
+    struct ParsedSubpath
+    {
+        std::vector<std::array<float, 2>> anchors;
+        std::vector<std::array<float, 2>> handles;
+        bool isClosed = false;
+
+        bool operator==(const ParsedSubpath & rhs) const = default;
+    };
+
+    std::vector<ParsedSubpath> parse(const std::vector<std::string_view> & chunks, CURVE_TYPE curve_type, std::string & error)
+    {
+        std::vector<ParsedSubpath> subpaths;
+        SvgPathParser parser (curve_type, [&](const SvgSubpath & subpath)
+        {
+            subpaths.push_back({{subpath.anchors.begin(), subpath.anchors.end()}, {subpath.handles.begin(), subpath.handles.end()}, subpath.isClosed});
+        });
+
+        bool is_parsed = true;
+        for (std::string_view chunk : chunks)
+        {
+            is_parsed = is_parsed && parser.Feed(chunk);
+        }
+
+        is_parsed = is_parsed && parser.Finish();
+        error = is_parsed ? "" : (std::string(parser.Error()) + " at byte " + std::to_string(parser.ErrorOffset()));
+        return subpaths;
+    }
+
+    std::vector<ParsedSubpath> parse(std::string_view path_data, CURVE_TYPE curve_type, std::string & error)
+    {
+        return parse(std::vector<std::string_view>{path_data}, curve_type, error);
+    }
+
+    // path_data has to be parsed into the same subpaths as reference_data, in one piece and split at every byte
+    void checkSamePath(std::string_view path_data, std::string_view reference_data, const std::string & name)
+    {
+        for (CURVE_TYPE curve_type : {CURVE_TYPE::CUBIC, CURVE_TYPE::QUADRATIC, CURVE_TYPE::LINEAR})
+        {
+            std::string error;
+            const std::vector<ParsedSubpath> reference = parse(reference_data, curve_type, error);
+            if (!check(error.empty() && !reference.empty(), name + " reference didn't parse: " + error))
+            {
+                return;
+            }
+
+            if (!check(parse(path_data, curve_type, error) == reference, name + " isn't read like " + std::string(reference_data) + " " + error))
+            {
+                return;
+            }
+
+            for (size_t split=1; split<path_data.size(); split++)
+            {
+                const std::vector<std::string_view> chunks = {path_data.substr(0, split), path_data.substr(split)};
+                if (!check(parse(chunks, curve_type, error) == reference, name + " split after byte " + std::to_string(split) + " isn't read like in one piece " + error))
+                {
+                    return;
+                }
+            }
+
+            // every byte a chunk of its own, a number is carried over several chunks
+            std::vector<std::string_view> bytes;
+            for (size_t i=0; i<path_data.size(); i++)
+            {
+                bytes.push_back(path_data.substr(i, 1));
+            }
+
+            check(parse(bytes, curve_type, error) == reference, name + " fed byte by byte isn't read like in one piece " + error);
+        }
+    }
+
+    void checkSyntax()
+    {
+        // relative commands are offsets from the current point at the start of the command (z goes back to the start of
+        // the subpath, a relative m after it starts from there)
+        checkSamePath("m10 10 l10 0 l0 10 c0 10 10 10 10 0 q10 -10 20 0 z m5 5 l10 0 L30 30",
+                      "M10 10 L20 10 L20 20 C20 30 30 30 30 20 Q40 10 50 20 Z M15 15 L25 15 L30 30", "relative commands");
+
+        // coordinates after the arguments of a command repeat it, after a moveto they are lines (relative after m)
+        checkSamePath("M0 0 10 0 10 10 C10 20 20 20 20 10 20 0 30 0 30 10 m5 0 10 0",
+                      "M0 0 L10 0 L10 10 C10 20 20 20 20 10 C20 0 30 0 30 10 M35 10 L45 10", "implicit repeats");
+
+        // an exponent sign doesn't start a number, any other sign or a second decimal point does
+        checkSamePath("M1e-3-2L.5.25-1E1+2.5e+1C-1-2-3-4-5-6",
+                      "M0.001 -2 L0.5 0.25 L-10 25 C-1 -2 -3 -4 -5 -6", "glued numbers");
+
+        // long numbers that are split somewhere in their digits, decimals or exponent
+        checkSamePath("M123.456e1 -0.000789 L98765.4321,-1234.5e-2 Q0.125e+2 33.75 -44.0625 5e0",
+                      "M1234.56 -0.000789 L98765.4321 -12.345 Q12.5 33.75 -44.0625 5", "chunk boundaries");
+
+        // the data is checked too, not only read
+        std::string error;
+        parse("M0 0 L10", CURVE_TYPE::LINEAR, error);
+        check(!error.empty(), "missing command arguments aren't an error");
+        parse("M0 0 L1e", CURVE_TYPE::LINEAR, error);
+        check(!error.empty(), "an exponent without digits isn't an error");
+    }
+
+    void checkSquare()
+    {
+        // an explicit line back to the start of a longer subpath is still folded into the closing segment
+        std::vector<std::unique_ptr<CurveData>> curves;
+        check(curve_svg::ImportPath("M0 0 L10 0 L10 10 L0 10 L0 0 Z", CURVE_TYPE::LINEAR, curves), "square didn't import");
+        check((curves.size() == 1) && (curves[0]->pointList.size() == 4) && curves[0]->isCloseLoop, "square isn't a closed curve of 4 anchors");
+    }
+}
+
+int main()
+{
+    checkLens<CubicCurve>("cubic", CURVE_TYPE::CUBIC);
+    checkLens<QuadraticCurve>("quadratic", CURVE_TYPE::QUADRATIC);
+    checkLens<LinearCurve>("linear", CURVE_TYPE::LINEAR);
+    checkSquare();
+    checkSyntax();
+
+    return check.ExitCode();
+}
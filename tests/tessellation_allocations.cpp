@@ -0,0 +1,139 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "Curve.h"
+#include "CubicCurve.h"
+#include "QuadraticCurve.h"
+#include "LinearCurve.h"
+#include "BezierCurve.h"
+#include "AllocationCounter.h"
+#include "TestCheck.h"
+
+// drags a point of every curve class in every tessellation mode and reads the curve back like the editor does each
+// frame. after a first drag has grown every buffer, a second drag over the same path must not allocate. exits with 1
+// if it does
+
+#if CURVE_ALLOCATION_COUNTING
+// the library already replaces operator new/delete and counts into allocation_counter
+namespace
+{
+    uint64_t allocationCount()
+    {
+        return allocation_counter::Snapshot().allocations;
+    }
+}
+#else
+namespace
+{
+    std::atomic<uint64_t> allocations {0};
+
+    uint64_t allocationCount()
+    {
+        return allocations.load(std::memory_order_relaxed);
+    }
+}
+
+void * operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    void * ptr = std::malloc((size == 0) ? 1 : size);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const auto align = static_cast<size_t>(alignment);
+    void * ptr = std::aligned_alloc(align, (((size == 0) ? 1 : size) + align - 1) & ~(align - 1));
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void * operator new[](size_t size) { return operator new(size); }
+void * operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void operator delete(void * ptr) noexcept { std::free(ptr); }
+void operator delete(void * ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void * ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void * ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void * ptr) noexcept { std::free(ptr); }
+void operator delete[](void * ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void * ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void * ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+#endif
+
+namespace
+{
+    TestCheck check ("tessellation_allocations");
+
+    constexpr size_t anchorCount = 200;
+    constexpr size_t dragSteps = 30;
+
+    template<typename CurveClass>
+    void checkCurve(const char * curve_name, TESSELLATION_MODE mode)
+    {
+        std::vector<std::array<float, 2>> anchors (anchorCount);
+        for (size_t i=0; i<anchorCount; i++)
+        {
+            anchors[i] = {static_cast<float>(i) * 20.0f, ((i % 2) == 0) ? 0.0f : 40.0f};
+        }
+
+        auto curve_data = CurveClass::NewCurveData();
+        curve_data->tessellationMode = mode;
+        CurveClass curve (curve_data.get());
+        curve.BuildFromAnchors(anchors);
+        curve.Data();
+
+        const auto index = static_cast<int32_t>(curve.GetPointData().size() / 2);
+        const std::array<float, 2> start = curve.GetPointData()[index];
+        size_t sink = 0;
+
+        auto drag = [&]()
+        {
+            for (size_t i=0; i<(dragSteps * 2); i++)
+            {
+                const auto step = static_cast<float>((i < dragSteps) ? i : ((dragSteps * 2) - 1 - i));
+                curve.UpdatePoint(index, {start[0] + step, start[1] + (step * 0.5f)}, CURVE_CONTROL::ALIGNMENT);
+                sink += curve.Data().size() + curve.HandleData().size();
+            }
+        };
+
+        drag(); // warm up
+
+        const uint64_t before = allocationCount();
+        drag();
+        const uint64_t steady = allocationCount() - before;
+
+        if ((steady != 0) || (sink == 0))
+        {
+            check.Fail() << curve_name << " mode " << static_cast<int>(mode) << ", " << steady << " steady state allocations\n";
+        }
+    }
+}
+
+int main()
+{
+    for (TESSELLATION_MODE mode : {TESSELLATION_MODE::UNIFORM, TESSELLATION_MODE::FORWARD_DIFFERENCE, TESSELLATION_MODE::ADAPTIVE, TESSELLATION_MODE::ARC_LENGTH})
+    {
+        checkCurve<LinearCurve>("linear", mode);
+        checkCurve<QuadraticCurve>("quadratic", mode);
+        checkCurve<CubicCurve>("cubic", mode);
+        checkCurve<BezierCurve>("bezier", mode);
+    }
+
+    return check.ExitCode();
+}